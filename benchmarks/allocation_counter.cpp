@@ -0,0 +1,70 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "allocation_counter.h"
+
+#include <algorithm>  // std::max
+#include <cstdlib>    // std::malloc, std::free
+#include <new>        // std::bad_alloc
+
+namespace {
+
+AllocationCounters g_counters;
+
+void* allocate(size_t size) {
+    // The size is stored in front of the block, `max_align_t` keeps the
+    // returned pointer suitably aligned.
+    auto* block = static_cast<std::max_align_t*>(std::malloc(size + sizeof(std::max_align_t)));
+    if (block == nullptr) {
+        throw std::bad_alloc();
+    }
+    *static_cast<size_t*>(static_cast<void*>(block)) = size;
+
+    ++g_counters.allocations;
+    g_counters.allocatedBytes += size;
+    g_counters.liveBytes += size;
+    g_counters.peakBytes = std::max(g_counters.peakBytes, g_counters.liveBytes);
+
+    return block + 1;
+}
+
+void deallocate(void* ptr) noexcept {
+    if (ptr == nullptr) {
+        return;
+    }
+    auto* block = static_cast<std::max_align_t*>(ptr) - 1;
+    g_counters.liveBytes -= *static_cast<size_t*>(static_cast<void*>(block));
+    std::free(block);
+}
+
+}  // namespace
+
+const AllocationCounters& allocationCounters() noexcept {
+    return g_counters;
+}
+
+void resetAllocationCounters() noexcept {
+    g_counters.allocations = 0;
+    g_counters.allocatedBytes = 0;
+    g_counters.peakBytes = g_counters.liveBytes;
+}
+
+void* operator new(size_t size) {
+    return allocate(size);
+}
+void* operator new[](size_t size) {
+    return allocate(size);
+}
+void operator delete(void* ptr) noexcept {
+    deallocate(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    deallocate(ptr);
+}
+void operator delete(void* ptr, size_t /* size */) noexcept {
+    deallocate(ptr);
+}
+void operator delete[](void* ptr, size_t /* size */) noexcept {
+    deallocate(ptr);
+}
@@ -0,0 +1,28 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstddef>
+
+/**
+ * Heap allocation counters of a benchmark.
+ *
+ * They are updated by the replacements of the global `operator new` and
+ * `operator delete` in allocation_counter.cpp, which must be linked into the
+ * benchmark (see `morphio_add_benchmark`). The counters are not thread safe:
+ * only single threaded benchmarks can use them.
+ */
+struct AllocationCounters {
+    size_t allocations = 0;     // calls to `operator new`
+    size_t allocatedBytes = 0;  // bytes requested from `operator new`
+    size_t liveBytes = 0;       // bytes allocated and not freed yet
+    size_t peakBytes = 0;       // maximum of `liveBytes`
+};
+
+/** The counters since the start of the program, or since `resetAllocationCounters` */
+const AllocationCounters& allocationCounters() noexcept;
+
+/** Restart counting allocations; the peak restarts from the bytes that are still live */
+void resetAllocationCounters() noexcept;
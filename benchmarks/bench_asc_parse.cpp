@@ -0,0 +1,151 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Start-up cost and throughput of the Neurolucida (ASC) reader.
+ *
+ * The start-up cost is the difference between the first load of a small
+ * morphology in the process, which pays for any lazy initialization of the
+ * lexer, and the following loads of the same morphology.
+ *
+ * The throughput, in MB of text per second, is measured on a synthesized
+ * morphology: a soma contour and a dendrite that is a full binary tree of
+ * `depth` levels, with `points_per_section` points per section.
+ *
+ * Usage: bench_asc_parse [depth] [points_per_section] [repetitions]
+ */
+#include <chrono>
+#include <cstddef>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <morphio/morphology.h>
+#include <morphio/warning_handling.h>
+
+namespace {
+
+constexpr double MB = 1024. * 1024.;
+
+const char* const SMALL_ASC = R"(("CellBody"
+ (CellBody)
+ (1 0 0 1)
+ (0 1 0 1)
+ (-1 0 0 1)
+)
+((Dendrite)
+ (0 0 0 2)
+ (0 5 0 2)
+ (
+  (-5 5 0 3)
+ |
+  (6 5 0 3)
+ )
+)
+)";
+
+void writeSection(std::ostream& out,
+                  size_t depth,
+                  size_t points_per_section,
+                  size_t& id,
+                  const std::string& indent) {
+    for (size_t i = 0; i < points_per_section; ++i, ++id) {
+        const double step = static_cast<double>(id) * 0.731;
+        out << indent << '(' << step << ' ' << step * 1.379 << ' ' << -step * 0.517 << ' '
+            << 0.25 + static_cast<double>(i % 7) * 0.125 << ")\n";
+    }
+    if (depth > 1) {
+        out << indent << "(\n";
+        writeSection(out, depth - 1, points_per_section, id, indent + "  ");
+        out << indent << "|\n";
+        writeSection(out, depth - 1, points_per_section, id, indent + "  ");
+        out << indent << ")\n";
+    }
+}
+
+std::string makeASC(size_t depth, size_t points_per_section) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "; synthesized by bench_asc_parse\n";
+    out << "(\"CellBody\"\n (CellBody)\n (1 0 0 1)\n (0 1 0 1)\n (-1 0 0 1)\n)\n\n";
+    out << "((Dendrite)\n";
+    size_t id = 0;
+    writeSection(out, depth, points_per_section, id, " ");
+    out << ")\n";
+    return out.str();
+}
+
+double elapsed_ms(const std::chrono::steady_clock::time_point& start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+        .count();
+}
+
+template <typename F>
+void report(const std::string& name, size_t bytes, size_t repetitions, F&& run) {
+    double checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        checksum += run();
+    }
+    const double ms = elapsed_ms(start);
+
+    std::cout << std::setw(28) << name << std::setw(14) << std::fixed << std::setprecision(2)
+              << ms / static_cast<double>(repetitions) << std::setw(12) << std::setprecision(1)
+              << static_cast<double>(bytes * repetitions) / MB / (ms / 1e3) << std::setw(16)
+              << std::setprecision(0) << checksum << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t depth = argc > 1 ? std::stoul(argv[1]) : 14;
+    const size_t points_per_section = argc > 2 ? std::stoul(argv[2]) : 20;
+    const size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 5;
+    if (depth < 1 || points_per_section < 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [depth >= 1] [points_per_section >= 1] [repetitions]\n";
+        return 1;
+    }
+
+    const auto handler = std::make_shared<morphio::WarningHandlerCollector>();
+
+    // Must come first: nothing else may have read an ASC file in this process
+    const auto first = std::chrono::steady_clock::now();
+    morphio::Morphology(SMALL_ASC, "asc", morphio::NO_MODIFIER, handler);
+    const double first_ms = elapsed_ms(first);
+
+    const size_t small_repetitions = 100;
+    const auto next = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < small_repetitions; ++i) {
+        morphio::Morphology(SMALL_ASC, "asc", morphio::NO_MODIFIER, handler);
+    }
+    const double next_ms = elapsed_ms(next) / static_cast<double>(small_repetitions);
+
+    std::cout << std::fixed << std::setprecision(3) << "first load: " << first_ms
+              << " ms, next loads: " << next_ms << " ms, start-up: " << first_ms - next_ms
+              << " ms\n\n";
+
+    const std::string contents = makeASC(depth, points_per_section);
+    const auto path = std::filesystem::temp_directory_path() / "bench_asc_parse.asc";
+    std::ofstream(path) << contents;
+
+    std::cout << std::setprecision(1) << static_cast<double>(contents.size()) / MB
+              << " MB of ASC\n";
+    std::cout << std::setw(28) << "case" << std::setw(14) << "ms" << std::setw(12) << "MB/s"
+              << std::setw(16) << "checksum" << '\n';
+
+    report("load from string", contents.size(), repetitions, [&]() {
+        return morphio::Morphology(contents, "asc", morphio::NO_MODIFIER, handler).points().size();
+    });
+    report("load from file", contents.size(), repetitions, [&]() {
+        return morphio::Morphology(path.string(), morphio::NO_MODIFIER, handler).points().size();
+    });
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -0,0 +1,109 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Throughput of loading every morphology of an HDF5 container, as a function
+ * of the number of threads sharing one `morphio::Collection`.
+ *
+ * Usage: bench_container_threads <container.h5> [max_threads] [repetitions]
+ */
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <highfive/H5File.hpp>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/warning_handling.h>
+
+namespace {
+
+std::vector<std::string> containerMorphologyNames(const std::string& path) {
+    auto file = HighFive::File(path, HighFive::File::ReadOnly);
+    return file.listObjectNames();
+}
+
+double loadAll(const morphio::Collection& collection,
+               const std::vector<std::string>& names,
+               size_t n_threads) {
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> n_points{0};
+
+    auto worker = [&]() {
+        auto warning_handler = std::make_shared<morphio::WarningHandlerCollector>();
+        size_t local_points = 0;
+        for (size_t k = next++; k < names.size(); k = next++) {
+            auto morph = collection.load<morphio::Morphology>(names[k], 0, warning_handler);
+            local_points += morph.points().size();
+        }
+        n_points += local_points;
+    };
+
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    threads.reserve(n_threads);
+    for (size_t i = 0; i < n_threads; ++i) {
+        threads.emplace_back(worker);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const auto stop = std::chrono::steady_clock::now();
+
+    if (n_points == 0 && !names.empty()) {
+        std::cerr << "warning: no points were loaded\n";
+    }
+
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <container.h5> [max_threads] [repetitions]\n";
+        return 1;
+    }
+
+    const std::string path = argv[1];
+    const size_t max_threads = argc > 2 ? std::stoul(argv[2])
+                                        : std::max(1u, std::thread::hardware_concurrency());
+    const size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 3;
+
+    const auto names = containerMorphologyNames(path);
+    const auto collection = morphio::Collection(path);
+
+    std::cout << "container: " << path << " (" << names.size() << " morphologies)\n";
+    std::cout << std::setw(8) << "threads" << std::setw(14) << "best [s]" << std::setw(16)
+              << "morph / s" << std::setw(10) << "speedup" << '\n';
+
+    double baseline = 0.0;
+    for (size_t n_threads = 1; n_threads <= max_threads; n_threads *= 2) {
+        double best = loadAll(collection, names, n_threads);
+        for (size_t r = 1; r < repetitions; ++r) {
+            best = std::min(best, loadAll(collection, names, n_threads));
+        }
+
+        if (n_threads == 1) {
+            baseline = best;
+        }
+
+        std::cout << std::setw(8) << n_threads << std::setw(14) << std::fixed
+                  << std::setprecision(4) << best << std::setw(16) << std::setprecision(1)
+                  << static_cast<double>(names.size()) / best << std::setw(10)
+                  << std::setprecision(2) << baseline / best << '\n';
+    }
+
+    return 0;
+}
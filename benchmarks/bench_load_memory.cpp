@@ -0,0 +1,190 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Memory cost of loading one large, axon-heavy morphology: heap allocations,
+ * allocated bytes, peak heap and peak RSS per load, for every file format and
+ * with or without modifiers.
+ *
+ * The morphology is synthesized: a soma and a binary tree of axon sections
+ * with `points_per_section` points each, for a total of about `n_points`
+ * points. Each case runs in its own process so that peak RSS is not polluted
+ * by the previous ones (Linux only).
+ *
+ * Usage: bench_load_memory [n_points] [points_per_section]
+ */
+#include <sys/resource.h>  // getrusage
+#include <sys/wait.h>      // waitpid
+#include <unistd.h>        // fork, sysconf
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <morphio/enums.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+
+#include "allocation_counter.h"
+
+namespace {
+
+constexpr double MB = 1024. * 1024.;
+constexpr std::array<const char*, 4> EXTENSIONS = {"h5", "swc", "asc", "mbin"};
+
+std::string cellPath(const std::filesystem::path& directory, const std::string& extension) {
+    return (directory / ("axon." + extension)).string();
+}
+
+size_t currentRSS() {
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0;
+    size_t resident = 0;
+    statm >> size >> resident;
+    return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+}
+
+size_t peakRSS() {
+    struct rusage usage {};
+    getrusage(RUSAGE_SELF, &usage);
+    return static_cast<size_t>(usage.ru_maxrss) * 1024;  // in kilobytes on Linux
+}
+
+void appendAxon(const std::shared_ptr<morphio::mut::Section>& parent,
+                size_t depth,
+                size_t points_per_section) {
+    if (depth == 0) {
+        return;
+    }
+
+    const auto start = parent->points().back();
+    for (int side : {-1, 1}) {
+        morphio::Property::PointLevel level;
+        for (size_t i = 0; i < points_per_section; ++i) {
+            const auto step = static_cast<morphio::floatType>(i);
+            level._points.push_back(
+                {start[0] + static_cast<morphio::floatType>(side) * step, start[1] + step, start[2]});
+            level._diameters.push_back(1);
+        }
+        appendAxon(parent->appendSection(level, morphio::SECTION_AXON),
+                   depth - 1,
+                   points_per_section);
+    }
+}
+
+void writeAxonHeavyCell(const std::filesystem::path& directory,
+                        size_t n_points,
+                        size_t points_per_section) {
+    morphio::mut::Morphology morph;
+    morph.soma()->points() = {{-1, 0, 0}, {0, 0, 0}, {1, 0, 0}};
+    morph.soma()->diameters() = {2, 2, 2};
+
+    morphio::Property::PointLevel trunk;
+    for (size_t i = 0; i < points_per_section; ++i) {
+        trunk._points.push_back({0, static_cast<morphio::floatType>(i), 0});
+        trunk._diameters.push_back(2);
+    }
+    const auto root = morph.appendRootSection(trunk, morphio::SECTION_AXON);
+
+    // A binary tree of depth `d` has 2^(d+1) - 1 sections.
+    size_t depth = 0;
+    while ((size_t{4} << depth) * points_per_section <= n_points) {
+        ++depth;
+    }
+    appendAxon(root, depth, points_per_section);
+
+    for (const std::string extension : EXTENSIONS) {
+        // SWC only knows cylinder somata, the other formats store contours.
+        morph.soma()->type() = extension == "swc" ? morphio::SOMA_CYLINDERS
+                                                  : morphio::SOMA_SIMPLE_CONTOUR;
+        morph.write(cellPath(directory, extension));
+    }
+}
+
+void measure(const std::string& path, unsigned int options) {
+    const size_t baselineRSS = currentRSS();
+    resetAllocationCounters();
+    const auto& counters = allocationCounters();
+    const size_t baselineBytes = counters.liveBytes;
+
+    size_t n_points = 0;
+    {
+        const morphio::Morphology morph(path, options);
+        n_points = morph.points().size();
+    }
+
+    const size_t peak = peakRSS();
+    std::cout << std::setw(12) << std::filesystem::path(path).extension().string()
+              << std::setw(10) << (options == morphio::NO_MODIFIER ? "none" : "no_dup")
+              << std::setw(12) << n_points << std::setw(14) << counters.allocations << std::setw(16)
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(counters.allocatedBytes) / MB << std::setw(16)
+              << static_cast<double>(counters.peakBytes - baselineBytes) / MB
+              << std::setw(16)
+              << static_cast<double>(peak > baselineRSS ? peak - baselineRSS : 0) / MB << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n_points = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    const size_t points_per_section = argc > 2 ? std::stoul(argv[2]) : 100;
+    if (points_per_section < 2) {
+        std::cerr << "Usage: " << argv[0] << " [n_points] [points_per_section >= 2]\n";
+        return 1;
+    }
+
+    const auto directory = std::filesystem::temp_directory_path() / "morphio_bench_load_memory";
+    std::filesystem::create_directories(directory);
+
+    {  // Written in a child process, to keep the memory of the writer out of the measurements.
+        std::cout.flush();
+        const pid_t pid = fork();
+        if (pid == 0) {
+            writeAxonHeavyCell(directory, n_points, points_per_section);
+            std::cout.flush();
+            std::_Exit(0);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            std::cerr << "failed to write the morphology to " << directory << '\n';
+            return 1;
+        }
+    }
+
+    std::cout << std::setw(12) << "format" << std::setw(10) << "modifier" << std::setw(12)
+              << "points" << std::setw(14) << "allocations" << std::setw(16) << "allocated [MB]"
+              << std::setw(16) << "peak heap [MB]" << std::setw(16) << "peak RSS [MB]" << '\n';
+
+    for (const std::string extension : EXTENSIONS) {
+        const auto path = cellPath(directory, extension);
+        for (unsigned int options : {morphio::NO_MODIFIER, morphio::NO_DUPLICATES}) {
+            std::cout.flush();
+            const pid_t pid = fork();
+            if (pid == 0) {
+                measure(path, options);
+                std::cout.flush();
+                std::_Exit(0);
+            }
+            int status = 0;
+            waitpid(pid, &status, 0);
+            if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+                std::cerr << "failed to load " << path << '\n';
+                return 1;
+            }
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+    return 0;
+}
@@ -0,0 +1,123 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Cost of converting a large morphology between `morphio::Morphology` and
+ * `morphio::mut::Morphology`: time, heap allocations and allocated bytes per
+ * conversion, and for the round trip done to apply a modifier. The section by
+ * section copy made by appending the root sections recursively is given for
+ * reference.
+ *
+ * The morphology is synthesized: a binary tree of axon sections with
+ * `points_per_section` points each, for a total of about `n_points` points.
+ *
+ * Usage: bench_mutable_conversion [n_points] [points_per_section] [repetitions]
+ */
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include <morphio/enums.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/section.h>
+
+#include "allocation_counter.h"
+
+namespace {
+
+constexpr double MB = 1024. * 1024.;
+
+morphio::Morphology makeAxon(size_t n_points, size_t points_per_section) {
+    morphio::mut::Morphology morph;
+
+    const auto append = [points_per_section](const morphio::Point& start, morphio::floatType side) {
+        morphio::Property::PointLevel level;
+        for (size_t i = 0; i < points_per_section; ++i) {
+            const auto step = static_cast<morphio::floatType>(i);
+            level._points.push_back({start[0] + side * step, start[1] + step, start[2]});
+            level._diameters.push_back(1);
+        }
+        return level;
+    };
+
+    std::deque<std::shared_ptr<morphio::mut::Section>> leaves;
+    leaves.push_back(morph.appendRootSection(append({0, 0, 0}, 0), morphio::SECTION_AXON));
+    for (size_t count = points_per_section; count + 2 * points_per_section <= n_points;
+         count += 2 * points_per_section) {
+        const auto parent = leaves.front();
+        leaves.pop_front();
+        const auto start = parent->points().back();
+        for (morphio::floatType side : {-1, 1}) {
+            leaves.push_back(parent->appendSection(append(start, side), morphio::SECTION_AXON));
+        }
+    }
+    return morphio::Morphology(morph);
+}
+
+template <typename F>
+void report(const std::string& name, size_t repetitions, F&& run) {
+    resetAllocationCounters();
+    const auto& counters = allocationCounters();
+    size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        checksum += run();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const auto n = static_cast<double>(repetitions);
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    std::cout << std::setw(28) << name << std::setw(14) << std::fixed << std::setprecision(2)
+              << 1e3 * seconds / n << std::setw(16) << std::setprecision(0)
+              << static_cast<double>(counters.allocations) / n << std::setw(14)
+              << std::setprecision(1) << static_cast<double>(counters.allocatedBytes) / MB / n << std::setw(12) << checksum
+              << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n_points = argc > 1 ? std::stoul(argv[1]) : 1000000;
+    const size_t points_per_section = argc > 2 ? std::stoul(argv[2]) : 20;
+    const size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 5;
+    if (points_per_section < 2) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [n_points] [points_per_section >= 2] [repetitions]\n";
+        return 1;
+    }
+
+    const auto morph = makeAxon(n_points, points_per_section);
+    const morphio::mut::Morphology mutableMorph(morph);
+
+    std::cout << morph.sections().size() << " sections, " << morph.points().size()
+              << " points\n";
+    std::cout << std::setw(28) << "conversion" << std::setw(14) << "ms" << std::setw(16)
+              << "allocations" << std::setw(14) << "MB" << std::setw(12) << "checksum" << '\n';
+
+    report("recursive append", repetitions, [&]() {
+        morphio::mut::Morphology copy;
+        for (const auto& root : morph.rootSections()) {
+            copy.appendRootSection(root, true);
+        }
+        return copy.sections().size();
+    });
+    report("to mutable", repetitions, [&]() {
+        return morphio::mut::Morphology(morph).sections().size();
+    });
+    report("to immutable", repetitions, [&]() {
+        return morphio::Morphology(mutableMorph).points().size();
+    });
+    report("round trip", repetitions, [&]() {
+        return morphio::Morphology(morphio::mut::Morphology(morph)).points().size();
+    });
+
+    return 0;
+}
@@ -0,0 +1,165 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Cost of traversing every section of a large axon, depth and breadth first:
+ * the deque based iterators, as still used by `mut::Morphology`, against the
+ * precomputed orders of `morphio::Morphology`, either through its iterators
+ * or by looping over the section IDs.
+ *
+ * The axon is synthesized: a binary tree of two point sections, grown level
+ * by level until it has `n_sections` sections.
+ *
+ * Usage: bench_section_traversal [n_sections] [repetitions]
+ */
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <morphio/enums.h>
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/section.h>
+#include <morphio/section.h>
+
+namespace {
+
+morphio::mut::Morphology makeAxon(size_t n_sections) {
+    morphio::mut::Morphology morph;
+
+    const auto append = [](const morphio::Point& start, morphio::floatType side) {
+        morphio::Property::PointLevel level;
+        level._points = {start, {start[0] + side, start[1] + 1, start[2]}};
+        level._diameters = {1, 1};
+        return level;
+    };
+
+    std::deque<std::shared_ptr<morphio::mut::Section>> leaves;
+    leaves.push_back(morph.appendRootSection(append({0, 0, 0}, 0), morphio::SECTION_AXON));
+    for (size_t count = 1; count + 2 <= n_sections; count += 2) {
+        const auto parent = leaves.front();
+        leaves.pop_front();
+        for (morphio::floatType side : {-1, 1}) {
+            leaves.push_back(
+                parent->appendSection(append(parent->points().back(), side), morphio::SECTION_AXON));
+        }
+    }
+    return morph;
+}
+
+// What the iterators of morphio::Morphology used to do: a deque of sections,
+// refilled with a copy of the children at every step.
+template <bool depthFirst>
+size_t dequeTraversal(const morphio::Morphology& morph) {
+    std::deque<morphio::Section> deque;
+    for (const auto& root : morph.rootSections()) {
+        deque.push_back(root);
+    }
+
+    size_t checksum = 0;
+    while (!deque.empty()) {
+        const auto section = deque.front();
+        deque.pop_front();
+        checksum += section.id();
+
+        const auto children = section.children();
+        if (depthFirst) {
+            deque.insert(deque.begin(), children.begin(), children.end());
+        } else {
+            deque.insert(deque.end(), children.begin(), children.end());
+        }
+    }
+    return checksum;
+}
+
+template <typename Iterator>
+size_t iteratorTraversal(Iterator begin, Iterator end) {
+    size_t checksum = 0;
+    for (auto it = begin; it != end; ++it) {
+        checksum += it->id();
+    }
+    return checksum;
+}
+
+size_t mutTraversal(morphio::mut::depth_iterator begin, morphio::mut::depth_iterator end) {
+    size_t checksum = 0;
+    for (auto it = begin; it != end; ++it) {
+        checksum += (*it)->id();
+    }
+    return checksum;
+}
+
+size_t idTraversal(const morphio::Morphology& morph, morphio::SectionOrder order) {
+    size_t checksum = 0;
+    for (uint32_t id : morph.sectionOrder(order)) {
+        checksum += id;
+    }
+    return checksum;
+}
+
+template <typename F>
+void report(const std::string& name, size_t repetitions, size_t n_sections, F&& traverse) {
+    size_t checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        checksum += traverse();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    std::cout << std::setw(28) << name << std::setw(16) << std::fixed << std::setprecision(2)
+              << 1e9 * seconds / static_cast<double>(repetitions * n_sections) << std::setw(20)
+              << checksum << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n_sections = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const size_t repetitions = argc > 2 ? std::stoul(argv[2]) : 100;
+
+    const auto mutMorph = makeAxon(n_sections);
+    const morphio::Morphology morph(mutMorph);
+    const size_t total = morph.sections().size();
+
+    std::cout << total << " sections, " << repetitions << " repetitions\n";
+    std::cout << std::setw(28) << "traversal" << std::setw(16) << "ns / section" << std::setw(20)
+              << "checksum" << '\n';
+
+    using morphio::SectionOrder;
+    report("deque, depth first", repetitions, total, [&]() {
+        return dequeTraversal<true>(morph);
+    });
+    report("iterator, depth first", repetitions, total, [&]() {
+        return iteratorTraversal(morph.depth_begin(), morph.depth_end());
+    });
+    report("ids, depth first", repetitions, total, [&]() {
+        return idTraversal(morph, SectionOrder::DEPTH_FIRST);
+    });
+    report("mut iterator, depth first", repetitions, total, [&]() {
+        return mutTraversal(mutMorph.depth_begin(), mutMorph.depth_end());
+    });
+
+    report("deque, breadth first", repetitions, total, [&]() {
+        return dequeTraversal<false>(morph);
+    });
+    report("iterator, breadth first", repetitions, total, [&]() {
+        return iteratorTraversal(morph.breadth_begin(), morph.breadth_end());
+    });
+    report("ids, breadth first", repetitions, total, [&]() {
+        return idTraversal(morph, SectionOrder::BREADTH_FIRST);
+    });
+
+    report("ids, NEURON order", repetitions, total, [&]() {
+        return idTraversal(morph, SectionOrder::NEURON);
+    });
+
+    return 0;
+}
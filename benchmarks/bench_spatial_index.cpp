@@ -0,0 +1,174 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Cost of building a `morphio::SpatialIndex` and of querying it, against a
+ * brute force scan over all the segments, as done without an index.
+ *
+ * The morphology is synthesized: sections of 10 points, each one a random walk
+ * starting from the end of a random earlier section. For the appositions of a
+ * `morphio::CollectionSpatialIndex`, the sections are dealt to 16 cells.
+ *
+ * Usage: bench_spatial_index [n_sections] [n_queries]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <morphio/spatial_index.h>
+
+namespace {
+
+using morphio::floatType;
+using morphio::Point;
+
+struct Neurite {
+    std::vector<Point> points;
+    std::vector<floatType> diameters;
+    std::vector<morphio::Property::Section::Type> sections;
+};
+
+Neurite makeNeurite(size_t n_sections) {
+    std::mt19937 rng(0);
+    std::normal_distribution<floatType> step(0, 2);
+    std::uniform_real_distribution<floatType> diameter(0.2f, 2.f);
+
+    Neurite neurite;
+    for (size_t s = 0; s < n_sections; ++s) {
+        const int parent = s == 0 ? -1 : static_cast<int>(rng() % s);
+        Point point = parent < 0
+                          ? Point{0, 0, 0}
+                          : neurite.points[static_cast<size_t>(
+                                neurite.sections[static_cast<size_t>(parent)][0] + 9)];
+        neurite.sections.push_back({static_cast<int>(neurite.points.size()), parent});
+        for (size_t i = 0; i < 10; ++i) {
+            neurite.points.push_back(point);
+            neurite.diameters.push_back(diameter(rng));
+            point = {point[0] + step(rng), point[1] + step(rng), point[2] + step(rng)};
+        }
+    }
+    return neurite;
+}
+
+// Distance to the closest segment surface, checking every segment
+floatType bruteForceNearest(const Neurite& neurite, const Point& point) {
+    floatType best = std::numeric_limits<floatType>::max();
+    for (size_t s = 0; s < neurite.sections.size(); ++s) {
+        const auto begin = static_cast<size_t>(neurite.sections[s][0]);
+        for (size_t i = begin; i + 1 < begin + 10; ++i) {
+            const Point& a = neurite.points[i];
+            const Point& b = neurite.points[i + 1];
+            const Point ab{b[0] - a[0], b[1] - a[1], b[2] - a[2]};
+            const Point ap{point[0] - a[0], point[1] - a[1], point[2] - a[2]};
+            const floatType squared = ab[0] * ab[0] + ab[1] * ab[1] + ab[2] * ab[2];
+            floatType t = squared > 0 ? (ap[0] * ab[0] + ap[1] * ab[1] + ap[2] * ab[2]) / squared
+                                      : 0;
+            t = std::min(std::max(t, floatType{0}), floatType{1});
+            const Point d{ap[0] - t * ab[0], ap[1] - t * ab[1], ap[2] - t * ab[2]};
+            const floatType radius = (neurite.diameters[i] +
+                                      t * (neurite.diameters[i + 1] - neurite.diameters[i])) /
+                                     2;
+            const floatType distance = std::sqrt(d[0] * d[0] + d[1] * d[1] + d[2] * d[2]) -
+                                       radius;
+            best = std::min(best, std::max(distance, floatType{0}));
+        }
+    }
+    return best;
+}
+
+template <typename F>
+void report(const std::string& name, size_t repetitions, F&& run) {
+    double checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        checksum += static_cast<double>(run(i));
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    std::cout << std::setw(28) << name << std::setw(16) << std::fixed << std::setprecision(2)
+              << 1e6 * seconds / static_cast<double>(repetitions) << std::setw(20) << checksum
+              << '\n';
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n_sections = argc > 1 ? std::stoul(argv[1]) : 10000;
+    const size_t n_queries = argc > 2 ? std::stoul(argv[2]) : 1000;
+
+    const auto neurite = makeNeurite(n_sections);
+
+    std::vector<Point> queries;
+    std::mt19937 rng(1);
+    for (size_t i = 0; i < n_queries; ++i) {
+        const auto& point = neurite.points[rng() % neurite.points.size()];
+        queries.push_back({point[0] + 3, point[1] - 2, point[2] + 1});
+    }
+
+    std::cout << n_sections << " sections, " << neurite.points.size() << " points, " << n_queries
+              << " queries\n";
+    std::cout << std::setw(28) << "operation" << std::setw(16) << "us / operation"
+              << std::setw(20) << "checksum" << '\n';
+
+    report("build", 10, [&](size_t) {
+        return morphio::SpatialIndex(neurite.points, neurite.diameters, neurite.sections).size();
+    });
+
+    const morphio::SpatialIndex index(neurite.points, neurite.diameters, neurite.sections);
+    report("brute force, nearest", n_queries, [&](size_t i) {
+        return bruteForceNearest(neurite, queries[i]);
+    });
+    report("index, nearest", n_queries, [&](size_t i) {
+        return index.nearest(queries[i], 1)[0].distance;
+    });
+    report("index, 10 nearest", n_queries, [&](size_t i) {
+        return index.nearest(queries[i], 10).back().distance;
+    });
+    report("index, within 5", n_queries, [&](size_t i) {
+        return index.within(queries[i], 5).size();
+    });
+    report("index, contains", n_queries, [&](size_t i) {
+        return index.contains(queries[i]) ? 1 : 0;
+    });
+    report("index, box", n_queries, [&](size_t i) {
+        const auto& q = queries[i];
+        return index.intersecting({Point{q[0] - 5, q[1] - 5, q[2] - 5},
+                                   Point{q[0] + 5, q[1] + 5, q[2] + 5}})
+            .size();
+    });
+    report("index, ray", n_queries, [&](size_t i) {
+        return index.raycast(queries[i], Point{1, 1, 0}, 50).size();
+    });
+
+    std::vector<morphio::SpatialIndex::Capsule> capsules;
+    for (size_t s = 0; s < neurite.sections.size(); ++s) {
+        const auto begin = static_cast<size_t>(neurite.sections[s][0]);
+        for (size_t i = begin; i + 1 < begin + 10; ++i) {
+            capsules.push_back({neurite.points[i],
+                                neurite.points[i + 1],
+                                neurite.diameters[i] / 2,
+                                neurite.diameters[i + 1] / 2,
+                                static_cast<uint32_t>(s),
+                                static_cast<uint32_t>(i - begin),
+                                static_cast<uint32_t>(s % 16)});
+        }
+    }
+    const morphio::CollectionSpatialIndex cells(capsules);
+    for (size_t n_threads : {1, 2, 4, 8}) {
+        report("appositions, " + std::to_string(n_threads) + " threads", 3, [&](size_t) {
+            return cells.appositions(0, n_threads).size();
+        });
+    }
+
+    return 0;
+}
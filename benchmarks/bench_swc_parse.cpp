@@ -0,0 +1,140 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Throughput of the SWC reader, in MB of text per second: number parsing
+ * alone, then loading from a string and from a file.
+ *
+ * The morphology is synthesized: a soma and a binary tree of axon sections
+ * with `points_per_section` samples each, for a total of about `n_samples`
+ * samples, written with three decimals like most reconstructions.
+ *
+ * Usage: bench_swc_parse [n_samples] [points_per_section] [repetitions]
+ */
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/warning_handling.h>
+
+#include "../src/readers/utils.h"
+
+namespace {
+
+constexpr double MB = 1024. * 1024.;
+
+std::string makeSWC(size_t n_samples, size_t points_per_section) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "# synthesized by bench_swc_parse\n";
+    out << "1 1 0.000 0.000 0.000 5.000 -1\n";
+
+    // The last sample of the sections still to be split
+    std::vector<size_t> leaves{1};
+    size_t id = 2;
+    for (size_t next = 0; next < leaves.size() && id + points_per_section <= n_samples; ++next) {
+        for (int side : {-1, 1}) {
+            size_t parent = leaves[next];
+            for (size_t i = 0; i < points_per_section; ++i, ++id) {
+                const double step = static_cast<double>(id) * 0.731;
+                out << id << " 2 " << side * step << ' ' << step * 1.379 << ' ' << -step * 0.517
+                    << ' ' << 0.25 + static_cast<double>(i % 7) * 0.125 << ' ' << parent << '\n';
+                parent = id;
+            }
+            leaves.push_back(parent);
+        }
+    }
+    return out.str();
+}
+
+template <typename F>
+void report(const std::string& name, size_t bytes, size_t repetitions, F&& run) {
+    double checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repetitions; ++i) {
+        checksum += run();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(stop - start).count();
+    std::cout << std::setw(28) << name << std::setw(14) << std::fixed << std::setprecision(2)
+              << 1e3 * seconds / static_cast<double>(repetitions) << std::setw(12)
+              << std::setprecision(1)
+              << static_cast<double>(bytes * repetitions) / MB / seconds << std::setw(16)
+              << std::setprecision(0) << checksum << '\n';
+}
+
+// Sum of all the numbers of `contents`, read as floats
+template <typename Parse>
+double sumNumbers(const std::string& contents, Parse&& parse) {
+    double sum = 0;
+    size_t pos = 0;
+    while (pos < contents.size()) {
+        const char c = contents[pos];
+        if (c == '#') {
+            pos = contents.find('\n', pos);
+        } else if (c == ' ' || c == '\n') {
+            ++pos;
+        } else {
+            const auto parsed = parse(pos);
+            sum += std::get<0>(parsed);
+            pos = std::get<1>(parsed);
+        }
+    }
+    return sum;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    const size_t n_samples = argc > 1 ? std::stoul(argv[1]) : 2000000;
+    const size_t points_per_section = argc > 2 ? std::stoul(argv[2]) : 50;
+    const size_t repetitions = argc > 3 ? std::stoul(argv[3]) : 5;
+    if (points_per_section < 1) {
+        std::cerr << "Usage: " << argv[0]
+                  << " [n_samples] [points_per_section >= 1] [repetitions]\n";
+        return 1;
+    }
+
+    const std::string contents = makeSWC(n_samples, points_per_section);
+    const auto path = std::filesystem::temp_directory_path() / "bench_swc_parse.swc";
+    std::ofstream(path) << contents;
+
+    // The synthesized tree has no warnings, but make sure none is printed
+    const auto handler = std::make_shared<morphio::WarningHandlerCollector>();
+
+    std::cout << std::fixed << std::setprecision(1) << static_cast<double>(contents.size()) / MB
+              << " MB of SWC\n";
+    std::cout << std::setw(28) << "case" << std::setw(14) << "ms" << std::setw(12) << "MB/s"
+              << std::setw(16) << "checksum" << '\n';
+
+    report("strtof with locale", contents.size(), repetitions, [&]() {
+        const auto& stn = morphio::getStringToNumber();
+        return sumNumbers(contents, [&](size_t pos) { return stn.toFloat(contents, pos); });
+    });
+    report("parseFloat", contents.size(), repetitions, [&]() {
+        return sumNumbers(contents, [&](size_t pos) {
+            const auto parsed = morphio::parseFloat({contents.data() + pos, contents.size() - pos});
+            return std::make_tuple(std::get<0>(parsed), pos + std::get<1>(parsed));
+        });
+    });
+    report("load from string", contents.size(), repetitions, [&]() {
+        return morphio::Morphology(contents, "swc", morphio::NO_MODIFIER, handler).points().size();
+    });
+    report("load from file", contents.size(), repetitions, [&]() {
+        return morphio::Morphology(path.string(), morphio::NO_MODIFIER, handler).points().size();
+    });
+
+    std::filesystem::remove(path);
+    return 0;
+}
@@ -72,6 +72,7 @@ void bind_enums(py::module& m) {
         .value("nrn_order", morphio::enums::Option::NRN_ORDER)
         .value("allow_unifurcated_section_change",
                morphio::enums::Option::ALLOW_UNIFURCATED_SECTION_CHANGE)
+        .value("point_columns", morphio::enums::Option::POINT_COLUMNS)
         .export_values();
 
 
@@ -114,6 +114,32 @@ void bind_morphology(py::module& m) {
                 return py::array(static_cast<py::ssize_t>(data.size()), data.data());
             },
             D(diameters))
+        .def_property_readonly(
+            "point_columns",
+            [](py::object self) {
+                const auto columns = self.cast<const morphio::Morphology&>().pointColumns();
+                // Read-only views that keep the morphology alive, nothing is copied
+                const auto view = [&self](const morphio::floatType* data,
+                                          size_t size,
+                                          size_t stride) {
+                    py::array_t<morphio::floatType> array(
+                        {static_cast<py::ssize_t>(size)},
+                        {static_cast<py::ssize_t>(stride * sizeof(morphio::floatType))},
+                        data,
+                        self);
+                    array.attr("setflags")("write"_a = false);
+                    return array;
+                };
+                return py::make_tuple(
+                    view(columns._x.data(), columns._x.size(), columns._x.stride()),
+                    view(columns._y.data(), columns._y.size(), columns._y.stride()),
+                    view(columns._z.data(), columns._z.size(), columns._z.stride()),
+                    view(columns._diameters.data(), columns._diameters.size(), 1));
+            },
+            "Returns the x, y, z and diameter columns of the points, as a tuple of read-only "
+            "arrays\n"
+            "Note: the arrays are views of the morphology, they are contiguous if it is loaded "
+            "with Option.point_columns")
         .def_property_readonly(
             "perimeters",
             [](const morphio::Morphology& obj) {
@@ -132,6 +158,30 @@ void bind_morphology(py::module& m) {
                 return py::array(static_cast<py::ssize_t>(data.size()), data.data());
             },
             D(sectionTypes))
+        .def_property_readonly(
+            "section_lengths",
+            [](const morphio::Morphology& morph) {
+                return span_to_ndarray(morph.sectionLengths());
+            },
+            "Returns the length of every section\n"
+            "Note: computed once per morphology, along with the other section aggregates")
+        .def_property_readonly(
+            "section_areas",
+            [](const morphio::Morphology& morph) { return span_to_ndarray(morph.sectionAreas()); },
+            "Returns the lateral area of every section")
+        .def_property_readonly(
+            "section_volumes",
+            [](const morphio::Morphology& morph) {
+                return span_to_ndarray(morph.sectionVolumes());
+            },
+            "Returns the volume of every section")
+        .def("transformed",
+             &morphio::Morphology::transformed,
+             "Returns a copy of this morphology with the affine transform applied to its "
+             "points\n"
+             "The transform is given as the first 3 rows of its 4x4 matrix, and is expected "
+             "to be rigid: diameters are not scaled",
+             "transform"_a)
         .def_property_readonly("connectivity", &morphio::Morphology::connectivity, D(connectivity))
         .def_property_readonly("soma_type", &morphio::Morphology::somaType, D(somaType))
         .def_property_readonly("cell_family", &morphio::Morphology::cellFamily, D(cellFamily))
@@ -273,6 +323,22 @@ void bind_section(py::module& m) {
             "perimeters",
             [](Section* section) { return span_to_ndarray(section->perimeters()); },
             D(perimeters))
+        .def_property_readonly("length", &Section::length, "Returns the length of the section")
+        .def_property_readonly("area",
+                               &Section::area,
+                               "Returns the lateral area of the section, as frustums of cone "
+                               "between consecutive points")
+        .def_property_readonly("volume",
+                               &Section::volume,
+                               "Returns the volume of the section, as frustums of cone between "
+                               "consecutive points")
+        .def_property_readonly(
+            "bounding_box",
+            [](const Section& section) {
+                const auto box = section.boundingBox();
+                return span_array_to_ndarray(morphio::range<const morphio::Point>(box));
+            },
+            "Returns the bounding box of the section points, as [minimum corner, maximum corner]")
         .def("is_heterogeneous",
              &Section::isHeterogeneous,
              D(isHeterogeneous),
@@ -7,17 +7,97 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 
+#include <memory>   // std::unique_ptr
+#include <string>
+#include <utility>  // std::declval
+
 #include <morphio/collection.h>
 #include <morphio/enums.h>
 #include <morphio/errorMessages.h>
+#include <morphio/morphology.h>
 #include <morphio/types.h>
 #include <morphio/version.h>
 
+#include "bindings_utils.h"
 #include "generated/docstrings.h"
 
 
 namespace py = pybind11;
 
+namespace {
+
+/**
+ * A Python iterator over a `morphio::LoadParallel` or `morphio::LoadUnordered`.
+ *
+ * Unlike `py::make_iterator`, `__next__` releases the GIL while it waits for
+ * the next morphology: the threads loading it may need the GIL themselves,
+ * e.g. to print warnings under `morphio.ostream_redirect`.
+ */
+template <class Iterable>
+class LoadIterator
+{
+  public:
+    explicit LoadIterator(const Iterable& iterable)
+        : _it(iterable.begin())
+        , _end(iterable.end()) {}
+
+    py::object next() {
+        std::unique_ptr<Value> value;
+        {
+            py::gil_scoped_release release;
+            if (!_first && _it != _end) {
+                ++_it;
+            }
+            _first = false;
+            if (_it != _end) {
+                value.reset(new Value(*_it));
+            }
+        }
+
+        if (!value) {
+            throw py::stop_iteration();
+        }
+        return py::cast(std::move(*value));
+    }
+
+  private:
+    using Iterator = decltype(std::declval<const Iterable&>().begin());
+    using Value = decltype(*std::declval<const Iterator&>());
+
+    Iterator _it;
+    Iterator _end;
+    bool _first = true;
+};
+
+/**
+ * Deletes without holding the GIL: deleting the last reference to a loader
+ * joins its threads, which may be waiting for the GIL.
+ */
+struct GilReleasingDelete {
+    template <class T>
+    void operator()(T* ptr) const {
+        py::gil_scoped_release release;
+        delete ptr;
+    }
+};
+
+template <class Iterable>
+void bind_load_iterable(py::module& m, const char* name, const char* doc) {
+    py::class_<LoadIterator<Iterable>, std::unique_ptr<LoadIterator<Iterable>, GilReleasingDelete>>(
+        m, (std::string(name) + "Iterator").c_str())
+        .def("__iter__", [](py::object self) { return self; })
+        .def("__next__", &LoadIterator<Iterable>::next);
+
+    py::class_<Iterable, std::unique_ptr<Iterable, GilReleasingDelete>>(m, name, doc).def(
+        "__iter__",
+        [](const Iterable& iterable) { return LoadIterator<Iterable>(iterable); },
+        // Bind the lifetime of the iterable (1) to the lifetime of the
+        // returned iterator (0).
+        py::keep_alive<0, 1>());
+}
+
+}  // namespace
+
 void bind_misc(py::module& m) {
     using namespace py::literals;
 
@@ -81,10 +161,15 @@ void bind_misc(py::module& m) {
         .def_readwrite("section_types",
                        &morphio::Property::SectionLevel::_sectionTypes,
                        "Returns the list of section types")
-        .def_readwrite("children",
-                       &morphio::Property::SectionLevel::_children,
-                       "Returns a dictionary where key is a section ID "
-                       "and value is the list of children section IDs");
+        .def_property(
+            "children",
+            [](const morphio::Property::SectionLevel& level) { return level._children.toMap(); },
+            [](morphio::Property::SectionLevel& level,
+               const std::map<int, std::vector<unsigned int>>& children) {
+                level._children = children;
+            },
+            "Returns a dictionary where key is a section ID "
+            "and value is the list of children section IDs");
 
     py::class_<morphio::Property::CellLevel>(m, "CellLevel", DOC(morphio, Property, CellLevel))
         .def_readwrite("cell_family",
@@ -106,16 +191,22 @@ void bind_misc(py::module& m) {
         .def_readwrite("details", &morphio::Property::Annotation::_details, "Returns the details")
         .def_property_readonly(
             "points",
-            [](morphio::Property::Annotation* a) { return a->_points._points; },
-            "Returns the list of coordinates of annotated points")
+            [](morphio::Property::Annotation* a) {
+                return span_array_to_ndarray(a->_points.points());
+            },
+            "Returns the coordinates of annotated points, as an array of shape (n, 3)")
         .def_property_readonly(
             "diameters",
-            [](morphio::Property::Annotation* a) { return a->_points._diameters; },
-            "Returns the list of diameters of annotated points")
+            [](morphio::Property::Annotation* a) {
+                return span_to_ndarray(a->_points.diameters());
+            },
+            "Returns the diameters of annotated points, as an array")
         .def_property_readonly(
             "perimeters",
-            [](morphio::Property::Annotation* a) { return a->_points._perimeters; },
-            "Returns the list of perimeters of annotated points");
+            [](morphio::Property::Annotation* a) {
+                return span_to_ndarray(a->_points.perimeters());
+            },
+            "Returns the perimeters of annotated points, as an array");
 
     py::class_<morphio::Property::Marker>(m,
                                           "Marker",
@@ -126,12 +217,16 @@ void bind_misc(py::module& m) {
             "Returns the label")
         .def_property_readonly(
             "points",
-            [](morphio::Property::Marker* marker) { return marker->_pointLevel._points; },
-            "Returns the list of coordinates of the marker points")
+            [](morphio::Property::Marker* marker) {
+                return span_array_to_ndarray(marker->_pointLevel.points());
+            },
+            "Returns the coordinates of the marker points, as an array of shape (n, 3)")
         .def_property_readonly(
             "diameters",
-            [](morphio::Property::Marker* marker) { return marker->_pointLevel._diameters; },
-            "Returns the list of diameters of the marker points")
+            [](morphio::Property::Marker* marker) {
+                return span_to_ndarray(marker->_pointLevel.diameters());
+            },
+            "Returns the diameters of the marker points, as an array")
         .def_property_readonly(
             "section_id",
             [](morphio::Property::Marker* marker) { return marker->_sectionId; },
@@ -166,6 +261,76 @@ void bind_misc(py::module& m) {
                       &morphio::Property::DendriticSpine::PostSynapticDensity::offset,
                       "Returns `offset` of post-synaptic density");
 
+    py::class_<morphio::CollectionIndexStats>(m,
+                                              "CollectionIndexStats",
+                                              "Statistics about the sidecar index of a container")
+        .def_readonly("found",
+                      &morphio::CollectionIndexStats::found,
+                      "Was an index found next to the container")
+        .def_readonly("stale",
+                      &morphio::CollectionIndexStats::stale,
+                      "Was the index ignored because it is out of date or unreadable")
+        .def_readonly("size",
+                      &morphio::CollectionIndexStats::size,
+                      "Number of morphologies in the index")
+        .def_readonly("load_time",
+                      &morphio::CollectionIndexStats::load_time,
+                      "Time spent reading the index, in seconds")
+        .def_readonly("n_lookups",
+                      &morphio::CollectionIndexStats::n_lookups,
+                      "Number of lookups by name")
+        .def_readonly("n_hits",
+                      &morphio::CollectionIndexStats::n_hits,
+                      "Number of lookups which found the morphology")
+        .def_readonly("lookup_time",
+                      &morphio::CollectionIndexStats::lookup_time,
+                      "Time spent in lookups, in seconds");
+
+    m.def(
+        "write_container_index",
+        [](py::object container_path) {
+            return morphio::write_container_index(py::str(container_path));
+        },
+        "container_path"_a,
+        R"(Write the sidecar index of the container at `container_path`.
+
+The index is stored in `container_path + ".index"` and used by `Collection` to
+locate morphologies without traversing the HDF5 groups. It is ignored once the
+container is modified.
+
+Returns the time, in seconds, taken to build and write the index.
+
+Note: This API is 'experimental', meaning it might change in the future.
+)");
+
+    m.def(
+        "pack_collection",
+        [](py::object collection_path, py::object output_path, std::vector<std::string> extensions) {
+            morphio::pack_collection(py::str(collection_path), py::str(output_path), extensions);
+        },
+        "collection_path"_a,
+        "output_path"_a,
+        "extensions"_a = std::vector<std::string>{".h5", ".H5", ".asc", ".ASC", ".swc", ".SWC"},
+        R"(Pack all morphologies of a collection into a single file at `output_path`.
+
+The collection can be a directory, an HDF5 container or another packed container.
+`Collection` maps the packed container into memory, such that loading a
+morphology neither requires a system call nor the HDF5 lock.
+
+Note: This API is 'experimental', meaning it might change in the future.
+)");
+
+    m.def("set_maximum_swc_threads",
+          &morphio::set_maximum_swc_threads,
+          "n_threads"_a,
+          R"(Set the maximum number of threads reading a large SWC file.
+
+0, the default, uses one per hardware thread, and 1 reads on the calling thread
+only. The threads of `Collection.load_parallel`, and the one of
+`Collection.load_unordered` when it prefetches, always read the files they load
+on their own.
+)");
+
     py::class_<morphio::Collection>(m, "Collection", "A collection of morphologies")
         .def(py::init<std::string>(), "collection_path"_a)
         .def(py::init([](py::object arg) { return morphio::Collection(py::str(arg)); }),
@@ -205,19 +370,21 @@ void bind_misc(py::module& m) {
                std::vector<std::string> morphology_names,
                unsigned int options,
                bool is_mutable,
-               std::shared_ptr<morphio::WarningHandler> warning_handler) -> py::object {
+               std::shared_ptr<morphio::WarningHandler> warning_handler,
+               size_t prefetch) -> py::object {
                 if (is_mutable) {
                     return py::cast(collection->load_unordered<morphio::mut::Morphology>(
-                        morphology_names, options, warning_handler));
+                        morphology_names, options, warning_handler, prefetch));
                 } else {
                     return py::cast(collection->load_unordered<morphio::Morphology>(
-                        morphology_names, options, warning_handler));
+                        morphology_names, options, warning_handler, prefetch));
                 }
             },
             "morphology_names"_a,
             "options"_a = morphio::enums::Option::NO_MODIFIER,
             "mutable"_a = false,
             "warning_handler"_a = std::shared_ptr<morphio::WarningHandler>(nullptr),
+            "prefetch"_a = 0,
             R"(Create an iterable of loop index and morphology.
 
 When reading from containers, the order in which morphologies are read can
@@ -240,10 +407,53 @@ The order in which the morphologies are returned in unspecified, but the
 loop index `k` can be used to retrieve the correct state corresponding to
 iteration `k` of the original loop.
 
+If `prefetch` is non-zero, up to `prefetch` morphologies are loaded ahead by
+a background thread, while the current one is being processed.
+
 The iterable returned by `Collection.load_unordered` should only be used while
 `collection` is valid, e.g. within its context or before calling
 `Collection.close`.
 
+Note: This API is 'experimental', meaning it might change in the future.
+)")
+        .def(
+            "load_parallel",
+            [](morphio::Collection* collection,
+               std::vector<std::string> morphology_names,
+               unsigned int options,
+               bool is_mutable,
+               size_t n_threads,
+               std::shared_ptr<morphio::WarningHandler> warning_handler) -> py::object {
+                if (is_mutable) {
+                    return py::cast(collection->load_parallel<morphio::mut::Morphology>(
+                        morphology_names, options, n_threads, warning_handler));
+                } else {
+                    return py::cast(collection->load_parallel<morphio::Morphology>(
+                        morphology_names, options, n_threads, warning_handler));
+                }
+            },
+            "morphology_names"_a,
+            "options"_a = morphio::enums::Option::NO_MODIFIER,
+            "mutable"_a = false,
+            "n_threads"_a = 0,
+            "warning_handler"_a = std::shared_ptr<morphio::WarningHandler>(nullptr),
+            R"(Create an iterable of loop index and morphology, loaded by `n_threads` threads.
+
+Loops such as the following
+
+    for k, morph_name in enumerate(morphology_names):
+        morph = collection.load(morphology_names[k])
+        f(k, morph)
+
+can be replaced with
+
+    for k, morph in collection.load_parallel(morphology_names):
+      f(k, morph)
+
+The morphologies are returned in the order in which they finished loading;
+`k` is the index of the morphology in `morphology_names`. If `n_threads` is 0,
+the number of hardware threads is used.
+
 Note: This API is 'experimental', meaning it might change in the future.
 )")
 
@@ -252,6 +462,12 @@ Note: This API is 'experimental', meaning it might change in the future.
              "morphology_names"_a,
              R"(Argsort `morphology_names` by optimal access order.
 
+Note: This API is 'experimental', meaning it might change in the future.
+)")
+        .def("index_stats",
+             &morphio::Collection::index_stats,
+             R"(Statistics about the sidecar index of the container.
+
 Note: This API is 'experimental', meaning it might change in the future.
 )")
         .def("__enter__", [](morphio::Collection* collection) { return collection; })
@@ -262,25 +478,12 @@ Note: This API is 'experimental', meaning it might change in the future.
                 const py::object&) { collection->close(); })
         .def("close", &morphio::Collection::close);
 
-    py::class_<morphio::LoadUnordered<morphio::Morphology>>(
-        m, "LoadImmutableUnordered", "An iterable of immutable morphologies.")
-        .def(
-            "__iter__",
-            [](const morphio::LoadUnordered<morphio::Morphology>& iterable) {
-                return py::make_iterator(iterable.begin(), iterable.end());
-            },
-            // Bind the lifetime of the `morphio::LoadUnordered` (1) to the
-            // lifetime of the returned iterator (0).
-            py::keep_alive<0, 1>());
-
-    py::class_<morphio::LoadUnordered<morphio::mut::Morphology>>(
-        m, "LoadMutableUnordered", "An iterable of mutable morphologies.")
-        .def(
-            "__iter__",
-            [](const morphio::LoadUnordered<morphio::mut::Morphology>& iterable) {
-                return py::make_iterator(iterable.begin(), iterable.end());
-            },
-            // Bind the lifetime of the `morphio::LoadUnordered` (1) to the
-            // lifetime of the returned iterator (0).
-            py::keep_alive<0, 1>());
+    bind_load_iterable<morphio::LoadUnordered<morphio::Morphology>>(
+        m, "LoadImmutableUnordered", "An iterable of immutable morphologies.");
+    bind_load_iterable<morphio::LoadUnordered<morphio::mut::Morphology>>(
+        m, "LoadMutableUnordered", "An iterable of mutable morphologies.");
+    bind_load_iterable<morphio::LoadParallel<morphio::Morphology>>(
+        m, "LoadImmutableParallel", "An iterable of immutable morphologies loaded in parallel.");
+    bind_load_iterable<morphio::LoadParallel<morphio::mut::Morphology>>(
+        m, "LoadMutableParallel", "An iterable of mutable morphologies loaded in parallel.");
 }
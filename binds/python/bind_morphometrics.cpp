@@ -0,0 +1,69 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "bind_morphometrics.h"
+
+#include <pybind11/numpy.h>
+#include <pybind11/pybind11.h>
+
+#include <morphio/morphology.h>
+#include <morphio/morphometrics.h>
+
+#include "bindings_utils.h"
+
+namespace py = pybind11;
+using namespace py::literals;
+
+void bind_morphometrics(py::module& m) {
+    using morphio::Morphology;
+    namespace morphometrics = morphio::morphometrics;
+
+    m.def(
+        "segment_lengths",
+        [](const Morphology& morph) { return as_pyarray(morphometrics::segmentLengths(morph)); },
+        "morphology"_a,
+        R"(Return the length of every segment, as one value per point.
+
+The value of point `i` is the length of the segment between point `i` and point
+`i + 1`; it is 0 for the last point of each section.)");
+
+    m.def(
+        "segment_volumes",
+        [](const Morphology& morph) { return as_pyarray(morphometrics::segmentVolumes(morph)); },
+        "morphology"_a,
+        "Return the volume of every segment, seen as a frustum of cone, as one value per point");
+
+    m.def(
+        "segment_lateral_areas",
+        [](const Morphology& morph) {
+            return as_pyarray(morphometrics::segmentLateralAreas(morph));
+        },
+        "morphology"_a,
+        "Return the lateral area of every segment, seen as a frustum of cone, as one value per "
+        "point");
+
+    m.def(
+        "section_path_distances",
+        [](const Morphology& morph) {
+            return as_pyarray(morphometrics::sectionPathDistances(morph));
+        },
+        "morphology"_a,
+        "Return the path distance between the start of the neurite and the end of every section");
+
+    m.def(
+        "radial_distances",
+        [](const Morphology& morph) { return as_pyarray(morphometrics::radialDistances(morph)); },
+        "morphology"_a,
+        "Return the distance between every neurite point and the soma center");
+
+    m.def(
+        "bounding_box",
+        [](const Morphology& morph) {
+            // copied by numpy, as the array is not given a base
+            const auto box = morphometrics::boundingBox(morph);
+            return span_array_to_ndarray(morphio::range<const morphio::Point>(box));
+        },
+        "morphology"_a,
+        "Return the bounding box of the neurite points, as [minimum corner, maximum corner]");
+}
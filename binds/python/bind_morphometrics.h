@@ -0,0 +1,9 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <pybind11/pybind11.h>
+
+void bind_morphometrics(pybind11::module&);
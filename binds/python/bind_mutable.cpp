@@ -123,6 +123,13 @@ void bind_mut_morphology(py::module& m) {
         .def("remove_unifurcations",
              &morphio::mut::Morphology::removeUnifurcations,
              D(removeUnifurcations))
+        .def("transform",
+             &morphio::mut::Morphology::transform,
+             "Applies the affine transform to the points of the sections, the soma and the "
+             "markers, in place\n"
+             "The transform is given as the first 3 rows of its 4x4 matrix, and is expected "
+             "to be rigid: diameters are not scaled",
+             "transform"_a)
         .def(
             "write",
             [](Morphology* morph, py::object arg) { morph->write(py::str(arg)); },
@@ -373,7 +373,7 @@ successively)doc";
 static const char *mkd_doc_morphio_Morphology_depth_end = R"doc(depth end iterator)doc";
 
 static const char *mkd_doc_morphio_Morphology_diameters =
-R"doc(Return a vector with all diameters from all sections (soma points are
+R"doc(Return a range over all diameters from all sections (soma points are
 not included))doc";
 
 static const char *mkd_doc_morphio_Morphology_endoplasmicReticulum = R"doc(Return the endoplasmic reticulum object)doc";
@@ -388,10 +388,10 @@ static const char *mkd_doc_morphio_Morphology_operator_assign = R"doc()doc";
 
 static const char *mkd_doc_morphio_Morphology_operator_assign_2 = R"doc()doc";
 
-static const char *mkd_doc_morphio_Morphology_perimeters = R"doc(Return a vector with all perimeters from all sections)doc";
+static const char *mkd_doc_morphio_Morphology_perimeters = R"doc(Return a range over all perimeters from all sections)doc";
 
 static const char *mkd_doc_morphio_Morphology_points =
-R"doc(Return a vector with all points from all sections (soma points are not
+R"doc(Return a range over all points from all sections (soma points are not
 included))doc";
 
 static const char *mkd_doc_morphio_Morphology_properties = R"doc()doc";
@@ -415,7 +415,7 @@ diameters[sectionOffsets(n+1)-1]
 Note: for convenience, the last point of this array is the points()
 array size so that the above example works also for the last section.)doc";
 
-static const char *mkd_doc_morphio_Morphology_sectionTypes = R"doc(Return a vector with the section type of every section)doc";
+static const char *mkd_doc_morphio_Morphology_sectionTypes = R"doc(Return a range over the section type of every section)doc";
 
 static const char *mkd_doc_morphio_Morphology_sections =
 R"doc(Return a vector containing all section objects
@@ -7,6 +7,7 @@
 #include "bind_enums.h"
 #include "bind_immutable.h"
 #include "bind_misc.h"
+#include "bind_morphometrics.h"
 #include "bind_mutable.h"
 #include "bind_vasculature.h"
 #include "bind_warnings_exceptions.h"
@@ -30,6 +31,9 @@ PYBIND11_MODULE(_morphio, m) {
     py::module mut_module = m.def_submodule("mut");
     bind_mutable(mut_module);
 
+    py::module morphometrics_module = m.def_submodule("morphometrics");
+    bind_morphometrics(morphometrics_module);
+
     py::module vasc_module = m.def_submodule("vasculature");
     bind_vasculature(vasc_module);
 }
@@ -17,6 +17,12 @@ class CollectionImpl;
 template <class M>
 class LoadUnordered;
 
+template <class M>
+class LoadParallel;
+
+template <class M>
+class LoadParallelImpl;
+
 /**
  * Enable if `T` is a immutable morphology.
  */
@@ -29,6 +35,61 @@ struct enable_if_immutable: public std::enable_if<std::is_same<T, Morphology>::v
 template <class T, class U = void>
 struct enable_if_mutable: public std::enable_if<std::is_same<T, mut::Morphology>::value, U> {};
 
+/**
+ * Statistics about the sidecar index of a container.
+ *
+ * See `write_container_index`.
+ */
+struct CollectionIndexStats {
+    /// Was an index found next to the container?
+    bool found = false;
+    /// Was the index ignored, because the container changed or it's unreadable?
+    bool stale = false;
+    /// Number of morphologies in the index.
+    size_t size = 0;
+    /// Time spent reading the index, in seconds.
+    double load_time = 0.0;
+
+    /// Number of lookups by name, and how many of them found the morphology.
+    size_t n_lookups = 0;
+    size_t n_hits = 0;
+    /// Time spent in lookups, in seconds.
+    double lookup_time = 0.0;
+};
+
+/**
+ * Write the sidecar index of the container at `container_path`.
+ *
+ * The index stores where the datasets of every morphology are located in the
+ * file. If it exists and is up to date, `Collection` uses it to find the
+ * morphologies without traversing the HDF5 groups. The index is stored in
+ * `container_path + ".index"`; it needs to be written again whenever the
+ * container is modified, otherwise it's ignored.
+ *
+ * Returns the time, in seconds, taken to build and write the index.
+ *
+ * Note: This API is 'experimental', meaning it might change in the future.
+ */
+double write_container_index(const std::string& container_path);
+
+/**
+ * Pack all morphologies of the collection at `collection_path` into a single
+ * file at `output_path`.
+ *
+ * The collection can be a directory, in which case the morphologies are all
+ * files with one of `extensions`, an HDF5 container or another packed
+ * container. The packed container stores the morphologies back to back in a
+ * compact binary format, behind a table of contents. `Collection` maps it into
+ * memory, such that loading a morphology neither requires a system call nor the
+ * HDF5 lock.
+ *
+ * Note: This API is 'experimental', meaning it might change in the future.
+ */
+void pack_collection(const std::string& collection_path,
+                     const std::string& output_path,
+                     const std::vector<std::string>& extensions =
+                         std::vector<std::string>{".h5", ".H5", ".asc", ".ASC", ".swc", ".SWC"});
+
 class Collection
 {
   public:
@@ -38,8 +99,10 @@ class Collection
      * Create a collection from the given path.
      *
      * If `collection_path` points to an HDF5 file, then that file
-     * must be a container. Otherwise the `collection_path` should
-     * point to the directory containing the morphology files.
+     * must be a container. If it points to a packed container (see
+     * `pack_collection`), the morphologies are loaded from a memory mapping of
+     * the file. Otherwise the `collection_path` should point to the directory
+     * containing the morphology files.
      *
      * If the collection path is a directory, the extension of the morphology
      * file must be guessed. The optional argument `extensions` specifies which
@@ -70,12 +133,30 @@ class Collection
     /**
      * Returns an iterable of loop index, morphology pairs.
      *
+     * If `prefetch` is non-zero, a background thread loads up to `prefetch`
+     * morphologies ahead of the one currently being dereferenced.
+     *
      * See `LoadUnordered` for details.
      */
     template <class M>
-    LoadUnordered<M> load_unordered(
+    LoadUnordered<M> load_unordered(std::vector<std::string> morphology_names,
+                                    unsigned int options = NO_MODIFIER,
+                                    std::shared_ptr<WarningHandler> warning_handler = nullptr,
+                                    size_t prefetch = 0) const;
+
+    /**
+     * Returns an iterable of loop index, morphology pairs, loaded concurrently
+     * by a pool of `n_threads` worker threads.
+     *
+     * If `n_threads` is `0`, the number of hardware threads is used.
+     *
+     * See `LoadParallel` for details.
+     */
+    template <class M>
+    LoadParallel<M> load_parallel(
         std::vector<std::string> morphology_names,
         unsigned int options = NO_MODIFIER,
+        size_t n_threads = 0,
         std::shared_ptr<WarningHandler> warning_handler = nullptr) const;
 
     /**
@@ -88,6 +169,15 @@ class Collection
      */
     std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const;
 
+    /**
+     * Returns statistics about the sidecar index of the container.
+     *
+     * For collections without an index, all fields are zero.
+     *
+     * Note: This API is 'experimental', meaning it might change in the future.
+     */
+    CollectionIndexStats index_stats() const;
+
     /**
      * Close the collection.
      *
@@ -175,6 +265,76 @@ class LoadUnordered
     std::shared_ptr<LoadUnorderedImpl> _load_unordered_impl;
 };
 
+/**
+ * An iterable of loop index and morphologies, loaded by a pool of threads.
+ *
+ * The worker threads are started on construction and load the morphologies in
+ * the order suggested by `Collection::argsort`. The pairs are returned in the
+ * order in which the workers finish loading them. At most a bounded number of
+ * morphologies, proportional to the number of threads, are loaded but not yet
+ * consumed at any given time.
+ *
+ * Loops such as
+ *
+ *     for(size_t k = 0; k < morphology_names.size; ++k) {
+ *       auto morph = collection.load<M>(morphology_names[k]);
+ *       f(k, morph);
+ *     }
+ *
+ * can be replaced with
+ *
+ *     for(auto [k, morph] : collection.load_parallel<M>(morphology_names)) {
+ *       f(k, morph);
+ *     }
+ *
+ * where `k` is the index of the morphology in `morphology_names`.
+ *
+ * Unlike `LoadUnordered`, dereferencing an iterator consumes the next loaded
+ * morphology. Therefore, each iterator should be dereferenced exactly once. If
+ * loading a morphology failed, the exception is rethrown when its pair would
+ * have been returned.
+ *
+ * The warning handler is shared by all workers and is therefore wrapped such
+ * that only one thread at a time emits warnings.
+ *
+ * It is safe for a `LoadParallel` object to outlive its `collection`.
+ * Destroying it stops the workers once they have finished their current
+ * morphology.
+ *
+ * Note: This API is 'experimental', meaning it might change in the future.
+ */
+template <class M>
+class LoadParallel
+{
+  protected:
+    class Iterator
+    {
+      public:
+        Iterator(std::shared_ptr<LoadParallelImpl<M>> load_parallel_impl, size_t k);
+
+        std::pair<size_t, M> operator*() const;
+
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        bool operator==(const Iterator& other) const;
+        bool operator!=(const Iterator& other) const;
+
+      private:
+        size_t _k;
+        std::shared_ptr<LoadParallelImpl<M>> _load_parallel_impl;
+    };
+
+  public:
+    LoadParallel(std::shared_ptr<LoadParallelImpl<M>> load_parallel_impl);
+
+    Iterator begin() const;
+    Iterator end() const;
+
+  protected:
+    std::shared_ptr<LoadParallelImpl<M>> _load_parallel_impl;
+};
+
 extern template class LoadUnordered<Morphology>;
 extern template class LoadUnordered<mut::Morphology>;
 
@@ -201,11 +361,31 @@ Collection::load<Morphology>(const std::string& morph_name,
 extern template LoadUnordered<Morphology> Collection::load_unordered<Morphology>(
     std::vector<std::string> morphology_names,
     unsigned int options,
-    std::shared_ptr<WarningHandler> warning_handler) const;
+    std::shared_ptr<WarningHandler> warning_handler,
+    size_t prefetch) const;
 
 extern template LoadUnordered<mut::Morphology> Collection::load_unordered<mut::Morphology>(
     std::vector<std::string> morphology_names,
     unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler,
+    size_t prefetch) const;
+
+extern template class LoadParallel<Morphology>;
+extern template class LoadParallel<mut::Morphology>;
+
+extern template class LoadParallel<Morphology>::Iterator;
+extern template class LoadParallel<mut::Morphology>::Iterator;
+
+extern template LoadParallel<Morphology> Collection::load_parallel<Morphology>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    size_t n_threads,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+extern template LoadParallel<mut::Morphology> Collection::load_parallel<mut::Morphology>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    size_t n_threads,
     std::shared_ptr<WarningHandler> warning_handler) const;
 
 }  // namespace morphio
@@ -20,7 +20,8 @@ enum Option {
     SOMA_SPHERE = 0x02,          //!< Interpret morphology soma as a sphere
     NO_DUPLICATES = 0x04,        //!< Skip duplicating points
     NRN_ORDER = 0x08,            //!< Order of neurites will be the same as in NEURON simulator
-    ALLOW_UNIFURCATED_SECTION_CHANGE = 0x10  //!< Allow section type to change without bifurcation
+    ALLOW_UNIFURCATED_SECTION_CHANGE = 0x10,  //!< Allow section type to change without bifurcation
+    POINT_COLUMNS = 0x20  //!< Store the points as x, y, z and diameter columns
 };
 
 /**
@@ -57,6 +58,13 @@ enum CellFamily {
     SPINE = 2    //!< Spine
 };
 
+/** Order in which the sections of a morphology are listed. */
+enum class SectionOrder {
+    DEPTH_FIRST,    //!< Depth first pre-order, neurite after neurite
+    BREADTH_FIRST,  //!< Level by level, across all neurites
+    NEURON          //!< Depth first, with the neurites sorted by type like in the NEURON simulator
+};
+
 /** Soma type. */
 enum SomaType {
     SOMA_UNDEFINED = 0,                      //!< Undefined soma
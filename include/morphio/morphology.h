@@ -8,11 +8,26 @@
 
 #include <morphio/properties.h>
 #include <morphio/section_iterators.hpp>
+#include <morphio/transform.h>
 #include <morphio/types.h>
 #include <morphio/warning_handling.h>  // WarningHandler
 
 namespace morphio {
 
+namespace readers {
+namespace packed {
+class ContainerWriter;
+}  // namespace packed
+}  // namespace readers
+
+class SectionOrderIterator;
+
+// Specialized in section.h to walk a precomputed order of section IDs
+template <>
+class breadth_iterator_t<Section, Morphology>;
+template <>
+class depth_iterator_t<Section, Morphology>;
+
 /** Morphology breadth iterator */
 using breadth_iterator = breadth_iterator_t<Section, Morphology>;
 /** Morphology depth iterator */
@@ -63,6 +78,12 @@ class Morphology
                         unsigned int options = NO_MODIFIER,
                         std::shared_ptr<WarningHandler> = nullptr);
 
+    /** Constructor from already decoded properties, applying the modifiers of `options` */
+    Morphology(const Property::Properties& properties, unsigned int options);
+
+    /** Same as above, but takes over the arrays of `properties` instead of copying them */
+    Morphology(Property::Properties&& properties, unsigned int options);
+
     /** Return the soma object */
     Soma soma() const;
 
@@ -99,10 +120,10 @@ class Morphology
     Section section(uint32_t id) const;
 
     /**
-     * Return a vector with all points from all sections
+     * Return a range over all points from all sections
      * (soma points are not included)
      **/
-    const Points& points() const noexcept;
+    range<const Point> points() const;
 
     /**
      * Returns a list with offsets to access data of a specific section in the points
@@ -117,23 +138,115 @@ class Morphology
     std::vector<uint32_t> sectionOffsets() const;
 
     /**
-     * Return a vector with all diameters from all sections
+     * Return a range over all diameters from all sections
      * (soma points are not included)
      **/
-    const std::vector<morphio::floatType>& diameters() const;
+    range<const morphio::floatType> diameters() const;
 
-    /** Return a vector with all perimeters from all sections */
-    const std::vector<morphio::floatType>& perimeters() const;
+    /** Return a range over all perimeters from all sections */
+    range<const morphio::floatType> perimeters() const;
 
-    /** Return a vector with the section type of every section */
-    const std::vector<SectionType>& sectionTypes() const;
+    /**
+     * Return the points and diameters as separate x, y, z and diameter columns
+     *
+     * The columns are views of the morphology's arrays, valid as long as this
+     * morphology or one of its copies is alive. They are contiguous if the
+     * morphology was loaded with the POINT_COLUMNS option, strided otherwise.
+     **/
+    Property::PointColumns pointColumns() const;
+
+    /** Return a range over the section type of every section */
+    range<const SectionType> sectionTypes() const;
 
     /**
      * Return the graph connectivity of the morphology where each section
      * is seen as a node
      * Note: -1 is the soma node
+     *
+     * The map is built on each call, use childrenIds() when traversing.
+     **/
+    std::map<int, std::vector<unsigned int>> connectivity() const;
+
+    /**
+     * Return the IDs of the children of section `sectionId`, in increasing order
+     * Note: -1 is the soma node, its children are the root sections
+     **/
+    range<const uint32_t> childrenIds(int32_t sectionId) const noexcept;
+
+    /**
+     * Return the IDs of all sections, in the given order
+     *
+     * This is what the depth and breadth iterators walk; looping over the IDs
+     * directly does not allocate nor touch reference counts at each step.
+     **/
+    std::vector<uint32_t> sectionOrder(SectionOrder order = SectionOrder::DEPTH_FIRST) const;
+
+    /**
+     * @name Cached topology
+     *
+     * Computed on first use and shared by the copies of this morphology.
+     * Children are visited in increasing order of their IDs.
+     **/
+    ///@{
+
+    /** Return the IDs of all sections, in depth first pre-order */
+    range<const uint32_t> depthFirstOrder() const;
+
+    /** Return the IDs of all sections, level by level across all neurites */
+    range<const uint32_t> breadthFirstOrder() const;
+
+    /**
+     * Return the IDs of all sections, each one after all its children
+     *
+     * Bottom-up reductions, like the length of each subtree, are a single
+     * loop over this order.
      **/
-    const std::map<int, std::vector<unsigned int>>& connectivity() const;
+    range<const uint32_t> postOrder() const;
+
+    /** Return the branch order of every section, indexed by ID (0 for root sections) */
+    range<const uint32_t> sectionDepths() const;
+
+    /** Return the number of sections in the subtree of every section, itself included */
+    range<const uint32_t> subtreeSizes() const;
+    ///@}
+
+    /**
+     * @name Section aggregates
+     *
+     * Indexed by section ID; computed on first use and shared by the copies of
+     * this morphology and its sections. Areas and volumes are the ones of the
+     * frustums of cone between consecutive points.
+     **/
+    ///@{
+
+    /** Return the length of every section */
+    range<const floatType> sectionLengths() const;
+
+    /** Return the lateral area of every section */
+    range<const floatType> sectionAreas() const;
+
+    /** Return the volume of every section */
+    range<const floatType> sectionVolumes() const;
+
+    /** Return the bounding box of every section, as (minimum, maximum corner) */
+    range<const std::array<Point, 2>> sectionBoundingBoxes() const;
+    ///@}
+
+    /**
+     * Return the spatial index of the segments, for nearest, radius, box and ray queries
+     *
+     * Built on the first call and shared by the copies of this morphology.
+     **/
+    const SpatialIndex& spatialIndex() const;
+
+    /**
+     * Return a copy of this morphology with `transform` applied to its points
+     *
+     * The points of the sections, the soma and the markers are transformed in
+     * the same pass that copies them. Diameters are left as they are; the
+     * transform is expected to be rigid.
+     **/
+    Morphology transformed(const AffineTransform& transform) const;
 
     /**
        Depth first iterator starting at a given section id
@@ -164,12 +277,24 @@ class Morphology
     const MorphologyVersion& version() const;
 
   protected:
+    friend class mut::FlatMorphology;
     friend class mut::Morphology;
-    Morphology(const Property::Properties& properties, unsigned int options);
+    friend class readers::packed::ContainerWriter;
+    friend class SectionOrderIterator;
 
     std::shared_ptr<Property::Properties> properties_;
 
     template <typename Property>
-    const std::vector<typename Property::Type>& get() const;
+    range<const typename Property::Type> get() const;
 };
+
+/**
+ * Set the maximum number of threads reading a large SWC file; 0, the default,
+ * for one per hardware thread, 1 to read on the calling thread only
+ *
+ * The threads of Collection::load_parallel, and the one of
+ * Collection::load_unordered when it prefetches, always read the files they
+ * load on their own.
+ */
+void set_maximum_swc_threads(unsigned int n_threads);
 }  // namespace morphio
@@ -0,0 +1,91 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <morphio/types.h>
+
+namespace morphio {
+/**
+ * Morphometrics computed over the flat point and diameter arrays of a morphology.
+ *
+ * The kernels take the arrays returned by Morphology::points(),
+ * Morphology::diameters() and Morphology::sectionOffsets(), and loop over them
+ * without creating any Section object.
+ *
+ * The per segment arrays have one value per point: the value of the segment
+ * between point `i` and point `i + 1`. The last point of each section does not
+ * start a segment, its value is 0. The segments of section `s` are therefore
+ * `sectionOffsets[s]` up to `sectionOffsets[s + 1] - 1` (excluded).
+ *
+ * Per section values are the `sectionSums` of the per segment ones. The
+ * lengths, areas and volumes of the sections of a Morphology are cached by
+ * Morphology::sectionLengths(), sectionAreas() and sectionVolumes().
+ */
+namespace morphometrics {
+
+/** Axis aligned bounding box, as (minimum corner, maximum corner) */
+using BoundingBox = std::array<Point, 2>;
+
+/** Return the length of every segment */
+std::vector<floatType> segmentLengths(range<const Point> points,
+                                      range<const uint32_t> sectionOffsets);
+
+/**
+ * Return the volume of every segment, seen as a frustum of cone
+ *
+ * Throws std::invalid_argument if there isn't one diameter per point.
+ */
+std::vector<floatType> segmentVolumes(range<const Point> points,
+                                      range<const floatType> diameters,
+                                      range<const uint32_t> sectionOffsets);
+
+/**
+ * Return the lateral surface area of every segment, seen as a frustum of cone
+ *
+ * Throws std::invalid_argument if there isn't one diameter per point.
+ */
+std::vector<floatType> segmentLateralAreas(range<const Point> points,
+                                           range<const floatType> diameters,
+                                           range<const uint32_t> sectionOffsets);
+
+/** Return the sum, for every section, of the segment values of the section */
+std::vector<floatType> sectionSums(range<const floatType> segmentValues,
+                                   range<const uint32_t> sectionOffsets);
+
+/** Return the distance between every point and `origin` */
+std::vector<floatType> radialDistances(range<const Point> points, const Point& origin);
+
+/**
+ * Return the bounding box of `points`
+ *
+ * Both corners are (0, 0, 0) when there are no points.
+ */
+BoundingBox boundingBox(range<const Point> points);
+
+/** Same as above, over the neurites of `morphology` */
+std::vector<floatType> segmentLengths(const Morphology& morphology);
+std::vector<floatType> segmentVolumes(const Morphology& morphology);
+std::vector<floatType> segmentLateralAreas(const Morphology& morphology);
+BoundingBox boundingBox(const Morphology& morphology);
+
+/**
+ * Return the distance between every neurite point and the soma center
+ *
+ * The origin is used when the morphology has no soma points.
+ */
+std::vector<floatType> radialDistances(const Morphology& morphology);
+
+/**
+ * Return the path distance between the start of the neurite and the end of every section
+ *
+ * Sections that are not reachable from a root section have a path distance of 0.
+ */
+std::vector<floatType> sectionPathDistances(const Morphology& morphology);
+
+}  // namespace morphometrics
+}  // namespace morphio
@@ -0,0 +1,255 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint32_t
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <morphio/mut/soma.h>
+#include <morphio/properties.h>
+#include <morphio/types.h>
+#include <morphio/warning_handling.h>
+
+namespace morphio {
+namespace mut {
+
+/**
+ * A section of a FlatMorphology: the slot holding it, and the generation of the slot.
+ *
+ * Deleting a section bumps the generation of its slot, which turns the handles
+ * to it stale; the slot is then reused by the next appended section.
+ */
+struct SectionHandle {
+    static constexpr uint32_t invalidIndex = 0xffffffff;
+
+    uint32_t index = invalidIndex;
+    uint32_t generation = 0;
+
+    bool operator==(const SectionHandle& other) const noexcept {
+        return index == other.index && generation == other.generation;
+    }
+    bool operator!=(const SectionHandle& other) const noexcept {
+        return !(*this == other);
+    }
+};
+
+/**
+ * A mutable morphology stored in flat arrays.
+ *
+ * An alternative to mut::Morphology for building, editing and exporting large
+ * trees. Sections live in a slot map addressed by SectionHandle, their points,
+ * diameters and perimeters in large chunks shared by many sections, and their
+ * children in lists linked through the slots. Appending and deleting sections
+ * take amortized constant time, and buildReadOnly is linear in the number of
+ * points.
+ *
+ * The ranges returned by `points`, `diameters` and `perimeters` are views into
+ * a chunk: they are invalidated by any operation that changes the number of
+ * points of a section. Perimeters are either given for all sections or for
+ * none.
+ *
+ * Mitochondria, endoplasmic reticulum and dendritic spine data of the
+ * morphology it's built from are carried over to buildReadOnly as they are.
+ */
+class FlatMorphology
+{
+  public:
+    explicit FlatMorphology(std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /**
+     * Copy `morphology`, then apply the modifiers of `options`
+     *
+     * Sections are appended in depth first order, like mut::Morphology does.
+     */
+    explicit FlatMorphology(const morphio::Morphology& morphology,
+                            unsigned int options = NO_MODIFIER,
+                            std::shared_ptr<WarningHandler> warning_handler = nullptr);
+
+    /** The number of sections */
+    size_t size() const noexcept {
+        return _slots.size() - _freeSlots.size();
+    }
+
+    /** Return true if `section` refers to a section that has not been deleted */
+    bool contains(SectionHandle section) const noexcept;
+
+    /**
+     * The ID of `section` in warnings and annotations
+     *
+     * Like mut::Morphology, sections are numbered in the order they are appended,
+     * and the IDs are not reused.
+     */
+    uint32_t id(SectionHandle section) const;
+
+    /** @name Topology
+     *
+     * The functions taking a handle throw SectionBuilderError if it's stale.
+     */
+    ///@{
+    const std::vector<SectionHandle>& rootSections() const noexcept {
+        return _rootSections;
+    }
+    std::vector<SectionHandle> children(SectionHandle section) const;
+
+    /** The parent of `section`, an invalid handle for root sections */
+    SectionHandle parent(SectionHandle section) const;
+    bool isRoot(SectionHandle section) const;
+    ///@}
+
+    /** @name Section data */
+    ///@{
+    SectionType type(SectionHandle section) const;
+    void setType(SectionHandle section, SectionType type);
+
+    range<Point> points(SectionHandle section);
+    range<const Point> points(SectionHandle section) const;
+    range<floatType> diameters(SectionHandle section);
+    range<const floatType> diameters(SectionHandle section) const;
+    range<floatType> perimeters(SectionHandle section);
+    range<const floatType> perimeters(SectionHandle section) const;
+
+    /** Replace the points, diameters and perimeters of `section` */
+    void setPoints(SectionHandle section, const Property::PointLevel& points);
+    ///@}
+
+    /** @name Edition */
+    ///@{
+    SectionHandle appendRootSection(const Property::PointLevel& points, SectionType type);
+
+    /** Append a child to `parent`, of the same type as `parent` if `type` is undefined */
+    SectionHandle appendSection(SectionHandle parent,
+                                const Property::PointLevel& points,
+                                SectionType type = SECTION_UNDEFINED);
+
+    /**
+     * Delete `section`, and all its descendants if `recursive`
+     *
+     * Otherwise, the children of `section` take its place among the children of its parent.
+     */
+    void deleteSection(SectionHandle section, bool recursive = true);
+
+    /** Merge the sections that are the only child of their parent into it, see mut::Morphology */
+    void removeUnifurcations();
+
+    /** Apply the modifiers of `modifierFlags`, see mut::Morphology */
+    void applyModifiers(unsigned int modifierFlags);
+    ///@}
+
+    Soma& soma() noexcept {
+        return _soma;
+    }
+    const Soma& soma() const noexcept {
+        return _soma;
+    }
+
+    const std::vector<Property::Annotation>& annotations() const noexcept {
+        return _cellLevel._annotations;
+    }
+
+    /**
+     * Return the data structure used to create read-only morphologies
+     *
+     * Sections are written in depth first order.
+     */
+    Property::Properties buildReadOnly() const;
+
+    std::shared_ptr<WarningHandler> getWarningHandler() const {
+        return _handler;
+    }
+
+  private:
+    // A range of points of a chunk
+    struct Extent {
+        uint32_t chunk = 0;
+        uint32_t begin = 0;
+        uint32_t size = 0;
+    };
+
+    struct Chunk {
+        std::vector<Point> points;
+        std::vector<floatType> diameters;
+        std::vector<floatType> perimeters;  // empty if the morphology has no perimeters
+        uint32_t used = 0;
+    };
+
+    struct Slot {
+        uint32_t generation = 0;
+        uint32_t id = 0;
+        bool live = false;
+        SectionType type = SECTION_UNDEFINED;
+        SectionHandle parent;
+        // The slots of the first and last children, and of the previous and next
+        // children of the parent; root sections are listed in _rootSections instead
+        uint32_t firstChild = SectionHandle::invalidIndex;
+        uint32_t lastChild = SectionHandle::invalidIndex;
+        uint32_t previousSibling = SectionHandle::invalidIndex;
+        uint32_t nextSibling = SectionHandle::invalidIndex;
+        Extent extent;
+    };
+
+    const Slot& slot(SectionHandle section) const;
+    Slot& slot(SectionHandle section);
+
+    SectionHandle handle(uint32_t index) const noexcept {
+        return {index, _slots[index].generation};
+    }
+
+    /** Append the section of slot `child` to the children of slot `parent` */
+    void linkChild(uint32_t parent, uint32_t child);
+
+    /** Remove the section of slot `index` from the children of its parent */
+    void unlink(uint32_t index);
+
+    /** Push the children of slot `index` to `stack`, last child first */
+    void pushChildren(std::vector<SectionHandle>& stack, uint32_t index) const;
+
+    /** Check the sizes of `points`, and that it has perimeters like the other sections */
+    void checkPointLevel(const Property::PointLevel& points);
+
+    SectionHandle newSection(SectionHandle parent,
+                             const Property::PointLevel& points,
+                             SectionType type);
+    void freeSlot(uint32_t index);
+
+    /** Reserve `size` contiguous points */
+    Extent allocate(uint32_t size);
+    void store(Extent& extent, const Property::PointLevel& points);
+    void copy(const Extent& from, const Extent& to);
+    void release(const Extent& extent);
+
+    /** Compact the chunks once they hold more released than live points */
+    void reclaim();
+
+    /** Copy the points of all sections to new chunks, in depth first order */
+    void compact();
+
+    /** The sections, depth first */
+    std::vector<SectionHandle> depthFirstOrder() const;
+
+    std::vector<Slot> _slots;
+    std::vector<uint32_t> _freeSlots;
+    std::vector<SectionHandle> _rootSections;
+    uint32_t _counter = 0;
+
+    std::vector<Chunk> _chunks;
+    bool _hasPerimeters = false;
+    size_t _livePoints = 0;
+    size_t _garbagePoints = 0;
+
+    Soma _soma;
+    Property::CellLevel _cellLevel;
+    Property::MitochondriaPointLevel _mitochondriaPointLevel;
+    Property::MitochondriaSectionLevel _mitochondriaSectionLevel;
+    Property::EndoplasmicReticulumLevel _endoplasmicReticulumLevel;
+    Property::DendriticSpine::Level _dendriticSpineLevel;
+
+    std::shared_ptr<WarningHandler> _handler;
+    std::string _uri;
+};
+
+}  // namespace mut
+}  // namespace morphio
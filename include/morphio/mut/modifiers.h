@@ -8,6 +8,7 @@ namespace morphio {
 namespace mut {
 
 class Morphology;
+class Soma;
 
 namespace modifiers {
 /**
@@ -27,6 +28,9 @@ void no_duplicate_point(morphio::mut::Morphology& morpho);
 **/
 void soma_sphere(morphio::mut::Morphology& morpho);
 
+/** Same as above, on the soma alone */
+void soma_sphere(morphio::mut::Soma& soma);
+
 /** Reorders neurites of morphology according to NEURON simulator */
 void nrn_order(morphio::mut::Morphology& morpho);
 
@@ -18,6 +18,7 @@
 #include <morphio/mut/section.h>
 #include <morphio/mut/soma.h>
 #include <morphio/properties.h>
+#include <morphio/transform.h>
 #include <morphio/types.h>
 #include <morphio/warning_handling.h>
 
@@ -182,6 +183,13 @@ class Morphology
 
     void applyModifiers(unsigned int modifierFlags);
 
+    /**
+     * Apply `transform` to the points of the sections, the soma and the markers
+     *
+     * Diameters are left as they are; the transform is expected to be rigid.
+     */
+    void transform(const AffineTransform& transform);
+
     /// Return the soma type
     SomaType somaType() const noexcept {
         return _soma->type();
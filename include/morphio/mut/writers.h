@@ -26,6 +26,11 @@ void h5(const Morphology& morphology,
         const std::string& filename,
         std::shared_ptr<WarningHandler> handler);
 
+/** Save morphology in the compact binary format, which can be opened without parsing */
+void mbin(const Morphology& morphology,
+          const std::string& filename,
+          std::shared_ptr<WarningHandler> handler);
+
 }  // namespace writer
 }  // end namespace mut
 }  // end namespace morphio
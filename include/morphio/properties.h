@@ -4,6 +4,8 @@
 
 #include <array>
 #include <map>
+#include <memory>  // std::shared_ptr
+#include <mutex>
 #include <vector>
 
 #include <morphio/types.h>
@@ -11,6 +13,9 @@
 #include <morphio/version.h>
 
 namespace morphio {
+
+class SpatialIndex;
+
 /**
    The property namespace is the core of MorphIO as it is where all the
    internal data are stored. The higher level container structure is Property::Properties.
@@ -58,31 +63,306 @@ struct MitoNeuriteSectionId {
     using Type = uint32_t;
 };
 
-/** Information that is available at the point level (point coordinate, diameter, perimeter) */
+/**
+ * Keeps alive a read-only buffer that arrays are borrowed from, e.g. a memory
+ * mapping, shared memory, a numpy array or an arena block.
+ */
+using StorageOwner = std::shared_ptr<const void>;
+
+/**
+ * A value computed on first use and safe to query from several threads.
+ *
+ * Copies start empty, as the arrays the value is derived from may be modified.
+ */
+template <typename T>
+class LazyValue
+{
+  public:
+    LazyValue() = default;
+    LazyValue(const LazyValue& /*other*/) noexcept {}
+    LazyValue& operator=(const LazyValue& other) noexcept {
+        if (&other != this) {
+            const std::lock_guard<std::mutex> lock(_mutex);
+            _value.reset();
+        }
+        return *this;
+    }
+
+    /** The value, set to `compute()` by the first call */
+    template <typename Compute>
+    const T& get(const Compute& compute) const {
+        return *share(compute);
+    }
+
+    /** Like `get`, but the value stays alive as long as the returned pointer */
+    template <typename Compute>
+    std::shared_ptr<const T> share(const Compute& compute) const {
+        const std::lock_guard<std::mutex> lock(_mutex);
+        if (!_value) {
+            _value = std::make_shared<const T>(compute());
+        }
+        return _value;
+    }
+
+  private:
+    mutable std::mutex _mutex;
+    mutable std::shared_ptr<const T> _value;
+};
+
+/**
+ * Information that is available at the point level (point coordinate, diameter, perimeter)
+ *
+ * The arrays are either stored in the vectors, or borrowed from a buffer kept
+ * alive by `_owner` (see `borrow`). The points and diameters can also be stored
+ * as columns instead (see `storeColumns`). Read them with `points()`,
+ * `diameters()` and `perimeters()`, which work in all cases.
+ */
 struct PointLevel {
     std::vector<Point::Type> _points;
     std::vector<Diameter::Type> _diameters;
     std::vector<Perimeter::Type> _perimeters;
 
+    StorageOwner _owner;
+    range<const Point::Type> _borrowedPoints;
+    range<const Diameter::Type> _borrowedDiameters;
+    range<const Perimeter::Type> _borrowedPerimeters;
+
+    // The x, y, z and diameter columns, one after the other, if the points are
+    // stored as columns; `points()` then interleaves them on first use
+    std::vector<floatType> _columns;
+    LazyValue<std::vector<Point::Type>> _columnPoints;
+
     PointLevel() = default;
     PointLevel(std::vector<Point::Type> points,
                std::vector<Diameter::Type> diameters,
                std::vector<Perimeter::Type> perimeters = {});
-    PointLevel(const PointLevel& data);
+    PointLevel(const PointLevel& data) = default;
     PointLevel(const PointLevel& data, SectionRange range);
-    PointLevel& operator=(const PointLevel& other);
+    PointLevel& operator=(const PointLevel& other) = default;
+
+    /** Use arrays owned by `owner` instead of the vectors, without copying them */
+    void borrow(StorageOwner owner,
+                range<const Point::Type> points,
+                range<const Diameter::Type> diameters,
+                range<const Perimeter::Type> perimeters = {});
+
+    /**
+     * Store the points and diameters as the x, y, z and diameter columns `columns`
+     *
+     * Each column holds one value per point. The perimeters are left as they are.
+     */
+    void storeColumns(std::vector<floatType> columns);
+
+    /** Convert the current points and diameters to columns */
+    void storeColumns();
+
+    bool hasColumns() const noexcept {
+        return !_columns.empty();
+    }
+
+    /** Copy borrowed arrays and columns into the vectors, such that they can be modified */
+    void own();
+
+    range<const Point::Type> points() const {
+        if (hasColumns()) {
+            return pointsFromColumns();
+        }
+        return _owner ? _borrowedPoints : range<const Point::Type>(_points);
+    }
+    range<const Diameter::Type> diameters() const noexcept {
+        if (hasColumns()) {
+            const size_t size = _columns.size() / 4;
+            return {_columns.data() + 3 * size, size};
+        }
+        return _owner ? _borrowedDiameters : range<const Diameter::Type>(_diameters);
+    }
+    range<const Perimeter::Type> perimeters() const noexcept {
+        return _owner ? _borrowedPerimeters : range<const Perimeter::Type>(_perimeters);
+    }
+
+  private:
+    range<const Point::Type> pointsFromColumns() const;
+};
+
+/**
+ * One coordinate of a range of points, read in place.
+ *
+ * Consecutive values are `stride()` floats apart in memory, starting at `data()`.
+ */
+class PointColumn
+{
+  public:
+    PointColumn() = default;
+    PointColumn(const floatType* data, size_t size, size_t stride) noexcept
+        : _data(data)
+        , _size(size)
+        , _stride(stride) {}
+
+    floatType operator[](size_t i) const noexcept {
+        return _data[i * _stride];
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    bool empty() const noexcept {
+        return _size == 0;
+    }
+
+    const floatType* data() const noexcept {
+        return _data;
+    }
+
+    size_t stride() const noexcept {
+        return _stride;
+    }
+
+  private:
+    const floatType* _data = nullptr;
+    size_t _size = 0;
+    size_t _stride = 1;
+};
+
+/**
+ * The points of a `PointLevel` as separate x, y, z and diameter columns.
+ *
+ * The columns are views of the level's arrays, nothing is copied: contiguous
+ * if the level stores its points as columns, strided views of the interleaved
+ * points otherwise. They are valid as long as the level's storage is.
+ */
+struct PointColumns {
+    PointColumn _x;
+    PointColumn _y;
+    PointColumn _z;
+    range<const Diameter::Type> _diameters;
+
+    PointColumns() = default;
+    explicit PointColumns(const PointLevel& pointLevel);
+
+    bool empty() const noexcept {
+        return _x.empty();
+    }
+};
+
+/**
+ * The children of every section, in compressed sparse row format.
+ *
+ * The children of section `i` are `_children[_offsets[i + 1]]` up to
+ * `_children[_offsets[i + 2]]` (excluded), in increasing order; slot 0 holds
+ * the root sections, whose parent is -1.
+ */
+struct ChildrenIndex {
+    std::vector<uint32_t> _offsets;
+    std::vector<uint32_t> _children;
+
+    ChildrenIndex() = default;
+
+    /** Index the parents of `sections`, given as (offset, parent index) */
+    explicit ChildrenIndex(range<const std::array<int, 2>> sections);
+
+    /**
+     * Convert from a (parent, children) map, as used by older versions.
+     *
+     * Implicit, such that levels can still be initialized with a map.
+     */
+    ChildrenIndex(const std::map<int, std::vector<unsigned int>>& children);
+
+    /** The children of section `parent`, or the root sections if it is -1 */
+    range<const uint32_t> of(int32_t parent) const noexcept {
+        const auto slot = static_cast<size_t>(parent + 1);
+        if (parent < -1 || slot + 1 >= _offsets.size()) {
+            return {};
+        }
+        return {_children.data() + _offsets[slot], _offsets[slot + 1] - _offsets[slot]};
+    }
+
+    /** The (parent, children) map of the sections that have children */
+    std::map<int, std::vector<unsigned int>> toMap() const;
+
+    /**
+     * Append to `order` the subtrees rooted at `starts`, in depth first pre-order
+     *
+     * Children are visited in increasing order of their IDs.
+     */
+    void depthFirst(range<const uint32_t> starts, std::vector<uint32_t>& order) const;
+
+    /** Same as `depthFirst`, but level by level, across all the subtrees */
+    void breadthFirst(range<const uint32_t> starts, std::vector<uint32_t>& order) const;
+
+    bool operator==(const ChildrenIndex& other) const;
+    bool operator!=(const ChildrenIndex& other) const;
 };
 
-/** Information that is available at the section level (section type, parent section) */
+/**
+ * Orders and per section values derived from the topology of the sections.
+ *
+ * Children are visited in increasing order of their IDs. The per section
+ * arrays are indexed by section ID; sections that are not reachable from a
+ * root section are not part of the orders and have a depth and subtree size
+ * of 0.
+ */
+struct SectionTopology {
+    std::vector<uint32_t> _depthFirst;          // depth first pre-order
+    std::vector<uint32_t> _depthFirstPosition;  // position of each section in `_depthFirst`
+    std::vector<uint32_t> _breadthFirst;
+    std::vector<uint32_t> _postOrder;  // children before their parent
+    std::vector<uint32_t> _depths;     // 0 for root sections
+    std::vector<uint32_t> _subtreeSizes;
+
+    SectionTopology(const ChildrenIndex& children, size_t nSections);
+};
+
+/**
+ * Length, lateral area, volume and bounding box of every section, indexed by section ID.
+ *
+ * Areas and volumes are the ones of the frustums of cone between consecutive
+ * points. Sections without points have a bounding box of (0, 0, 0).
+ */
+struct SectionAggregates {
+    std::vector<floatType> _lengths;
+    std::vector<floatType> _areas;
+    std::vector<floatType> _volumes;
+    std::vector<std::array<Point::Type, 2>> _boundingBoxes;  // (minimum, maximum corner)
+
+    SectionAggregates(range<const Point::Type> points,
+                      range<const Diameter::Type> diameters,
+                      range<const Section::Type> sections);
+};
+
+/**
+ * Information that is available at the section level (section type, parent section)
+ *
+ * Like for `PointLevel`, the sections and their types can be borrowed.
+ */
 struct SectionLevel {
     std::vector<Section::Type> _sections;
     std::vector<SectionType::Type> _sectionTypes;
-    std::map<int, std::vector<unsigned int>> _children;
+    ChildrenIndex _children;
+
+    StorageOwner _owner = nullptr;
+    range<const Section::Type> _borrowedSections = {};
+    range<const SectionType::Type> _borrowedSectionTypes = {};
 
     bool operator==(const SectionLevel& other) const;
     bool operator!=(const SectionLevel& other) const;
 
     bool diff(const SectionLevel& other) const;
+
+    /** Use arrays owned by `owner` instead of the vectors, without copying them */
+    void borrow(StorageOwner owner,
+                range<const Section::Type> sections,
+                range<const SectionType::Type> sectionTypes);
+
+    /** Copy borrowed arrays into the vectors, such that they can be modified */
+    void own();
+
+    range<const Section::Type> sections() const noexcept {
+        return _owner ? _borrowedSections : range<const Section::Type>(_sections);
+    }
+    range<const SectionType::Type> sectionTypes() const noexcept {
+        return _owner ? _borrowedSectionTypes : range<const SectionType::Type>(_sectionTypes);
+    }
 };
 
 /**
@@ -111,7 +391,7 @@ struct MitochondriaPointLevel {
 /** Information that is available at the mitochondrial section level (parent section) */
 struct MitochondriaSectionLevel {
     std::vector<Section::Type> _sections;
-    std::map<int, std::vector<unsigned int>> _children;
+    ChildrenIndex _children;
 
     bool diff(const MitochondriaSectionLevel& other) const;
     bool operator==(const MitochondriaSectionLevel& other) const;
@@ -219,11 +499,16 @@ struct Properties {
 
     DendriticSpine::Level _dendriticSpineLevel;
 
+    LazyValue<SectionTopology> _sectionTopology;
+    LazyValue<SectionAggregates> _sectionAggregates;
+    LazyValue<SpatialIndex> _spatialIndex;
+
+    /** The vector storing `T`; borrowed arrays of its level are copied first */
     template <typename T>
-    std::vector<typename T::Type>& get_mut() noexcept;
+    std::vector<typename T::Type>& get_mut();
 
     template <typename T>
-    const std::vector<typename T::Type>& get() const noexcept;
+    range<const typename T::Type> get() const;
 
     const morphio::MorphologyVersion& version() const noexcept {
         return _cellLevel._version;
@@ -235,44 +520,64 @@ struct Properties {
         return _cellLevel._somaType;
     }
     template <typename T>
-    const std::map<int32_t, std::vector<uint32_t>>& children() const noexcept;
+    const ChildrenIndex& children() const noexcept;
+
+    /** The orders, depths and subtree sizes of the sections, computed on first use */
+    const SectionTopology& sectionTopology() const;
+    std::shared_ptr<const SectionTopology> sharedSectionTopology() const;
+
+    /** The length, area, volume and bounding box of the sections, computed on first use */
+    const SectionAggregates& sectionAggregates() const;
+
+    /** The spatial index of the segments, built on first use */
+    const SpatialIndex& spatialIndex() const;
 };
 
 
 std::ostream& operator<<(std::ostream& os, const Properties& properties);
 std::ostream& operator<<(std::ostream& os, const PointLevel& pointLevel);
 
-#define INSTANTIATE_TEMPLATE_GET(T, M)                                       \
-    template <>                                                              \
-    inline std::vector<T::Type>& Properties::get_mut<T>() noexcept {         \
-        return M;                                                            \
-    }                                                                        \
-    template <>                                                              \
-    inline const std::vector<T::Type>& Properties::get<T>() const noexcept { \
-        return M;                                                            \
+#define INSTANTIATE_TEMPLATE_GET(T, M)                                         \
+    template <>                                                                \
+    inline std::vector<T::Type>& Properties::get_mut<T>() {                    \
+        return M;                                                              \
+    }                                                                          \
+    template <>                                                                \
+    inline range<const T::Type> Properties::get<T>() const {                   \
+        return M;                                                              \
+    }
+
+#define INSTANTIATE_TEMPLATE_GET_BORROWABLE(T, LEVEL, M, VIEW)                 \
+    template <>                                                                \
+    inline std::vector<T::Type>& Properties::get_mut<T>() {                    \
+        LEVEL.own();                                                           \
+        return LEVEL.M;                                                        \
+    }                                                                          \
+    template <>                                                                \
+    inline range<const T::Type> Properties::get<T>() const {                   \
+        return LEVEL.VIEW();                                                   \
     }
 
-INSTANTIATE_TEMPLATE_GET(Point, _pointLevel._points)
-INSTANTIATE_TEMPLATE_GET(Perimeter, _pointLevel._perimeters)
-INSTANTIATE_TEMPLATE_GET(Diameter, _pointLevel._diameters)
+INSTANTIATE_TEMPLATE_GET_BORROWABLE(Point, _pointLevel, _points, points)
+INSTANTIATE_TEMPLATE_GET_BORROWABLE(Perimeter, _pointLevel, _perimeters, perimeters)
+INSTANTIATE_TEMPLATE_GET_BORROWABLE(Diameter, _pointLevel, _diameters, diameters)
 INSTANTIATE_TEMPLATE_GET(MitoSection, _mitochondriaSectionLevel._sections)
 INSTANTIATE_TEMPLATE_GET(MitoPathLength, _mitochondriaPointLevel._relativePathLengths)
 INSTANTIATE_TEMPLATE_GET(MitoNeuriteSectionId, _mitochondriaPointLevel._sectionIds)
 INSTANTIATE_TEMPLATE_GET(MitoDiameter, _mitochondriaPointLevel._diameters)
-INSTANTIATE_TEMPLATE_GET(Section, _sectionLevel._sections)
-INSTANTIATE_TEMPLATE_GET(SectionType, _sectionLevel._sectionTypes)
+INSTANTIATE_TEMPLATE_GET_BORROWABLE(Section, _sectionLevel, _sections, sections)
+INSTANTIATE_TEMPLATE_GET_BORROWABLE(SectionType, _sectionLevel, _sectionTypes, sectionTypes)
 
+#undef INSTANTIATE_TEMPLATE_GET_BORROWABLE
 #undef INSTANTIATE_TEMPLATE_GET
 
 template <>
-inline const std::map<int32_t, std::vector<uint32_t>>& Properties::children<Section>() const
-    noexcept {
+inline const ChildrenIndex& Properties::children<Section>() const noexcept {
     return _sectionLevel._children;
 }
 
 template <>
-inline const std::map<int32_t, std::vector<uint32_t>>& Properties::children<MitoSection>() const
-    noexcept {
+inline const ChildrenIndex& Properties::children<MitoSection>() const noexcept {
     return _mitochondriaSectionLevel._children;
 }
 
@@ -1,6 +1,9 @@
 #pragma once
 
-#include <memory>  // std::shared_ptr
+#include <array>
+#include <iterator>  // std::input_iterator_tag
+#include <memory>    // std::shared_ptr
+#include <vector>
 
 #include <morphio/morphology.h>
 #include <morphio/properties.h>
@@ -40,20 +43,12 @@ class Section: public SectionBase<Section>
 
   public:
     /// Depth first iterator
-    depth_iterator depth_begin() const {
-        return depth_iterator(*this);
-    }
-    depth_iterator depth_end() const {
-        return depth_iterator();
-    }
+    inline depth_iterator depth_begin() const;
+    inline depth_iterator depth_end() const;
 
     /// Breadth first iterator
-    breadth_iterator breadth_begin() const {
-        return breadth_iterator(*this);
-    }
-    breadth_iterator breadth_end() const {
-        return breadth_iterator();
-    }
+    inline breadth_iterator breadth_begin() const;
+    inline breadth_iterator breadth_end() const;
 
     /// Upstream iterator
     upstream_iterator upstream_begin() const {
@@ -90,6 +85,27 @@ class Section: public SectionBase<Section>
         return get<Property::Perimeter>();
     }
 
+    /**
+     * @name Aggregates
+     *
+     * Computed for all the sections of the morphology on the first call,
+     * then read in constant time.
+     **/
+    ///@{
+
+    /// Return the length of this section
+    floatType length() const;
+
+    /// Return the lateral area of this section, as frustums of cone between consecutive points
+    floatType area() const;
+
+    /// Return the volume of this section, as frustums of cone between consecutive points
+    floatType volume() const;
+
+    /// Return the bounding box of the points of this section, as (minimum, maximum corner)
+    std::array<Point, 2> boundingBox() const;
+    ///@}
+
     /// Return the morphological type of this section (dendrite, axon, ...)
     SectionType type() const {
         return properties_->get<Property::SectionType>()[id_];
@@ -107,12 +123,127 @@ class Section: public SectionBase<Section>
     friend class mut::Section;
     friend Section Morphology::section(uint32_t) const;
     friend class SectionBase<Section>;
+    friend class SectionOrderIterator;
 
   protected:
     Section(uint32_t id, const std::shared_ptr<Property::Properties>& properties)
         : SectionBase(id, properties) {}
 };
 
+/**
+ * Iterator over the sections of a precomputed order of section IDs.
+ *
+ * This is what the depth and breadth iterators of morphio::Morphology and
+ * morphio::Section are made of. The order is computed once, when the iterator
+ * is created; stepping only moves a position in it.
+ */
+class SectionOrderIterator
+{
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Section;
+    using difference_type = std::ptrdiff_t;
+    using pointer = Section*;
+    using reference = Section&;
+
+    SectionOrderIterator(const SectionOrderIterator& other);
+    SectionOrderIterator& operator=(const SectionOrderIterator& other);
+    ~SectionOrderIterator();
+
+    Section operator*() const;
+    Section const* operator->() const;
+
+    bool operator==(const SectionOrderIterator& other) const;
+    bool operator!=(const SectionOrderIterator& other) const;
+
+  protected:
+    SectionOrderIterator() noexcept;
+    SectionOrderIterator(const Morphology& morphology, SectionOrder order);
+    SectionOrderIterator(const Section& section, SectionOrder order);
+
+    void increment();
+
+  private:
+    bool atEnd() const noexcept {
+        return !order_ || position_ >= order_->size();
+    }
+
+    void resetCurrent() const noexcept;
+
+    std::shared_ptr<const std::vector<uint32_t>> order_;
+    size_t position_ = 0;
+    std::shared_ptr<Property::Properties> properties_;
+
+    // Only built when `operator->` is used, such that stepping doesn't touch
+    // the reference count of `properties_`. Same workaround for the lack of
+    // std::optional as in upstream_iterator_t.
+    union {
+        char unused_;
+        mutable Section current_;
+    };
+    mutable bool hasCurrent_ = false;
+};
+
+/// Depth first iterator over immutable sections
+template <>
+class depth_iterator_t<Section, Morphology>: public SectionOrderIterator
+{
+  public:
+    depth_iterator_t() = default;
+    explicit depth_iterator_t(const Section& section)
+        : SectionOrderIterator(section, SectionOrder::DEPTH_FIRST) {}
+    explicit depth_iterator_t(const Morphology& morphology)
+        : SectionOrderIterator(morphology, SectionOrder::DEPTH_FIRST) {}
+
+    depth_iterator_t& operator++() {
+        increment();
+        return *this;
+    }
+    depth_iterator_t operator++(int) {
+        depth_iterator_t ret(*this);
+        increment();
+        return ret;
+    }
+};
+
+/// Breadth first iterator over immutable sections
+template <>
+class breadth_iterator_t<Section, Morphology>: public SectionOrderIterator
+{
+  public:
+    breadth_iterator_t() = default;
+    explicit breadth_iterator_t(const Section& section)
+        : SectionOrderIterator(section, SectionOrder::BREADTH_FIRST) {}
+    explicit breadth_iterator_t(const Morphology& morphology)
+        : SectionOrderIterator(morphology, SectionOrder::BREADTH_FIRST) {}
+
+    breadth_iterator_t& operator++() {
+        increment();
+        return *this;
+    }
+    breadth_iterator_t operator++(int) {
+        breadth_iterator_t ret(*this);
+        increment();
+        return ret;
+    }
+};
+
+inline depth_iterator Section::depth_begin() const {
+    return depth_iterator(*this);
+}
+
+inline depth_iterator Section::depth_end() const {
+    return depth_iterator();
+}
+
+inline breadth_iterator Section::breadth_begin() const {
+    return breadth_iterator(*this);
+}
+
+inline breadth_iterator Section::breadth_end() const {
+    return breadth_iterator();
+}
+
 }  // namespace morphio
 
 std::ostream& operator<<(std::ostream& os, const morphio::Section& section);
@@ -1,8 +1,9 @@
 #pragma once
 
-#include <cstdint>  // uint32_t
-#include <memory>   // std::shared_ptr
-#include <vector>   // std::vector
+#include <cstdint>    // uint32_t
+#include <memory>     // std::shared_ptr
+#include <stdexcept>  // std::out_of_range
+#include <vector>     // std::vector
 
 #include <morphio/morphology.h>
 #include <morphio/properties.h>
@@ -96,12 +97,17 @@ inline bool SectionBase<T>::operator!=(const SectionBase& other) const noexcept
 template <typename T>
 template <typename TProperty>
 range<const typename TProperty::Type> SectionBase<T>::get() const {
-    const auto& data = properties_->get<TProperty>();
+    const auto data = properties_->get<TProperty>();
     if (data.empty()) {
         return {};
     }
 
-    return {&data.at(range_.first), range_.second - range_.first};
+    if (range_.first >= data.size() || range_.second > data.size()) {
+        throw std::out_of_range("Section range is out of array bounds (array size = " +
+                                std::to_string(data.size()) + ")");
+    }
+
+    return data.subspan(range_.first, range_.second - range_.first);
 }
 
 template <typename T>
@@ -123,19 +129,10 @@ T SectionBase<T>::parent() const {
 
 template <typename T>
 std::vector<T> SectionBase<T>::children() const {
-    const auto& section_children = properties_->children<typename T::SectionId>();
-
-    if (section_children.empty()) {
-        return {};
-    }
-
-    const auto it = section_children.find(static_cast<int>(id_));
-    if (it == section_children.end()) {
-        return {};
-    }
+    const auto children = properties_->children<typename T::SectionId>().of(
+        static_cast<int32_t>(id_));
 
     std::vector<T> result;
-    const std::vector<uint32_t> children = it->second;
     result.reserve(children.size());
     for (uint32_t id : children) {
         result.push_back(T(id, properties_));
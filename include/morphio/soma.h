@@ -30,12 +30,12 @@ class Soma
   public:
     /// Return the  coordinates (x,y,z) of all soma points
     range<const Point> points() const noexcept {
-        return properties_->_somaLevel._points;
+        return properties_->_somaLevel.points();
     }
 
     /// Return the diameters of all soma points
     range<const floatType> diameters() const noexcept {
-        return properties_->_somaLevel._diameters;
+        return properties_->_somaLevel.diameters();
     }
 
     /// Return the soma type
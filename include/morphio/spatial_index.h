@@ -0,0 +1,179 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>  // uint32_t
+#include <vector>
+
+#include <morphio/properties.h>
+#include <morphio/transform.h>
+#include <morphio/types.h>
+
+namespace morphio {
+
+class Collection;
+
+/**
+ * A location on a segment of a morphology.
+ *
+ * Sections and segments are addressed like in Property::DendriticSpine::PostSynapticDensity.
+ */
+struct SegmentLocation {
+    uint32_t sectionId;
+    uint32_t segmentId;  //!< Between the points `segmentId` and `segmentId + 1` of the section
+    floatType offset;    //!< Distance between the start of the segment and the location
+    floatType distance;  //!< Distance to the query, see the query functions
+};
+
+/**
+ * A bounding volume hierarchy over the segments of a morphology.
+ *
+ * Each segment is a capsule around the axis between two consecutive points of
+ * a section, whose radius goes linearly from the radius of the first point to
+ * the one of the second. Distances are measured to the surface of the
+ * capsules, and are 0 for points inside them.
+ *
+ * The index is immutable once built; it can be queried from several threads.
+ */
+class SpatialIndex
+{
+  public:
+    /** A segment, as stored in the index */
+    struct Capsule {
+        Point start;
+        Point end;
+        floatType startRadius;
+        floatType endRadius;
+        uint32_t sectionId;
+        uint32_t segmentId;
+        uint32_t cellId = 0;  //!< The cell of the segment, in indices over several cells
+    };
+
+    /** Index the segments of the sections, given as (offset, parent index) */
+    SpatialIndex(range<const Point> points,
+                 range<const floatType> diameters,
+                 range<const Property::Section::Type> sections);
+
+    /** Index the given segments */
+    explicit SpatialIndex(std::vector<Capsule> capsules);
+
+    /** The number of indexed segments */
+    size_t size() const noexcept {
+        return _capsules.size();
+    }
+
+    /**
+     * Return the `k` segments closest to `point`, closest first
+     *
+     * The location is the point of the segment axis closest to `point`.
+     */
+    std::vector<SegmentLocation> nearest(const Point& point, size_t k) const;
+
+    /** Return the segments at a distance of at most `radius` from `point`, closest first */
+    std::vector<SegmentLocation> within(const Point& point, floatType radius) const;
+
+    /** Return true if `point` is inside the neurites */
+    bool contains(const Point& point) const;
+
+    /**
+     * Return the segments that intersect `box`, given as (minimum, maximum corner)
+     *
+     * The test is conservative: each segment axis is clipped by the box grown
+     * by the largest radius of the segment. The location is where the axis
+     * enters the grown box, and the distance is 0.
+     */
+    std::vector<SegmentLocation> intersecting(const std::array<Point, 2>& box) const;
+
+    /**
+     * Return the segments hit by the ray from `origin` along `direction`, up to `maxDistance`
+     *
+     * A segment is hit when the ray passes within the segment radius of its
+     * axis. The location is the point of the axis closest to the ray, the
+     * distance is the one travelled along the ray to get there. Hits are
+     * sorted by distance. `maxDistance` may be infinite.
+     */
+    std::vector<SegmentLocation> raycast(const Point& origin,
+                                         const Point& direction,
+                                         floatType maxDistance) const;
+
+  private:
+    friend class CollectionSpatialIndex;
+
+    // Children of inner nodes are the next node and `right`; leaves have `right == 0`
+    struct Node {
+        std::array<Point, 2> box;
+        uint32_t begin;
+        uint32_t end;
+        uint32_t right;
+    };
+
+    uint32_t build(uint32_t begin, uint32_t end);
+
+    std::vector<Capsule> _capsules;
+    std::vector<Node> _nodes;
+};
+
+/**
+ * Two segments of different cells whose surfaces are close to each other.
+ *
+ * Each location is the point of the segment axis closest to the other
+ * segment; both distances are the one between the two surfaces.
+ */
+struct Apposition {
+    uint32_t firstCell;  //!< Always smaller than `secondCell`
+    uint32_t secondCell;
+    SegmentLocation first;
+    SegmentLocation second;
+};
+
+/**
+ * A bounding volume hierarchy over the segments of many morphologies.
+ *
+ * The morphologies are streamed from a collection, and only their segments are
+ * kept, with the index of the cell they belong to; cells are numbered by their
+ * position in the list of names.
+ *
+ * The index is immutable once built; it can be queried from several threads.
+ */
+class CollectionSpatialIndex
+{
+  public:
+    /**
+     * Index the segments of the morphologies `morphology_names` of `collection`
+     *
+     * If `transforms` is not empty, it holds one transform per cell, used to
+     * place its points. The transforms are expected to be rigid: diameters are
+     * not scaled. The morphologies are loaded with `options` by
+     * `Collection::load_parallel`, on `n_threads` threads (0 means the number
+     * of hardware threads).
+     */
+    CollectionSpatialIndex(const Collection& collection,
+                           const std::vector<std::string>& morphology_names,
+                           const std::vector<AffineTransform>& transforms = {},
+                           unsigned int options = NO_MODIFIER,
+                           size_t n_threads = 0);
+
+    /** Index the given segments, whose `cellId` must be set */
+    explicit CollectionSpatialIndex(std::vector<SpatialIndex::Capsule> capsules);
+
+    /** The number of indexed segments */
+    size_t size() const noexcept {
+        return _index.size();
+    }
+
+    /**
+     * Return the pairs of segments of different cells whose surfaces are at most `distance` apart
+     *
+     * The search is split between `n_threads` threads (0 means the number of
+     * hardware threads). The pairs are sorted by cell, section and segment.
+     */
+    std::vector<Apposition> appositions(floatType distance, size_t n_threads = 0) const;
+
+  private:
+    SpatialIndex _index;
+};
+
+}  // namespace morphio
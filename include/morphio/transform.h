@@ -0,0 +1,68 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include <morphio/types.h>
+
+namespace morphio {
+
+/**
+ * An affine transform, as the first three rows of its 4x4 matrix.
+ *
+ * A point `p` is mapped to `M * p + t`, where `M` is made of the first three
+ * columns and `t` is the last column.
+ */
+using AffineTransform = std::array<std::array<floatType, 4>, 3>;
+
+/** The transform that maps every point to itself */
+inline AffineTransform identityTransform() noexcept {
+    return {{{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}}};
+}
+
+/** The transform that moves every point by `offset` */
+AffineTransform translation(const Point& offset) noexcept;
+
+/** The rotation by `angle` radians around `axis`, which goes through the origin */
+AffineTransform rotation(const Point& axis, floatType angle);
+
+/** The transform applying `inner` first, then `outer` */
+AffineTransform compose(const AffineTransform& outer, const AffineTransform& inner) noexcept;
+
+/** Apply `transform` to `point` */
+inline Point transformed(const Point& point, const AffineTransform& transform) noexcept {
+    Point result;
+    for (size_t row = 0; row < 3; ++row) {
+        result[row] = transform[row][0] * point[0] + transform[row][1] * point[1] +
+                      transform[row][2] * point[2] + transform[row][3];
+    }
+    return result;
+}
+
+/** Apply `transform` to all `points`, in place */
+void transform(range<Point> points, const AffineTransform& transform) noexcept;
+
+/**
+ * Write the `points` mapped by `transform` to `out`, which has the same size
+ *
+ * Used to transform a copy in the same pass that makes it.
+ */
+void transform(range<const Point> points,
+               range<Point> out,
+               const AffineTransform& transform) noexcept;
+
+/**
+ * Return copies of `morphologies`, each one placed with the transform of the same index
+ *
+ * The copies are made by `n_threads` threads (0 means the number of hardware
+ * threads), see `Morphology::transformed`.
+ */
+std::vector<Morphology> transformed(const std::vector<Morphology>& morphologies,
+                                    const std::vector<AffineTransform>& transforms,
+                                    size_t n_threads = 0);
+
+}  // namespace morphio
@@ -36,6 +36,7 @@ class Vasculature;
 namespace mut {
 class DendriticSpine;
 class EndoplasmicReticulum;
+class FlatMorphology;
 class MitoSection;
 class Mitochondria;
 class Morphology;
@@ -17,6 +17,7 @@ from ._morphio import (
     CellFamily,
     CellLevel,
     Collection,
+    CollectionIndexStats,
     DendriticSpine,
     EndoplasmicReticulum,
     GlialCell,
@@ -50,9 +51,11 @@ from ._morphio import (
     WriterError,
     mut,
     ostream_redirect,
+    pack_collection,
     set_ignored_warning,
     set_raise_warnings,
     set_maximum_warnings,
     vasculature,
     version,
+    write_container_index,
 )
@@ -0,0 +1,8 @@
+from .._morphio.morphometrics import (bounding_box,
+                                      radial_distances,
+                                      section_lengths,
+                                      section_path_distances,
+                                      segment_lateral_areas,
+                                      segment_lengths,
+                                      segment_volumes,
+                                      )
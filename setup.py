@@ -84,7 +84,7 @@ setup(
                  ],
     cmdclass={'build_ext': CMakeBuild,
               },
-    packages=['morphio', 'morphio.mut', 'morphio.vasculature'],
+    packages=['morphio', 'morphio.morphometrics', 'morphio.mut', 'morphio.vasculature'],
     license="Apache License 2.0",
     keywords=['computational neuroscience',
               'morphology',
@@ -4,10 +4,26 @@
  */
 #include <morphio/collection.h>
 
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
 #include "shared_utils.hpp"
 #include <highfive/H5File.hpp>
+#include <highfive/H5Utility.hpp>  // HighFive::SilenceHDF5
 
+#include "readers/containerIndex.h"
+#include "readers/morphologyBinary.h"
 #include "readers/morphologyHDF5.h"
+#include "readers/morphologySWC.h"
+#include "readers/packedContainer.h"
 
 namespace morphio {
 
@@ -20,6 +36,9 @@ class LoadUnorderedImpl
     virtual mut::Morphology load_mut(size_t k) const = 0;
 
     virtual size_t size() const = 0;
+
+    /** The index in `morphology_names` of the `k`-th morphology loaded */
+    virtual size_t loop_index(size_t k) const = 0;
 };
 
 namespace detail {
@@ -51,6 +70,10 @@ class LoadUnorderedFromLoopIndices: public LoadUnorderedImpl
         return _morphology_names.size();
     }
 
+    size_t loop_index(size_t k) const override {
+        return _loop_indices[k];
+    }
+
     Morphology load(size_t k) const override {
         return load_impl<Morphology>(k);
     }
@@ -63,7 +86,7 @@ class LoadUnorderedFromLoopIndices: public LoadUnorderedImpl
     template <class M>
     M load_impl(size_t k) const {
         auto i = _loop_indices[k];
-        return _collection.template load<M>(_morphology_names[i], _options);
+        return _collection.template load<M>(_morphology_names[i], _options, _warning_handler);
     }
 
   private:
@@ -74,8 +97,500 @@ class LoadUnorderedFromLoopIndices: public LoadUnorderedImpl
     std::shared_ptr<WarningHandler> _warning_handler;
 };
 
+/**
+ * Forwards to a warning handler while holding a mutex.
+ *
+ * Warning handlers are not thread-safe; this allows sharing one between the
+ * workers of a `LoadParallel`.
+ */
+class SynchronizedWarningHandler: public WarningHandler
+{
+  public:
+    explicit SynchronizedWarningHandler(std::shared_ptr<WarningHandler> warning_handler)
+        : _warning_handler(std::move(warning_handler)) {}
+
+    void emit(std::shared_ptr<WarningMessage> wm) final {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _warning_handler->emit(std::move(wm));
+    }
+
+    int getMaxWarningCount() const final {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _warning_handler->getMaxWarningCount();
+    }
+
+    void setMaxWarningCount(int warningCount) final {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _warning_handler->setMaxWarningCount(warningCount);
+    }
+
+    bool getRaiseWarnings() const final {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _warning_handler->getRaiseWarnings();
+    }
+
+    void setRaiseWarnings(bool raise) final {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _warning_handler->setRaiseWarnings(raise);
+    }
+
+  private:
+    std::shared_ptr<WarningHandler> _warning_handler;
+    mutable std::mutex _mutex;
+};
+
+/**
+ *  Load morphologies ahead of the consumer.
+ *
+ *  A background thread loads the next `depth` morphologies, in the order of
+ *  the wrapped `LoadUnorderedImpl`, while the consumer processes the current
+ *  one. Loop indices which are requested out of order, or requested again, are
+ *  loaded synchronously from the wrapped object.
+ */
+template <class M>
+class LoadUnorderedPrefetch: public LoadUnorderedImpl
+{
+  public:
+    LoadUnorderedPrefetch(std::shared_ptr<LoadUnorderedImpl> load_unordered_impl, size_t depth)
+        : _load_unordered_impl(std::move(load_unordered_impl))
+        , _depth(depth)
+        , _worker(&LoadUnorderedPrefetch::work, this) {}
+
+    LoadUnorderedPrefetch(const LoadUnorderedPrefetch&) = delete;
+    LoadUnorderedPrefetch(LoadUnorderedPrefetch&&) = delete;
+    LoadUnorderedPrefetch& operator=(const LoadUnorderedPrefetch&) = delete;
+    LoadUnorderedPrefetch& operator=(LoadUnorderedPrefetch&&) = delete;
+
+    ~LoadUnorderedPrefetch() override {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _advanced.notify_all();
+        _worker.join();
+    }
+
+    size_t size() const override {
+        return _load_unordered_impl->size();
+    }
+
+    size_t loop_index(size_t k) const override {
+        return _load_unordered_impl->loop_index(k);
+    }
+
+    Morphology load(size_t k) const override {
+        return fetch<Morphology>(k);
+    }
+
+    mut::Morphology load_mut(size_t k) const override {
+        return fetch<mut::Morphology>(k);
+    }
+
+  private:
+    struct Result {
+        std::unique_ptr<M> morphology;
+        std::exception_ptr error;
+    };
+
+    static Morphology load_from(const LoadUnorderedImpl& impl, size_t k, Morphology*) {
+        return impl.load(k);
+    }
+
+    static mut::Morphology load_from(const LoadUnorderedImpl& impl, size_t k, mut::Morphology*) {
+        return impl.load_mut(k);
+    }
+
+    template <class U>
+    typename std::enable_if<!std::is_same<U, M>::value, U>::type fetch(size_t) const {
+        throw std::logic_error("LoadUnorderedPrefetch: requested the wrong kind of morphology.");
+    }
+
+    template <class U>
+    typename std::enable_if<std::is_same<U, M>::value, U>::type fetch(size_t k) const {
+        Result result;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (k >= _cursor) {
+                // Anything before `k` has been skipped, don't keep it around.
+                _ready.erase(_ready.begin(), _ready.lower_bound(k));
+                _cursor = k + 1;
+                _next = std::max(_next, k + 1);
+            }
+
+            _loaded.wait(lock, [this, k]() { return !_is_loading || _loading != k; });
+
+            auto it = _ready.find(k);
+            if (it != _ready.end()) {
+                result = std::move(it->second);
+                _ready.erase(it);
+            }
+        }
+        _advanced.notify_one();
+
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+
+        if (result.morphology) {
+            return std::move(*result.morphology);
+        }
+
+        return load_from(*_load_unordered_impl, k, static_cast<M*>(nullptr));
+    }
+
+    void work() {
+        readers::swc::setSerialParsing(true);
+        const size_t n = size();
+        while (true) {
+            size_t k;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _advanced.wait(lock, [this, n]() {
+                    return _stop || (_next < n && _next < _cursor + _depth);
+                });
+
+                if (_stop) {
+                    return;
+                }
+
+                k = _next++;
+                _loading = k;
+                _is_loading = true;
+            }
+
+            Result result;
+            try {
+                result.morphology.reset(
+                    new M(load_from(*_load_unordered_impl, k, static_cast<M*>(nullptr))));
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if (k + 1 >= _cursor) {
+                    _ready.emplace(k, std::move(result));
+                }
+                _is_loading = false;
+            }
+            _loaded.notify_all();
+        }
+    }
+
+    std::shared_ptr<LoadUnorderedImpl> _load_unordered_impl;
+    size_t _depth;
+
+    mutable std::mutex _mutex;
+    mutable std::condition_variable _advanced;
+    mutable std::condition_variable _loaded;
+    mutable std::map<size_t, Result> _ready;
+    mutable size_t _cursor = 0;
+    mutable size_t _next = 0;
+    size_t _loading = 0;
+    bool _is_loading = false;
+    bool _stop = false;
+
+    std::thread _worker;
+};
+
+/**
+ *  Load morphologies from a container by reading the file in large slabs.
+ *
+ *  The morphologies are sorted by the offset of their datasets. Consecutive
+ *  morphologies are grouped into slabs, each of which is read from the file
+ *  with a single read, bypassing HDF5. The morphologies are then decoded
+ *  directly from the bytes of the slab.
+ *
+ *  Morphologies that can't be read like this, e.g. because they use chunked
+ *  datasets or have organelles, are loaded through the collection instead.
+ */
+class LoadUnorderedFromSlabs: public LoadUnorderedImpl
+{
+  public:
+    LoadUnorderedFromSlabs(Collection collection,
+                           std::shared_ptr<const readers::h5::RawFileReader> reader,
+                           std::vector<readers::h5::MorphologyLayout> layouts,
+                           std::vector<std::string> morphology_names,
+                           unsigned int options,
+                           std::shared_ptr<WarningHandler> warning_handler)
+        : _collection(std::move(collection))
+        , _layouts(std::move(layouts))
+        , _morphology_names(std::move(morphology_names))
+        , _options(options)
+        , _warning_handler(std::move(warning_handler))
+        , _reader(std::move(reader)) {
+        const size_t n_morphologies = _morphology_names.size();
+
+        // Morphologies whose datasets are too far apart are loaded individually.
+        for (auto& layout : _layouts) {
+            if (layout.end() - layout.begin() > max_slab_size) {
+                layout.isDirectlyReadable = false;
+            }
+        }
+
+        _loop_indices.resize(n_morphologies);
+        for (size_t i = 0; i < n_morphologies; ++i) {
+            _loop_indices[i] = i;
+        }
+
+        const auto& sort_layouts = _layouts;
+        std::stable_sort(_loop_indices.begin(),
+                         _loop_indices.end(),
+                         [&sort_layouts](size_t i, size_t j) {
+                             const auto& a = sort_layouts[i];
+                             const auto& b = sort_layouts[j];
+                             if (a.isDirectlyReadable != b.isDirectlyReadable) {
+                                 return a.isDirectlyReadable;
+                             }
+                             return a.isDirectlyReadable && a.begin() < b.begin();
+                         });
+
+        _slab_ids.resize(n_morphologies, no_slab);
+        for (size_t k = 0; k < n_morphologies; ++k) {
+            const auto& layout = _layouts[_loop_indices[k]];
+            if (!layout.isDirectlyReadable) {
+                continue;
+            }
+
+            if (_slabs.empty() || layout.end() - _slabs.back().begin > max_slab_size ||
+                layout.begin() > _slabs.back().end + max_slab_gap) {
+                _slabs.push_back({layout.begin(), layout.end()});
+            } else {
+                _slabs.back().end = std::max(_slabs.back().end, layout.end());
+            }
+            _slab_ids[k] = _slabs.size() - 1;
+        }
+    }
+
+    size_t size() const override {
+        return _morphology_names.size();
+    }
+
+    size_t loop_index(size_t k) const override {
+        return _loop_indices[k];
+    }
+
+    Morphology load(size_t k) const override {
+        return load_impl<Morphology>(k);
+    }
+
+    mut::Morphology load_mut(size_t k) const override {
+        return load_impl<mut::Morphology>(k);
+    }
+
+  protected:
+    template <class M>
+    M load_impl(size_t k) const {
+        const auto i = _loop_indices[k];
+        const auto slab_id = _slab_ids[k];
+
+        if (slab_id == no_slab) {
+            return _collection.template load<M>(_morphology_names[i], _options, _warning_handler);
+        }
+
+        auto warning_handler = _warning_handler ? _warning_handler : getWarningHandler();
+        auto slab = read_slab(slab_id);
+        auto properties = readers::h5::decode(_layouts[i],
+                                              *slab,
+                                              _slabs[slab_id].begin,
+                                              "HDF5 GROUP",
+                                              warning_handler.get(),
+                                              _options);
+
+        return M(Morphology(std::move(properties), _options));
+    }
+
+  private:
+    struct Slab {
+        uint64_t begin;
+        uint64_t end;
+    };
+
+    static constexpr size_t no_slab = size_t(-1);
+    static constexpr uint64_t max_slab_size = uint64_t(16) << 20;
+    static constexpr uint64_t max_slab_gap = uint64_t(1) << 20;
+
+    std::shared_ptr<const std::vector<char>> read_slab(size_t slab_id) const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_cached_slab == nullptr || _cached_slab_id != slab_id) {
+            const auto& slab = _slabs[slab_id];
+            _cached_slab = std::make_shared<const std::vector<char>>(
+                _reader->read(slab.begin, slab.end));
+            _cached_slab_id = slab_id;
+        }
+
+        return _cached_slab;
+    }
+
+    Collection _collection;
+    std::vector<readers::h5::MorphologyLayout> _layouts;
+    std::vector<std::string> _morphology_names;
+    unsigned int _options;
+    std::shared_ptr<WarningHandler> _warning_handler;
+
+    std::vector<size_t> _loop_indices;
+    std::vector<Slab> _slabs;
+    std::vector<size_t> _slab_ids;
+
+    std::shared_ptr<const readers::h5::RawFileReader> _reader;
+
+    mutable std::mutex _mutex;
+    mutable std::shared_ptr<const std::vector<char>> _cached_slab;
+    mutable size_t _cached_slab_id = no_slab;
+};
+
+constexpr size_t LoadUnorderedFromSlabs::no_slab;
+constexpr uint64_t LoadUnorderedFromSlabs::max_slab_size;
+constexpr uint64_t LoadUnorderedFromSlabs::max_slab_gap;
+
 }  // namespace detail
 
+/**
+ * A pool of worker threads loading morphologies into a bounded queue.
+ *
+ * The workers claim morphologies in the order given by `loop_indices`. A
+ * worker only claims a morphology if the number of morphologies which are
+ * being loaded or waiting to be consumed is below `capacity`.
+ */
+template <class M>
+class LoadParallelImpl
+{
+  public:
+    LoadParallelImpl(Collection collection,
+                     std::vector<size_t> loop_indices,
+                     std::vector<std::string> morphology_names,
+                     unsigned int options,
+                     size_t n_threads,
+                     std::shared_ptr<WarningHandler> warning_handler)
+        : _collection(std::move(collection))
+        , _loop_indices(std::move(loop_indices))
+        , _morphology_names(std::move(morphology_names))
+        , _options(options)
+        , _warning_handler(std::move(warning_handler))
+        , _capacity(2 * n_threads) {
+        _workers.reserve(n_threads);
+        try {
+            for (size_t i = 0; i < n_threads; ++i) {
+                _workers.emplace_back(&LoadParallelImpl::work, this);
+            }
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    LoadParallelImpl(const LoadParallelImpl&) = delete;
+    LoadParallelImpl(LoadParallelImpl&&) = delete;
+    LoadParallelImpl& operator=(const LoadParallelImpl&) = delete;
+    LoadParallelImpl& operator=(LoadParallelImpl&&) = delete;
+
+    ~LoadParallelImpl() {
+        stop();
+    }
+
+    size_t size() const {
+        return _morphology_names.size();
+    }
+
+    /**
+     * Wait for the next morphology to be loaded, and return it with its index.
+     */
+    std::pair<size_t, M> next() {
+        Result result;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            if (_n_consumed == size()) {
+                throw std::out_of_range("All morphologies have already been consumed.");
+            }
+
+            _not_empty.wait(lock, [this]() { return !_results.empty(); });
+            result = std::move(_results.front());
+            _results.pop_front();
+            ++_n_consumed;
+        }
+        _not_full.notify_one();
+
+        if (result.error) {
+            std::rethrow_exception(result.error);
+        }
+
+        return {result.index, std::move(*result.morphology)};
+    }
+
+  private:
+    struct Result {
+        size_t index = 0;
+        std::unique_ptr<M> morphology;
+        std::exception_ptr error;
+    };
+
+    void work() {
+        readers::swc::setSerialParsing(true);
+        while (true) {
+            size_t k;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _not_full.wait(lock, [this]() {
+                    return _stop || _n_loading + _results.size() < _capacity;
+                });
+
+                if (_stop || _n_claimed == _loop_indices.size()) {
+                    return;
+                }
+
+                k = _n_claimed++;
+                ++_n_loading;
+            }
+
+            Result result;
+            result.index = _loop_indices[k];
+            try {
+                result.morphology.reset(new M(_collection.template load<M>(
+                    _morphology_names[result.index], _options, _warning_handler)));
+            } catch (...) {
+                result.error = std::current_exception();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                --_n_loading;
+                _results.push_back(std::move(result));
+            }
+            _not_empty.notify_one();
+        }
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _not_full.notify_all();
+
+        for (auto& worker : _workers) {
+            worker.join();
+        }
+    }
+
+    Collection _collection;
+    std::vector<size_t> _loop_indices;
+    std::vector<std::string> _morphology_names;
+    unsigned int _options;
+    std::shared_ptr<WarningHandler> _warning_handler;
+    size_t _capacity;
+
+    std::mutex _mutex;
+    std::condition_variable _not_full;
+    std::condition_variable _not_empty;
+    std::deque<Result> _results;
+    size_t _n_claimed = 0;
+    size_t _n_loading = 0;
+    size_t _n_consumed = 0;
+    bool _stop = false;
+
+    std::vector<std::thread> _workers;
+};
+
 
 class CollectionImpl
 {
@@ -97,6 +612,10 @@ class CollectionImpl
         std::shared_ptr<WarningHandler> warning_handler) const = 0;
 
     virtual std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const = 0;
+
+    virtual CollectionIndexStats index_stats() const {
+        return {};
+    }
 };
 
 namespace detail {
@@ -189,13 +708,19 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
      * to open the container.
      */
     HDF5ContainerCollection(HighFive::File file)
-        : _file(std::move(file)) {}
+        : _file(std::move(file))
+        , _reader(open_raw_reader(_file)) {}
 
     /**
      * Create the collection from a path.
+     *
+     * If an up to date sidecar index exists next to the container, it is used
+     * to locate the morphologies.
      */
     HDF5ContainerCollection(const std::string& collection_path)
-        : HDF5ContainerCollection(default_open_file(collection_path)) {}
+        : HDF5ContainerCollection(default_open_file(collection_path)) {
+        open_index(collection_path);
+    }
 
     HDF5ContainerCollection(HDF5ContainerCollection&&) = delete;
     HDF5ContainerCollection(const HDF5ContainerCollection&) = delete;
@@ -204,6 +729,8 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
     HDF5ContainerCollection& operator=(HDF5ContainerCollection&&) = delete;
 
     std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const override {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+
         auto n_morphologies = morphology_names.size();
         std::vector<hsize_t> offsets(n_morphologies);
         std::vector<size_t> loop_indices(n_morphologies);
@@ -213,6 +740,12 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
 
             const auto& morph_name = morphology_names[i];
 
+            const auto* indexed = find_layout(morph_name);
+            if (indexed != nullptr && indexed->isDirectlyReadable) {
+                offsets[i] = indexed->points.offset;
+                continue;
+            }
+
             auto morph = _file.getGroup(morph_name.data());
             auto points = morph.getDataSet("points");
 
@@ -228,6 +761,50 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
         return loop_indices;
     }
 
+    std::shared_ptr<LoadUnorderedImpl> load_unordered(
+        Collection collection,
+        std::vector<std::string> morphology_names,
+        unsigned int options,
+        std::shared_ptr<WarningHandler> warning_handler) const override {
+        if (_reader == nullptr) {
+            return morphio::detail::CollectionImpl<HDF5ContainerCollection>::load_unordered(
+                std::move(collection), std::move(morphology_names), options, warning_handler);
+        }
+
+        std::vector<readers::h5::MorphologyLayout> layouts;
+        layouts.reserve(morphology_names.size());
+        {
+            std::lock_guard<std::recursive_mutex> lock(
+                morphio::readers::h5::global_hdf5_mutex());
+
+            for (const auto& morph_name : morphology_names) {
+                const auto* indexed = find_layout(morph_name);
+                if (indexed != nullptr) {
+                    layouts.push_back(*indexed);
+                } else {
+                    layouts.push_back(
+                        readers::h5::MorphologyHDF5(_file.getGroup(morph_name), morph_name)
+                            .layout());
+                }
+            }
+        }
+
+        return std::make_shared<detail::LoadUnorderedFromSlabs>(std::move(collection),
+                                                                _reader,
+                                                                std::move(layouts),
+                                                                std::move(morphology_names),
+                                                                options,
+                                                                std::move(warning_handler));
+    }
+
+    CollectionIndexStats index_stats() const override {
+        auto stats = _index_stats;
+        stats.n_lookups = _n_lookups;
+        stats.n_hits = _n_hits;
+        stats.lookup_time = 1e-9 * static_cast<double>(_lookup_ns);
+        return stats;
+    }
+
   protected:
     friend morphio::detail::CollectionImpl<HDF5ContainerCollection>;
 
@@ -235,18 +812,186 @@ class HDF5ContainerCollection: public morphio::detail::CollectionImpl<HDF5Contai
     M load_impl(const std::string& morph_name,
                 unsigned int options,
                 std::shared_ptr<WarningHandler> warning_handler) const {
-        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
-        return M(_file.getGroup(morph_name), options, warning_handler);
+        const auto* indexed = find_layout(morph_name);
+        if (indexed != nullptr && indexed->isDirectlyReadable) {
+            if (warning_handler == nullptr) {
+                warning_handler = getWarningHandler();
+            }
+
+            auto bytes = _reader->read(indexed->begin(), indexed->end());
+            auto properties = readers::h5::decode(
+                *indexed, bytes, indexed->begin(), "HDF5 GROUP", warning_handler.get(), options);
+            return M(Morphology(std::move(properties), options));
+        }
+
+        // Opening and closing the group require the HDF5 lock. The morphology
+        // itself only holds it while reading the datasets, which lets other
+        // threads use HDF5 while this one is decoding.
+        std::unique_ptr<HighFive::Group, LockedGroupDeleter> group;
+        {
+            std::lock_guard<std::recursive_mutex> lock(
+                morphio::readers::h5::global_hdf5_mutex());
+            group.reset(new HighFive::Group(_file.getGroup(morph_name)));
+        }
+
+        return M(*group, options, warning_handler);
+    }
+
+    struct LockedGroupDeleter {
+        void operator()(HighFive::Group* group) const {
+            std::lock_guard<std::recursive_mutex> lock(
+                morphio::readers::h5::global_hdf5_mutex());
+            delete group;
+        }
+    };
+
+    /**
+     * The indexed layout of `morph_name`, or `nullptr` if there's no index or
+     * the morphology isn't in it.
+     */
+    const readers::h5::MorphologyLayout* find_layout(const std::string& morph_name) const {
+        if (_index == nullptr) {
+            return nullptr;
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const auto* layout = _index->find(morph_name);
+        const auto stop = std::chrono::steady_clock::now();
+
+        ++_n_lookups;
+        if (layout != nullptr) {
+            ++_n_hits;
+        }
+        _lookup_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+        return layout;
+    }
+
+    void open_index(const std::string& collection_path) {
+        const auto index_path = readers::h5::containerIndexPath(collection_path);
+        if (_reader == nullptr || !morphio::is_regular_file(index_path)) {
+            return;
+        }
+
+        _index_stats.found = true;
+
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            auto index = readers::h5::ContainerIndex::read(index_path);
+            if (index.isCurrent(collection_path)) {
+                _index.reset(new readers::h5::ContainerIndex(std::move(index)));
+            }
+        } catch (const RawDataError&) {
+            // An unreadable index is treated like a stale one.
+        }
+        const auto stop = std::chrono::steady_clock::now();
+
+        _index_stats.stale = _index == nullptr;
+        _index_stats.size = _index == nullptr ? 0 : _index->size();
+        _index_stats.load_time = std::chrono::duration<double>(stop - start).count();
     }
 
-  protected:
     static HighFive::File default_open_file(const std::string& container_path) {
         std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
         return HighFive::File(container_path, HighFive::File::ReadOnly);
     }
 
+    /**
+     * Open the container for reads which bypass HDF5, if the offsets HDF5
+     * reports are offsets into the file, i.e. the file uses the sec2 driver.
+     */
+    static std::shared_ptr<const readers::h5::RawFileReader> open_raw_reader(
+        const HighFive::File& file) {
+        std::string path;
+        {
+            std::lock_guard<std::recursive_mutex> lock(
+                morphio::readers::h5::global_hdf5_mutex());
+            const hid_t fapl = H5Fget_access_plist(file.getId());
+            if (fapl < 0) {
+                return nullptr;
+            }
+
+            const bool is_sec2 = H5Pget_driver(fapl) == H5FD_SEC2;
+            H5Pclose(fapl);
+            if (!is_sec2) {
+                return nullptr;
+            }
+
+            path = file.getName();
+        }
+
+        auto reader = std::make_shared<const readers::h5::RawFileReader>(path);
+        return reader->isOpen() ? reader : nullptr;
+    }
+
   private:
     HighFive::File _file;
+    std::shared_ptr<const readers::h5::RawFileReader> _reader;
+
+    std::unique_ptr<const readers::h5::ContainerIndex> _index;
+    CollectionIndexStats _index_stats;
+    mutable std::atomic<size_t> _n_lookups{0};
+    mutable std::atomic<size_t> _n_hits{0};
+    mutable std::atomic<int64_t> _lookup_ns{0};
+};
+
+class PackedCollection: public morphio::detail::CollectionImpl<PackedCollection>
+{
+  public:
+    /**
+     * Create the collection from a packed container, see `pack_collection`.
+     *
+     * The container is mapped into memory; loading a morphology neither
+     * requires a system call nor the HDF5 lock. The points, diameters and
+     * sections of the loaded morphologies are borrowed from the mapping, which
+     * stays alive until the last of them is destroyed.
+     */
+    explicit PackedCollection(const std::string& collection_path)
+        : _container(std::make_shared<const readers::packed::Container>(collection_path)) {}
+
+    std::vector<size_t> argsort(const std::vector<std::string>& morphology_names) const override {
+        auto n_morphologies = morphology_names.size();
+        std::vector<uint64_t> offsets(n_morphologies);
+        std::vector<size_t> loop_indices(n_morphologies);
+
+        for (size_t i = 0; i < n_morphologies; ++i) {
+            loop_indices[i] = i;
+
+            const auto bytes = _container->find(morphology_names[i]);
+            offsets[i] = bytes.empty() ? uint64_t(-1) : _container->offset(bytes);
+        }
+
+        std::sort(loop_indices.begin(), loop_indices.end(), [&offsets](size_t i, size_t j) {
+            return offsets[i] < offsets[j];
+        });
+
+        return loop_indices;
+    }
+
+  protected:
+    friend morphio::detail::CollectionImpl<PackedCollection>;
+
+    template <class M>
+    M load_impl(const std::string& morph_name,
+                unsigned int options,
+                std::shared_ptr<WarningHandler> warning_handler) const {
+        const auto bytes = _container->find(morph_name);
+        if (bytes.empty()) {
+            throw MorphioError("Morphology '" + morph_name + "' not found in: " +
+                               _container->path());
+        }
+
+        if (warning_handler == nullptr) {
+            warning_handler = getWarningHandler();
+        }
+
+        auto properties = readers::binary::decode(
+            bytes, morph_name, warning_handler.get(), _container, options);
+        return M(Morphology(std::move(properties), options));
+    }
+
+  private:
+    std::shared_ptr<const readers::packed::Container> _container;
 };
 
 namespace detail {
@@ -261,6 +1006,9 @@ static std::shared_ptr<morphio::CollectionImpl> open_collection(
 
     if (morphio::is_regular_file(collection_path)) {
         // Prepare to load from containers.
+        if (readers::packed::isPackedContainer(collection_path)) {
+            return std::make_shared<PackedCollection>(collection_path);
+        }
         return std::make_shared<HDF5ContainerCollection>(std::move(collection_path));
     }
 
@@ -326,21 +1074,137 @@ template Morphology Collection::load<Morphology>(
 template <class M>
 LoadUnordered<M> Collection::load_unordered(std::vector<std::string> morphology_names,
                                             unsigned int options,
-                                            std::shared_ptr<WarningHandler> warning_handler) const {
-    return LoadUnordered<M>(
-        _collection->load_unordered(*this, morphology_names, options, warning_handler));
+                                            std::shared_ptr<WarningHandler> warning_handler,
+                                            size_t prefetch) const {
+    if (prefetch == 0) {
+        return LoadUnordered<M>(
+            _collection->load_unordered(*this, morphology_names, options, warning_handler));
+    }
+
+    // The morphologies are loaded on a second thread, which would otherwise
+    // share the (not thread-safe) warning handler with the caller.
+    if (warning_handler == nullptr) {
+        warning_handler = getWarningHandler();
+    }
+    warning_handler = std::make_shared<detail::SynchronizedWarningHandler>(
+        std::move(warning_handler));
+
+    return LoadUnordered<M>(std::make_shared<detail::LoadUnorderedPrefetch<M>>(
+        _collection->load_unordered(*this, morphology_names, options, warning_handler),
+        prefetch));
 }
 
 template LoadUnordered<mut::Morphology> Collection::load_unordered<mut::Morphology>(
     std::vector<std::string> morphology_names,
     unsigned int options,
-    std::shared_ptr<WarningHandler> warning_handler) const;
+    std::shared_ptr<WarningHandler> warning_handler,
+    size_t prefetch) const;
 
 template LoadUnordered<Morphology> Collection::load_unordered<Morphology>(
     std::vector<std::string> morphology_names,
     unsigned int options,
+    std::shared_ptr<WarningHandler> warning_handler,
+    size_t prefetch) const;
+
+
+template <class M>
+LoadParallel<M> Collection::load_parallel(std::vector<std::string> morphology_names,
+                                          unsigned int options,
+                                          size_t n_threads,
+                                          std::shared_ptr<WarningHandler> warning_handler) const {
+    if (_collection == nullptr) {
+        throw std::runtime_error("The collection has been closed.");
+    }
+
+    if (n_threads == 0) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    n_threads = std::min(n_threads, morphology_names.size());
+
+    if (warning_handler == nullptr) {
+        warning_handler = getWarningHandler();
+    }
+
+    auto loop_indices = argsort(morphology_names);
+    return LoadParallel<M>(std::make_shared<LoadParallelImpl<M>>(
+        *this,
+        std::move(loop_indices),
+        std::move(morphology_names),
+        options,
+        n_threads,
+        std::make_shared<detail::SynchronizedWarningHandler>(std::move(warning_handler))));
+}
+
+template LoadParallel<mut::Morphology> Collection::load_parallel<mut::Morphology>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    size_t n_threads,
     std::shared_ptr<WarningHandler> warning_handler) const;
 
+template LoadParallel<Morphology> Collection::load_parallel<Morphology>(
+    std::vector<std::string> morphology_names,
+    unsigned int options,
+    size_t n_threads,
+    std::shared_ptr<WarningHandler> warning_handler) const;
+
+
+CollectionIndexStats Collection::index_stats() const {
+    if (_collection != nullptr) {
+        return _collection->index_stats();
+    }
+
+    throw std::runtime_error("The collection has been closed.");
+}
+
+double write_container_index(const std::string& container_path) {
+    const auto start = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+        HighFive::SilenceHDF5 silence;
+        const auto file = HighFive::File(container_path, HighFive::File::ReadOnly);
+        readers::h5::ContainerIndex::build(file, container_path)
+            .write(readers::h5::containerIndexPath(container_path));
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double>(stop - start).count();
+}
+
+void pack_collection(const std::string& collection_path,
+                     const std::string& output_path,
+                     const std::vector<std::string>& extensions) {
+    std::vector<std::string> morphology_names;
+    if (morphio::is_directory(collection_path)) {
+        for (const auto& filename : morphio::list_regular_files(collection_path)) {
+            for (const auto& ext : extensions) {
+                if (filename.size() > ext.size() &&
+                    filename.compare(filename.size() - ext.size(), ext.size(), ext) == 0) {
+                    morphology_names.push_back(filename.substr(0, filename.size() - ext.size()));
+                    break;
+                }
+            }
+        }
+        // The same morphology may exist with several extensions.
+        std::sort(morphology_names.begin(), morphology_names.end());
+        morphology_names.erase(std::unique(morphology_names.begin(), morphology_names.end()),
+                               morphology_names.end());
+    } else if (readers::packed::isPackedContainer(collection_path)) {
+        morphology_names = readers::packed::Container(collection_path).names();
+    } else {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+        const auto file = HighFive::File(collection_path, HighFive::File::ReadOnly);
+        morphology_names = file.listObjectNames();
+    }
+
+    const Collection collection(collection_path, extensions);
+    readers::packed::ContainerWriter writer(output_path);
+    // Reading in the order of the input keeps the conversion of HDF5 containers sequential.
+    for (auto i : collection.argsort(morphology_names)) {
+        const auto& morph_name = morphology_names[i];
+        writer.add(morph_name, collection.load<Morphology>(morph_name));
+    }
+    writer.close();
+}
 
 void Collection::close() {
     _collection = nullptr;
@@ -392,14 +1256,14 @@ template <class M>
 template <class U>
 typename enable_if_mutable<U, std::pair<size_t, M>>::type LoadUnordered<M>::Iterator::operator*()
     const {
-    return {_k, std::move(_load_unordered_impl->load_mut(_k))};
+    return {_load_unordered_impl->loop_index(_k), std::move(_load_unordered_impl->load_mut(_k))};
 }
 
 template <class M>
 template <class U>
 typename enable_if_immutable<U, std::pair<size_t, M>>::type LoadUnordered<M>::Iterator::operator*()
     const {
-    return {_k, std::move(_load_unordered_impl->load(_k))};
+    return {_load_unordered_impl->loop_index(_k), std::move(_load_unordered_impl->load(_k))};
 }
 
 
@@ -459,4 +1323,53 @@ template typename enable_if_immutable<Morphology, std::pair<size_t, Morphology>>
     LoadUnordered<Morphology>::Iterator::operator*<Morphology>() const;
 
 
+template <class M>
+LoadParallel<M>::LoadParallel(std::shared_ptr<LoadParallelImpl<M>> load_parallel_impl)
+    : _load_parallel_impl(std::move(load_parallel_impl)) {}
+
+template <class M>
+typename LoadParallel<M>::Iterator LoadParallel<M>::begin() const {
+    return Iterator(_load_parallel_impl, 0);
+}
+
+template <class M>
+typename LoadParallel<M>::Iterator LoadParallel<M>::end() const {
+    return Iterator(_load_parallel_impl, _load_parallel_impl->size());
+}
+
+template <class M>
+LoadParallel<M>::Iterator::Iterator(std::shared_ptr<LoadParallelImpl<M>> load_parallel_impl,
+                                    size_t k)
+    : _k(k)
+    , _load_parallel_impl(std::move(load_parallel_impl)) {}
+
+template <class M>
+bool LoadParallel<M>::Iterator::operator==(const LoadParallel::Iterator& other) const {
+    return (*this)._k == other._k;
+}
+
+template <class M>
+bool LoadParallel<M>::Iterator::operator!=(const LoadParallel::Iterator& other) const {
+    return !((*this) == other);
+}
+
+template <class M>
+typename LoadParallel<M>::Iterator& LoadParallel<M>::Iterator::operator++() {
+    ++_k;
+    return *this;
+}
+
+template <class M>
+typename LoadParallel<M>::Iterator LoadParallel<M>::Iterator::operator++(int) {
+    return LoadParallel<M>::Iterator(_load_parallel_impl, _k++);
+}
+
+template <class M>
+std::pair<size_t, M> LoadParallel<M>::Iterator::operator*() const {
+    return _load_parallel_impl->next();
+}
+
+template class LoadParallel<Morphology>;
+template class LoadParallel<mut::Morphology>;
+
 }  // namespace morphio
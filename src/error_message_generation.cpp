@@ -181,7 +181,7 @@ std::string ErrorMessages::ERROR_UNSUPPORTED_SECTION_TYPE(const SectionType& typ
 }
 
 std::string ErrorMessages::ERROR_WRONG_EXTENSION(const std::string& filename) const {
-    return "Filename: " + filename + " must have one of the following extensions: swc, asc or h5";
+    return "Filename: " + filename + " must have one of the following extensions: swc, asc, h5 or mbin";
 }
 
 std::string ErrorMessages::ERROR_VECTOR_LENGTH_MISMATCH(const std::string& vec1,
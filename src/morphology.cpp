@@ -2,7 +2,8 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <cctype>  // std::tolower
+#include <algorithm>  // std::stable_sort
+#include <cctype>     // std::tolower
 #include <fstream>
 #include <iterator>  // std::back_inserter
 #include <memory>
@@ -12,11 +13,13 @@
 #include <morphio/morphology.h>
 #include <morphio/section.h>
 #include <morphio/soma.h>
+#include <morphio/spatial_index.h>
 #include <morphio/warning_handling.h>  // ErrorAndWarningHandler
 
 #include <morphio/mut/morphology.h>
 
 #include "readers/morphologyASC.h"
+#include "readers/morphologyBinary.h"
 #include "readers/morphologyHDF5.h"
 #include "readers/morphologySWC.h"
 
@@ -36,25 +39,10 @@ std::string readCompleteFile(const std::string& path) {
 }
 
 void buildChildren(const std::shared_ptr<morphio::Property::Properties>& properties) {
-    {
-        const auto& sections = properties->get<morphio::Property::Section>();
-        auto& children = properties->_sectionLevel._children;
-
-        for (unsigned int i = 0; i < sections.size(); ++i) {
-            const int32_t parent = sections[i][1];
-            children[parent].push_back(i);
-        }
-    }
-
-    {
-        const auto& sections = properties->get<morphio::Property::MitoSection>();
-        auto& children = properties->_mitochondriaSectionLevel._children;
-
-        for (unsigned int i = 0; i < sections.size(); ++i) {
-            const int32_t parent = sections[i][1];
-            children[parent].push_back(i);
-        }
-    }
+    properties->_sectionLevel._children = morphio::Property::ChildrenIndex(
+        properties->get<morphio::Property::Section>());
+    properties->_mitochondriaSectionLevel._children = morphio::Property::ChildrenIndex(
+        properties->get<morphio::Property::MitoSection>());
 }
 
 std::string tolower(const std::string& str) {
@@ -80,17 +68,22 @@ morphio::Property::Properties loadFile(const std::string& path,
     std::string extension = tolower(path.substr(pos + 1));
 
     if (extension == "h5") {
-        return morphio::readers::h5::load(path, warning_handler.get());
+        return morphio::readers::h5::load(path, warning_handler.get(), options);
     } else if (extension == "asc") {
         std::string contents = readCompleteFile(path);
         return morphio::readers::asc::load(path, contents, options, warning_handler.get());
     } else if (extension == "swc") {
-        std::string contents = readCompleteFile(path);
-        return morphio::readers::swc::load(path, contents, options, warning_handler);
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            throw(morphio::RawDataError("File: " + path + " does not exist."));
+        }
+        return morphio::readers::swc::load(path, stream, options, warning_handler);
+    } else if (extension == "mbin") {
+        return morphio::readers::binary::load(path, warning_handler.get(), options);
     }
 
     throw(morphio::UnknownFileType("Unhandled file type: '" + extension +
-                                   "' only SWC, ASC and H5 are supported"));
+                                   "' only SWC, ASC, H5 and MBIN are supported"));
 }
 
 
@@ -108,10 +101,16 @@ morphio::Property::Properties loadString(const std::string& contents,
         return morphio::readers::asc::load("$STRING$", contents, options, warning_handler.get());
     } else if (lower_extension == "swc") {
         return morphio::readers::swc::load("$STRING$", contents, options, warning_handler);
+    } else if (lower_extension == "mbin") {
+        return morphio::readers::binary::decode({contents.data(), contents.size()},
+                                                "$STRING$",
+                                                warning_handler.get(),
+                                                nullptr,
+                                                options);
     }
 
     throw(morphio::UnknownFileType("Unhandled file type: '" + lower_extension +
-                                   "' only SWC, ASC and H5 are supported"));
+                                   "' only SWC, ASC, H5 and MBIN are supported"));
 }
 
 }  // namespace
@@ -119,17 +118,30 @@ morphio::Property::Properties loadString(const std::string& contents,
 namespace morphio {
 
 Morphology::Morphology(const Property::Properties& properties, unsigned int options)
-    : properties_(std::make_shared<Property::Properties>(properties)) {
+    : Morphology(Property::Properties(properties), options) {}
+
+Morphology::Morphology(Property::Properties&& properties, unsigned int options)
+    : properties_(std::make_shared<Property::Properties>(std::move(properties))) {
     buildChildren(properties_);
 
     // For SWC and ASC, sanitization and modifier application are already taken care of by
     // their respective loaders
-    if (properties._cellLevel.fileFormat() == "h5" && options > 0) {
+    const auto& fileFormat = properties_->_cellLevel.fileFormat();
+    const unsigned int modifiers = options & ~static_cast<unsigned int>(POINT_COLUMNS);
+    if ((fileFormat == "h5" || fileFormat == "mbin") && modifiers > 0) {
         mut::Morphology mutable_morph(*this);
-        mutable_morph.applyModifiers(options);
+        // The mutable morphology holds its own copy, release the original
+        // arrays before building the modified ones.
+        properties_.reset();
+        mutable_morph.applyModifiers(modifiers);
         properties_ = std::make_shared<Property::Properties>(mutable_morph.buildReadOnly());
         buildChildren(properties_);
     }
+
+    // The h5 and mbin readers fill the columns directly, unless modified above
+    if (options & POINT_COLUMNS) {
+        properties_->_pointLevel.storeColumns();
+    }
 }
 
 Morphology::Morphology(const std::string& path,
@@ -140,7 +152,7 @@ Morphology::Morphology(const std::string& path,
 Morphology::Morphology(const HighFive::Group& group,
                        unsigned int options,
                        std::shared_ptr<WarningHandler> warning_handler)
-    : Morphology(readers::h5::load(group, warning_handler.get()), options) {}
+    : Morphology(readers::h5::load(group, warning_handler.get(), options), options) {}
 
 Morphology::Morphology(const mut::Morphology& morphology) {
     properties_ = std::make_shared<Property::Properties>(morphology.buildReadOnly());
@@ -178,15 +190,9 @@ Section Morphology::section(uint32_t id) const {
 }
 
 std::vector<Section> Morphology::rootSections() const {
-    const auto& sections = properties_->children<morphio::Property::Section>();
-
-    if (sections.empty()) {
-        return {};
-    }
+    const auto children = childrenIds(-1);
 
     std::vector<Section> result;
-
-    const std::vector<uint32_t>& children = sections.at(-1);
     result.reserve(children.size());
     for (auto id : children) {
         result.push_back(section(id));
@@ -207,16 +213,16 @@ std::vector<Section> Morphology::sections() const {
 }
 
 template <typename Property>
-const std::vector<typename Property::Type>& Morphology::get() const {
+range<const typename Property::Type> Morphology::get() const {
     return properties_->get<Property>();
 }
 
-const Points& Morphology::points() const noexcept {
+range<const Point> Morphology::points() const {
     return get<Property::Point>();
 }
 
 std::vector<uint32_t> Morphology::sectionOffsets() const {
-    const std::vector<Property::Section::Type>& indices_and_parents = get<Property::Section>();
+    const auto indices_and_parents = get<Property::Section>();
     auto size = indices_and_parents.size();
     std::vector<uint32_t> indices(size + 1);
     std::transform(indices_and_parents.begin(),
@@ -227,15 +233,19 @@ std::vector<uint32_t> Morphology::sectionOffsets() const {
     return indices;
 }
 
-const std::vector<morphio::floatType>& Morphology::diameters() const {
+range<const morphio::floatType> Morphology::diameters() const {
     return get<Property::Diameter>();
 }
 
-const std::vector<morphio::floatType>& Morphology::perimeters() const {
+range<const morphio::floatType> Morphology::perimeters() const {
     return get<Property::Perimeter>();
 }
 
-const std::vector<SectionType>& Morphology::sectionTypes() const {
+Property::PointColumns Morphology::pointColumns() const {
+    return Property::PointColumns(properties_->_pointLevel);
+}
+
+range<const SectionType> Morphology::sectionTypes() const {
     return get<Property::SectionType>();
 }
 
@@ -247,8 +257,113 @@ const SomaType& Morphology::somaType() const {
     return properties_->somaType();
 }
 
-const std::map<int, std::vector<unsigned int>>& Morphology::connectivity() const {
-    return properties_->children<Property::Section>();
+std::map<int, std::vector<unsigned int>> Morphology::connectivity() const {
+    return properties_->children<Property::Section>().toMap();
+}
+
+range<const uint32_t> Morphology::childrenIds(int32_t sectionId) const noexcept {
+    return properties_->children<Property::Section>().of(sectionId);
+}
+
+std::vector<uint32_t> Morphology::sectionOrder(SectionOrder order) const {
+    if (order == SectionOrder::DEPTH_FIRST) {
+        return properties_->sectionTopology()._depthFirst;
+    }
+    if (order == SectionOrder::BREADTH_FIRST) {
+        return properties_->sectionTopology()._breadthFirst;
+    }
+
+    // Same as the NRN_ORDER modifier: neurites sorted by section type
+    const auto& children = properties_->children<Property::Section>();
+    const auto roots = children.of(-1);
+    const auto types = sectionTypes();
+    std::vector<uint32_t> sorted(roots.begin(), roots.end());
+    std::stable_sort(sorted.begin(), sorted.end(), [&types](uint32_t a, uint32_t b) {
+        return types[a] < types[b];
+    });
+
+    std::vector<uint32_t> ids;
+    ids.reserve(properties_->get<Property::Section>().size());
+    children.depthFirst(sorted, ids);
+    return ids;
+}
+
+range<const uint32_t> Morphology::depthFirstOrder() const {
+    return properties_->sectionTopology()._depthFirst;
+}
+
+range<const uint32_t> Morphology::breadthFirstOrder() const {
+    return properties_->sectionTopology()._breadthFirst;
+}
+
+range<const uint32_t> Morphology::postOrder() const {
+    return properties_->sectionTopology()._postOrder;
+}
+
+range<const uint32_t> Morphology::sectionDepths() const {
+    return properties_->sectionTopology()._depths;
+}
+
+range<const uint32_t> Morphology::subtreeSizes() const {
+    return properties_->sectionTopology()._subtreeSizes;
+}
+
+range<const floatType> Morphology::sectionLengths() const {
+    return properties_->sectionAggregates()._lengths;
+}
+
+range<const floatType> Morphology::sectionAreas() const {
+    return properties_->sectionAggregates()._areas;
+}
+
+range<const floatType> Morphology::sectionVolumes() const {
+    return properties_->sectionAggregates()._volumes;
+}
+
+range<const std::array<Point, 2>> Morphology::sectionBoundingBoxes() const {
+    return properties_->sectionAggregates()._boundingBoxes;
+}
+
+const SpatialIndex& Morphology::spatialIndex() const {
+    return properties_->spatialIndex();
+}
+
+Morphology Morphology::transformed(const AffineTransform& transform) const {
+    const Property::Properties& source = *properties_;
+
+    // Everything but the points is copied as is, including the children
+    // indices; the caches start empty and are computed again on first use.
+    Property::Properties properties;
+    properties._sectionLevel = source._sectionLevel;
+    properties._cellLevel = source._cellLevel;
+    properties._somaLevel = source._somaLevel;
+    properties._mitochondriaPointLevel = source._mitochondriaPointLevel;
+    properties._mitochondriaSectionLevel = source._mitochondriaSectionLevel;
+    properties._endoplasmicReticulumLevel = source._endoplasmicReticulumLevel;
+    properties._dendriticSpineLevel = source._dendriticSpineLevel;
+
+    const auto points = source.get<Property::Point>();
+    const auto diameters = source.get<Property::Diameter>();
+    const auto perimeters = source.get<Property::Perimeter>();
+    std::vector<Point> newPoints(points.size());
+    morphio::transform(points, newPoints, transform);
+    properties._pointLevel = Property::PointLevel(std::move(newPoints),
+                                                  {diameters.begin(), diameters.end()},
+                                                  {perimeters.begin(), perimeters.end()});
+    if (source._pointLevel.hasColumns()) {
+        properties._pointLevel.storeColumns();
+    }
+
+    properties._somaLevel.own();
+    morphio::transform(properties._somaLevel._points, transform);
+    for (auto& marker : properties._cellLevel._markers) {
+        marker._pointLevel.own();
+        morphio::transform(marker._pointLevel._points, transform);
+    }
+
+    Morphology result(*this);
+    result.properties_ = std::make_shared<Property::Properties>(std::move(properties));
+    return result;
 }
 
 const MorphologyVersion& Morphology::version() const {
@@ -0,0 +1,182 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::min, std::max
+#include <cmath>      // std::sqrt
+#include <stdexcept>  // std::invalid_argument
+#include <string>
+
+#include <morphio/morphology.h>
+#include <morphio/morphometrics.h>
+#include <morphio/soma.h>
+
+namespace morphio {
+namespace morphometrics {
+
+namespace {
+
+/**
+ * Fill `values` with `kernel(i)` for the segment starting at each point `i`.
+ *
+ * The kernel is applied to all consecutive points, without any branch in the
+ * loop such that it can be vectorized; the values across two sections are
+ * then reset.
+ */
+template <typename Kernel>
+std::vector<floatType> perSegment(size_t nPoints,
+                                  range<const uint32_t> sectionOffsets,
+                                  const Kernel& kernel) {
+    std::vector<floatType> values(nPoints, 0);
+    for (size_t i = 0; i + 1 < nPoints; ++i) {
+        values[i] = kernel(i);
+    }
+
+    for (size_t s = 1; s < sectionOffsets.size(); ++s) {
+        const uint32_t end = std::min(sectionOffsets[s], static_cast<uint32_t>(nPoints));
+        if (end > sectionOffsets[s - 1]) {
+            values[end - 1] = 0;
+        }
+    }
+    return values;
+}
+
+floatType segmentLength(const Point& start, const Point& end) {
+    const floatType dx = end[0] - start[0];
+    const floatType dy = end[1] - start[1];
+    const floatType dz = end[2] - start[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+void checkDiameters(range<const Point> points, range<const floatType> diameters) {
+    if (diameters.size() != points.size()) {
+        throw std::invalid_argument("Expected one diameter per point, got " +
+                                    std::to_string(diameters.size()) + " for " +
+                                    std::to_string(points.size()) + " points.");
+    }
+}
+
+}  // namespace
+
+std::vector<floatType> segmentLengths(range<const Point> points,
+                                      range<const uint32_t> sectionOffsets) {
+    const Point* p = points.data();
+    return perSegment(points.size(), sectionOffsets, [p](size_t i) {
+        return segmentLength(p[i], p[i + 1]);
+    });
+}
+
+std::vector<floatType> segmentVolumes(range<const Point> points,
+                                      range<const floatType> diameters,
+                                      range<const uint32_t> sectionOffsets) {
+    checkDiameters(points, diameters);
+    const Point* p = points.data();
+    const floatType* d = diameters.data();
+    return perSegment(points.size(), sectionOffsets, [p, d](size_t i) {
+        const floatType r0 = d[i] / 2;
+        const floatType r1 = d[i + 1] / 2;
+        return PI * segmentLength(p[i], p[i + 1]) * (r0 * r0 + r0 * r1 + r1 * r1) / 3;
+    });
+}
+
+std::vector<floatType> segmentLateralAreas(range<const Point> points,
+                                           range<const floatType> diameters,
+                                           range<const uint32_t> sectionOffsets) {
+    checkDiameters(points, diameters);
+    const Point* p = points.data();
+    const floatType* d = diameters.data();
+    return perSegment(points.size(), sectionOffsets, [p, d](size_t i) {
+        const floatType r0 = d[i] / 2;
+        const floatType r1 = d[i + 1] / 2;
+        const floatType length = segmentLength(p[i], p[i + 1]);
+        return PI * (r0 + r1) * std::sqrt((r0 - r1) * (r0 - r1) + length * length);
+    });
+}
+
+std::vector<floatType> sectionSums(range<const floatType> segmentValues,
+                                   range<const uint32_t> sectionOffsets) {
+    if (sectionOffsets.empty()) {
+        return {};
+    }
+
+    std::vector<floatType> sums(sectionOffsets.size() - 1, 0);
+    for (size_t s = 0; s < sums.size(); ++s) {
+        const uint32_t end = std::min(sectionOffsets[s + 1],
+                                      static_cast<uint32_t>(segmentValues.size()));
+        floatType sum = 0;
+        for (uint32_t i = sectionOffsets[s]; i < end; ++i) {
+            sum += segmentValues[i];
+        }
+        sums[s] = sum;
+    }
+    return sums;
+}
+
+std::vector<floatType> radialDistances(range<const Point> points, const Point& origin) {
+    std::vector<floatType> distances(points.size());
+    const Point* p = points.data();
+    for (size_t i = 0; i < distances.size(); ++i) {
+        distances[i] = segmentLength(origin, p[i]);
+    }
+    return distances;
+}
+
+BoundingBox boundingBox(range<const Point> points) {
+    if (points.empty()) {
+        return {};
+    }
+
+    BoundingBox box{points[0], points[0]};
+    for (const auto& point : points) {
+        for (size_t i = 0; i < 3; ++i) {
+            box[0][i] = std::min(box[0][i], point[i]);
+            box[1][i] = std::max(box[1][i], point[i]);
+        }
+    }
+    return box;
+}
+
+std::vector<floatType> segmentLengths(const Morphology& morphology) {
+    return segmentLengths(morphology.points(), morphology.sectionOffsets());
+}
+
+std::vector<floatType> segmentVolumes(const Morphology& morphology) {
+    return segmentVolumes(morphology.points(),
+                          morphology.diameters(),
+                          morphology.sectionOffsets());
+}
+
+std::vector<floatType> segmentLateralAreas(const Morphology& morphology) {
+    return segmentLateralAreas(morphology.points(),
+                               morphology.diameters(),
+                               morphology.sectionOffsets());
+}
+
+BoundingBox boundingBox(const Morphology& morphology) {
+    return boundingBox(morphology.points());
+}
+
+std::vector<floatType> radialDistances(const Morphology& morphology) {
+    const auto soma = morphology.soma();
+    const Point origin = soma.points().empty() ? Point{0, 0, 0} : soma.center();
+    return radialDistances(morphology.points(), origin);
+}
+
+std::vector<floatType> sectionPathDistances(const Morphology& morphology) {
+    const auto lengths = morphology.sectionLengths();
+    std::vector<floatType> distances(lengths.size(), 0);
+
+    // Parents come before their children in depth first order
+    for (uint32_t root : morphology.childrenIds(-1)) {
+        distances[root] = lengths[root];
+    }
+    for (uint32_t id : morphology.depthFirstOrder()) {
+        for (uint32_t child : morphology.childrenIds(static_cast<int32_t>(id))) {
+            distances[child] = distances[id] + lengths[child];
+        }
+    }
+    return distances;
+}
+
+}  // namespace morphometrics
+}  // namespace morphio
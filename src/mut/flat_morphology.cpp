@@ -0,0 +1,685 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::copy, std::find, std::max, std::stable_sort
+
+#include <morphio/morphology.h>
+#include <morphio/mut/flat_morphology.h>
+#include <morphio/mut/modifiers.h>
+
+#include "../error_message_generation.h"
+
+namespace morphio {
+namespace mut {
+
+namespace {
+
+// Points per chunk; sections with more points get a chunk of their own
+constexpr uint32_t chunkSize = 1 << 16;
+
+template <typename T>
+range<T> slice(std::vector<T>& data, uint32_t begin, uint32_t size) {
+    return {data.data() + begin, size};
+}
+
+template <typename T>
+range<const T> slice(const std::vector<T>& data, uint32_t begin, uint32_t size) {
+    return {data.data() + begin, size};
+}
+
+}  // namespace
+
+FlatMorphology::FlatMorphology(std::shared_ptr<WarningHandler> warning_handler)
+    : _handler(warning_handler != nullptr ? warning_handler : morphio::getWarningHandler()) {}
+
+FlatMorphology::FlatMorphology(const morphio::Morphology& morphology,
+                               unsigned int options,
+                               std::shared_ptr<WarningHandler> warning_handler)
+    : _soma(morphology.soma())
+    , _cellLevel(morphology.properties_->_cellLevel)
+    , _mitochondriaPointLevel(morphology.properties_->_mitochondriaPointLevel)
+    , _mitochondriaSectionLevel(morphology.properties_->_mitochondriaSectionLevel)
+    , _endoplasmicReticulumLevel(morphology.properties_->_endoplasmicReticulumLevel)
+    , _dendriticSpineLevel(morphology.properties_->_dendriticSpineLevel)
+    , _handler(warning_handler != nullptr ? warning_handler : morphio::getWarningHandler()) {
+    const auto points = morphology.points();
+    const auto diameters = morphology.diameters();
+    const auto perimeters = morphology.perimeters();
+    const auto offsets = morphology.sectionOffsets();
+    const auto sections = morphology.properties_->get<Property::Section>();
+    const auto types = morphology.sectionTypes();
+    _hasPerimeters = !perimeters.empty();
+
+    // All the points go to a single chunk, sections are appended depth first
+    std::vector<SectionHandle> newHandles(types.size());
+    _slots.reserve(types.size());
+    if (!points.empty()) {
+        _chunks.emplace_back();
+        Chunk& chunk = _chunks.back();
+        chunk.points.reserve(std::max(static_cast<size_t>(chunkSize), points.size()));
+        chunk.diameters.reserve(chunk.points.capacity());
+        if (_hasPerimeters) {
+            chunk.perimeters.reserve(chunk.points.capacity());
+        }
+    }
+
+    for (const uint32_t oldId : morphology.depthFirstOrder()) {
+        const auto index = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+        Slot& slot = _slots.back();
+        slot.id = _counter++;
+        slot.live = true;
+        slot.type = types[oldId];
+        newHandles[oldId] = {index, 0};
+
+        const uint32_t begin = offsets[oldId];
+        const uint32_t end = offsets[oldId + 1];
+        if (begin != end) {
+            Chunk& chunk = _chunks.back();
+            slot.extent = {0, chunk.used, end - begin};
+            chunk.points.insert(chunk.points.end(), points.begin() + begin, points.begin() + end);
+            chunk.diameters.insert(
+                chunk.diameters.end(), diameters.begin() + begin, diameters.begin() + end);
+            if (_hasPerimeters) {
+                chunk.perimeters.insert(
+                    chunk.perimeters.end(), perimeters.begin() + begin, perimeters.begin() + end);
+            }
+            chunk.used += end - begin;
+            _livePoints += end - begin;
+        } else {
+            _handler->emit(std::make_shared<AppendingEmptySection>(_uri, slot.id));
+        }
+
+        const int32_t oldParent = sections[oldId][1];
+        if (oldParent < 0) {
+            _rootSections.push_back(newHandles[oldId]);
+        } else {
+            const SectionHandle parent = newHandles[static_cast<size_t>(oldParent)];
+            slot.parent = parent;
+            linkChild(parent.index, index);
+        }
+    }
+    if (!_chunks.empty()) {
+        // Leave room for the sections appended later
+        Chunk& chunk = _chunks.back();
+        chunk.points.resize(chunk.points.capacity());
+        chunk.diameters.resize(chunk.points.size());
+        if (_hasPerimeters) {
+            chunk.perimeters.resize(chunk.points.size());
+        }
+    }
+
+    applyModifiers(options);
+}
+
+bool FlatMorphology::contains(SectionHandle section) const noexcept {
+    return section.index < _slots.size() && _slots[section.index].live &&
+           _slots[section.index].generation == section.generation;
+}
+
+const FlatMorphology::Slot& FlatMorphology::slot(SectionHandle section) const {
+    if (!contains(section)) {
+        throw SectionBuilderError("Section " + std::to_string(section.index) +
+                                  " does not exist, or has been deleted");
+    }
+    return _slots[section.index];
+}
+
+FlatMorphology::Slot& FlatMorphology::slot(SectionHandle section) {
+    return const_cast<Slot&>(static_cast<const FlatMorphology*>(this)->slot(section));
+}
+
+uint32_t FlatMorphology::id(SectionHandle section) const {
+    return slot(section).id;
+}
+
+std::vector<SectionHandle> FlatMorphology::children(SectionHandle section) const {
+    std::vector<SectionHandle> children;
+    for (uint32_t child = slot(section).firstChild; child != SectionHandle::invalidIndex;
+         child = _slots[child].nextSibling) {
+        children.push_back(handle(child));
+    }
+    return children;
+}
+
+SectionHandle FlatMorphology::parent(SectionHandle section) const {
+    return slot(section).parent;
+}
+
+bool FlatMorphology::isRoot(SectionHandle section) const {
+    return slot(section).parent.index == SectionHandle::invalidIndex;
+}
+
+SectionType FlatMorphology::type(SectionHandle section) const {
+    return slot(section).type;
+}
+
+void FlatMorphology::setType(SectionHandle section, SectionType type) {
+    if (type == SECTION_SOMA) {
+        throw SectionBuilderError("Cannot create section with type soma");
+    }
+    slot(section).type = type;
+}
+
+range<Point> FlatMorphology::points(SectionHandle section) {
+    const Extent& extent = slot(section).extent;
+    if (extent.size == 0) {
+        return {};
+    }
+    return slice(_chunks[extent.chunk].points, extent.begin, extent.size);
+}
+
+range<const Point> FlatMorphology::points(SectionHandle section) const {
+    const Extent& extent = slot(section).extent;
+    return extent.size == 0 ? range<const Point>()
+                            : slice(_chunks[extent.chunk].points, extent.begin, extent.size);
+}
+
+range<floatType> FlatMorphology::diameters(SectionHandle section) {
+    const Extent& extent = slot(section).extent;
+    if (extent.size == 0) {
+        return {};
+    }
+    return slice(_chunks[extent.chunk].diameters, extent.begin, extent.size);
+}
+
+range<const floatType> FlatMorphology::diameters(SectionHandle section) const {
+    const Extent& extent = slot(section).extent;
+    return extent.size == 0 ? range<const floatType>()
+                            : slice(_chunks[extent.chunk].diameters, extent.begin, extent.size);
+}
+
+range<floatType> FlatMorphology::perimeters(SectionHandle section) {
+    const Extent& extent = slot(section).extent;
+    if (!_hasPerimeters || extent.size == 0) {
+        return {};
+    }
+    return slice(_chunks[extent.chunk].perimeters, extent.begin, extent.size);
+}
+
+range<const floatType> FlatMorphology::perimeters(SectionHandle section) const {
+    const Extent& extent = slot(section).extent;
+    if (!_hasPerimeters || extent.size == 0) {
+        return {};
+    }
+    return slice(_chunks[extent.chunk].perimeters, extent.begin, extent.size);
+}
+
+void FlatMorphology::setPoints(SectionHandle section, const Property::PointLevel& points) {
+    checkPointLevel(points);
+    Extent& extent = slot(section).extent;
+    const auto size = static_cast<uint32_t>(points._points.size());
+    if (size <= extent.size) {
+        // Shrink in place
+        _livePoints -= extent.size - size;
+        _garbagePoints += extent.size - size;
+        extent.size = size;
+    } else {
+        release(extent);
+        extent = allocate(size);
+    }
+    store(extent, points);
+    reclaim();
+}
+
+SectionHandle FlatMorphology::appendRootSection(const Property::PointLevel& points,
+                                                SectionType type) {
+    const auto section = newSection(SectionHandle{}, points, type);
+    _rootSections.push_back(section);
+    return section;
+}
+
+SectionHandle FlatMorphology::appendSection(SectionHandle parent,
+                                            const Property::PointLevel& points,
+                                            SectionType type) {
+    if (type == SECTION_UNDEFINED) {
+        type = slot(parent).type;
+    }
+    if (type == SECTION_SOMA) {
+        throw SectionBuilderError("Cannot create section with type soma");
+    }
+
+    slot(parent);  // the parent must exist
+    const auto section = newSection(parent, points, type);
+    linkChild(parent.index, section.index);
+    return section;
+}
+
+void FlatMorphology::deleteSection(SectionHandle section, bool recursive) {
+    const SectionHandle parent = slot(section).parent;
+    const bool isRoot = parent.index == SectionHandle::invalidIndex;
+
+    if (recursive) {
+        if (isRoot) {
+            _rootSections.erase(
+                std::find(_rootSections.begin(), _rootSections.end(), section));
+        } else {
+            unlink(section.index);
+        }
+        std::vector<SectionHandle> stack{section};
+        while (!stack.empty()) {
+            const SectionHandle current = stack.back();
+            stack.pop_back();
+            pushChildren(stack, current.index);
+            freeSlot(current.index);
+        }
+    } else if (isRoot) {
+        // The children become root sections, in place of the deleted section
+        const auto children = this->children(section);
+        for (const SectionHandle& child : children) {
+            Slot& childSlot = _slots[child.index];
+            childSlot.parent = {};
+            childSlot.previousSibling = SectionHandle::invalidIndex;
+            childSlot.nextSibling = SectionHandle::invalidIndex;
+        }
+        const auto position = std::find(_rootSections.begin(), _rootSections.end(), section);
+        _rootSections.insert(_rootSections.erase(position), children.begin(), children.end());
+        freeSlot(section.index);
+    } else {
+        // The children take the place of the deleted section among its siblings
+        const Slot& deleted = _slots[section.index];
+        const uint32_t first = deleted.firstChild;
+        const uint32_t last = deleted.lastChild;
+        if (first == SectionHandle::invalidIndex) {
+            unlink(section.index);
+        } else {
+            for (uint32_t child = first; child != SectionHandle::invalidIndex;
+                 child = _slots[child].nextSibling) {
+                _slots[child].parent = parent;
+            }
+            Slot& parentSlot = _slots[parent.index];
+            const uint32_t previous = deleted.previousSibling;
+            const uint32_t next = deleted.nextSibling;
+            _slots[first].previousSibling = previous;
+            _slots[last].nextSibling = next;
+            if (previous == SectionHandle::invalidIndex) {
+                parentSlot.firstChild = first;
+            } else {
+                _slots[previous].nextSibling = first;
+            }
+            if (next == SectionHandle::invalidIndex) {
+                parentSlot.lastChild = last;
+            } else {
+                _slots[next].previousSibling = last;
+            }
+        }
+        freeSlot(section.index);
+    }
+    reclaim();
+}
+
+void FlatMorphology::removeUnifurcations() {
+    std::vector<SectionHandle> stack(_rootSections.rbegin(), _rootSections.rend());
+    while (!stack.empty()) {
+        const SectionHandle section = stack.back();
+        stack.pop_back();
+        // Captured before merging, which moves them to the parent
+        pushChildren(stack, section.index);
+
+        const SectionHandle parent = _slots[section.index].parent;
+        if (parent.index == SectionHandle::invalidIndex ||
+            _slots[parent.index].firstChild != _slots[parent.index].lastChild) {
+            continue;
+        }
+
+        const uint32_t sectionId = _slots[section.index].id;
+        _handler->emit(std::make_shared<OnlyChild>(_uri, _slots[parent.index].id, sectionId));
+
+        const auto childPoints = points(section);
+        const auto childDiameters = diameters(section);
+        const auto childPerimeters = perimeters(section);
+        _cellLevel._annotations.emplace_back(
+            AnnotationType::SINGLE_CHILD,
+            sectionId,
+            Property::PointLevel({childPoints.begin(), childPoints.end()},
+                                 {childDiameters.begin(), childDiameters.end()},
+                                 {childPerimeters.begin(), childPerimeters.end()}),
+            "SingleChild",
+            -1);
+
+        // Like mut::Morphology, the first point is skipped when it duplicates the
+        // last point of the parent, or when the parent is empty
+        const auto parentPoints = points(parent);
+        const bool duplicate = parentPoints.empty() ||
+                               (!childPoints.empty() && parentPoints.back() == childPoints[0]);
+        const uint32_t skip = duplicate && !childPoints.empty() ? 1 : 0;
+        const Extent child = _slots[section.index].extent;
+        Extent& extent = _slots[parent.index].extent;
+        const uint32_t parentSize = extent.size;
+        const uint32_t size = parentSize + child.size - skip;
+
+        Chunk* chunk = extent.size == 0 ? nullptr : &_chunks[extent.chunk];
+        if (chunk != nullptr && chunk->used == extent.begin + extent.size &&
+            extent.begin + size <= chunk->points.size()) {
+            // The parent ends its chunk, it grows in place
+            chunk->used = extent.begin + size;
+            _livePoints += child.size - skip;
+        } else {
+            const Extent grown = allocate(size);
+            copy(extent, grown);
+            release(extent);
+            extent = grown;
+        }
+        copy({child.chunk, child.begin + skip, child.size - skip},
+             {extent.chunk, extent.begin + parentSize, child.size - skip});
+        extent.size = size;
+
+        deleteSection(section, false);
+    }
+    reclaim();
+}
+
+void FlatMorphology::applyModifiers(unsigned int modifierFlags) {
+    if ((modifierFlags & NO_DUPLICATES) && (modifierFlags & TWO_POINTS_SECTIONS)) {
+        const auto err = details::ErrorMessages(_uri);
+        throw SectionBuilderError(err.ERROR_UNCOMPATIBLE_FLAGS(NO_DUPLICATES, TWO_POINTS_SECTIONS));
+    }
+
+    if (modifierFlags & SOMA_SPHERE) {
+        modifiers::soma_sphere(_soma);
+    }
+
+    for (Slot& section : _slots) {
+        if (!section.live) {
+            continue;
+        }
+        Extent& extent = section.extent;
+        if ((modifierFlags & NO_DUPLICATES) && extent.size > 0 &&
+            section.parent.index != SectionHandle::invalidIndex) {
+            ++extent.begin;
+            --extent.size;
+            --_livePoints;
+            ++_garbagePoints;
+        }
+        if ((modifierFlags & TWO_POINTS_SECTIONS) && extent.size > 2) {
+            copy({extent.chunk, extent.begin + extent.size - 1, 1},
+                 {extent.chunk, extent.begin + 1, 1});
+            _livePoints -= extent.size - 2;
+            _garbagePoints += extent.size - 2;
+            extent.size = 2;
+        }
+    }
+
+    if (modifierFlags & NRN_ORDER) {
+        std::stable_sort(_rootSections.begin(),
+                         _rootSections.end(),
+                         [this](const SectionHandle& a, const SectionHandle& b) {
+                             return _slots[a.index].type < _slots[b.index].type;
+                         });
+    }
+    reclaim();
+}
+
+Property::Properties FlatMorphology::buildReadOnly() const {
+    Property::Properties properties{};
+    properties._cellLevel = _cellLevel;
+    properties._cellLevel._somaType = _soma.type();
+    properties._somaLevel = _soma.properties();
+
+    const auto order = depthFirstOrder();
+    auto& pointLevel = properties._pointLevel;
+    pointLevel._points.reserve(_livePoints);
+    pointLevel._diameters.reserve(_livePoints);
+    if (_hasPerimeters) {
+        pointLevel._perimeters.reserve(_livePoints);
+    }
+    properties._sectionLevel._sections.reserve(order.size());
+    properties._sectionLevel._sectionTypes.reserve(order.size());
+
+    // Indexed by slot; parents are written before their children
+    std::vector<int32_t> newIds(_slots.size(), -1);
+    for (const SectionHandle& section : order) {
+        const Slot& current = _slots[section.index];
+        const int32_t parent = current.parent.index == SectionHandle::invalidIndex
+                                   ? -1
+                                   : newIds[current.parent.index];
+        newIds[section.index] = static_cast<int32_t>(properties._sectionLevel._sections.size());
+        properties._sectionLevel._sections.push_back(
+            {static_cast<int>(pointLevel._points.size()), parent});
+        properties._sectionLevel._sectionTypes.push_back(current.type);
+
+        const Extent& extent = current.extent;
+        if (extent.size == 0) {
+            continue;
+        }
+        const Chunk& chunk = _chunks[extent.chunk];
+        const auto begin = static_cast<std::ptrdiff_t>(extent.begin);
+        const auto end = begin + static_cast<std::ptrdiff_t>(extent.size);
+        pointLevel._points.insert(
+            pointLevel._points.end(), chunk.points.begin() + begin, chunk.points.begin() + end);
+        pointLevel._diameters.insert(pointLevel._diameters.end(),
+                                     chunk.diameters.begin() + begin,
+                                     chunk.diameters.begin() + end);
+        if (_hasPerimeters) {
+            pointLevel._perimeters.insert(pointLevel._perimeters.end(),
+                                          chunk.perimeters.begin() + begin,
+                                          chunk.perimeters.begin() + end);
+        }
+    }
+
+    properties._mitochondriaPointLevel = _mitochondriaPointLevel;
+    properties._mitochondriaSectionLevel = _mitochondriaSectionLevel;
+    properties._endoplasmicReticulumLevel = _endoplasmicReticulumLevel;
+    properties._dendriticSpineLevel = _dendriticSpineLevel;
+    return properties;
+}
+
+void FlatMorphology::checkPointLevel(const Property::PointLevel& points) {
+    if (points._points.size() != points._diameters.size()) {
+        throw SectionBuilderError("Point vector have size: " +
+                                  std::to_string(points._points.size()) +
+                                  " while Diameter vector has size: " +
+                                  std::to_string(points._diameters.size()));
+    }
+
+    const bool hasPerimeters = !points._perimeters.empty();
+    if (hasPerimeters && points._perimeters.size() != points._points.size()) {
+        throw SectionBuilderError("Point vector have size: " +
+                                  std::to_string(points._points.size()) +
+                                  " while Perimeter vector has size: " +
+                                  std::to_string(points._perimeters.size()));
+    }
+    if (size() == 0) {
+        _hasPerimeters = hasPerimeters;
+        for (Chunk& chunk : _chunks) {
+            chunk.perimeters.resize(hasPerimeters ? chunk.points.size() : 0);
+        }
+    } else if (hasPerimeters != _hasPerimeters && !points._points.empty()) {
+        throw SectionBuilderError("Perimeters must be given for all sections or none");
+    }
+}
+
+SectionHandle FlatMorphology::newSection(SectionHandle parent,
+                                         const Property::PointLevel& points,
+                                         SectionType type) {
+    checkPointLevel(points);
+
+    uint32_t index = 0;
+    if (_freeSlots.empty()) {
+        index = static_cast<uint32_t>(_slots.size());
+        _slots.emplace_back();
+    } else {
+        index = _freeSlots.back();
+        _freeSlots.pop_back();
+    }
+
+    Slot& section = _slots[index];
+    section.id = _counter++;
+    section.live = true;
+    section.type = type;
+    section.parent = parent;
+    section.extent = allocate(static_cast<uint32_t>(points._points.size()));
+    store(section.extent, points);
+
+    if (points._points.empty()) {
+        _handler->emit(std::make_shared<AppendingEmptySection>(_uri, section.id));
+    }
+    return {index, section.generation};
+}
+
+void FlatMorphology::freeSlot(uint32_t index) {
+    Slot& section = _slots[index];
+    release(section.extent);
+    section.extent = {};
+    section.live = false;
+    section.parent = {};
+    section.firstChild = SectionHandle::invalidIndex;
+    section.lastChild = SectionHandle::invalidIndex;
+    section.previousSibling = SectionHandle::invalidIndex;
+    section.nextSibling = SectionHandle::invalidIndex;
+    ++section.generation;
+    _freeSlots.push_back(index);
+}
+
+void FlatMorphology::linkChild(uint32_t parent, uint32_t child) {
+    Slot& parentSlot = _slots[parent];
+    _slots[child].previousSibling = parentSlot.lastChild;
+    _slots[child].nextSibling = SectionHandle::invalidIndex;
+    if (parentSlot.lastChild == SectionHandle::invalidIndex) {
+        parentSlot.firstChild = child;
+    } else {
+        _slots[parentSlot.lastChild].nextSibling = child;
+    }
+    parentSlot.lastChild = child;
+}
+
+void FlatMorphology::unlink(uint32_t index) {
+    const Slot& section = _slots[index];
+    Slot& parentSlot = _slots[section.parent.index];
+    if (section.previousSibling == SectionHandle::invalidIndex) {
+        parentSlot.firstChild = section.nextSibling;
+    } else {
+        _slots[section.previousSibling].nextSibling = section.nextSibling;
+    }
+    if (section.nextSibling == SectionHandle::invalidIndex) {
+        parentSlot.lastChild = section.previousSibling;
+    } else {
+        _slots[section.nextSibling].previousSibling = section.previousSibling;
+    }
+}
+
+void FlatMorphology::pushChildren(std::vector<SectionHandle>& stack, uint32_t index) const {
+    for (uint32_t child = _slots[index].lastChild; child != SectionHandle::invalidIndex;
+         child = _slots[child].previousSibling) {
+        stack.push_back(handle(child));
+    }
+}
+
+FlatMorphology::Extent FlatMorphology::allocate(uint32_t size) {
+    if (size == 0) {
+        return {};
+    }
+    if (_chunks.empty() || _chunks.back().used + size > _chunks.back().points.size()) {
+        const uint32_t capacity = std::max(chunkSize, size);
+        _chunks.emplace_back();
+        Chunk& chunk = _chunks.back();
+        chunk.points.resize(capacity);
+        chunk.diameters.resize(capacity);
+        if (_hasPerimeters) {
+            chunk.perimeters.resize(capacity);
+        }
+    }
+
+    Chunk& chunk = _chunks.back();
+    const Extent extent{static_cast<uint32_t>(_chunks.size() - 1), chunk.used, size};
+    chunk.used += size;
+    _livePoints += size;
+    return extent;
+}
+
+void FlatMorphology::store(Extent& extent, const Property::PointLevel& points) {
+    extent.size = static_cast<uint32_t>(points._points.size());
+    if (extent.size == 0) {
+        return;
+    }
+    Chunk& chunk = _chunks[extent.chunk];
+    const auto begin = static_cast<std::ptrdiff_t>(extent.begin);
+    std::copy(points._points.begin(), points._points.end(), chunk.points.begin() + begin);
+    std::copy(points._diameters.begin(), points._diameters.end(), chunk.diameters.begin() + begin);
+    if (_hasPerimeters) {
+        std::copy(
+            points._perimeters.begin(), points._perimeters.end(), chunk.perimeters.begin() + begin);
+    }
+}
+
+void FlatMorphology::copy(const Extent& from, const Extent& to) {
+    if (from.size == 0) {
+        return;
+    }
+    const Chunk& source = _chunks[from.chunk];
+    Chunk& target = _chunks[to.chunk];
+    const auto begin = static_cast<std::ptrdiff_t>(from.begin);
+    const auto end = begin + static_cast<std::ptrdiff_t>(from.size);
+    const auto destination = static_cast<std::ptrdiff_t>(to.begin);
+    std::copy(source.points.begin() + begin,
+              source.points.begin() + end,
+              target.points.begin() + destination);
+    std::copy(source.diameters.begin() + begin,
+              source.diameters.begin() + end,
+              target.diameters.begin() + destination);
+    if (_hasPerimeters) {
+        std::copy(source.perimeters.begin() + begin,
+                  source.perimeters.begin() + end,
+                  target.perimeters.begin() + destination);
+    }
+}
+
+void FlatMorphology::release(const Extent& extent) {
+    _livePoints -= extent.size;
+    _garbagePoints += extent.size;
+}
+
+void FlatMorphology::reclaim() {
+    if (_garbagePoints > chunkSize && _garbagePoints > _livePoints) {
+        compact();
+    }
+}
+
+void FlatMorphology::compact() {
+    std::vector<Chunk> chunks;
+    std::swap(chunks, _chunks);
+    _livePoints = 0;
+    _garbagePoints = 0;
+
+    for (const SectionHandle& section : depthFirstOrder()) {
+        Extent& extent = _slots[section.index].extent;
+        if (extent.size == 0) {
+            continue;
+        }
+        const Extent moved = allocate(extent.size);
+        const Chunk& source = chunks[extent.chunk];
+        Chunk& target = _chunks[moved.chunk];
+        const auto begin = static_cast<std::ptrdiff_t>(extent.begin);
+        const auto end = begin + static_cast<std::ptrdiff_t>(extent.size);
+        const auto destination = static_cast<std::ptrdiff_t>(moved.begin);
+        std::copy(source.points.begin() + begin,
+                  source.points.begin() + end,
+                  target.points.begin() + destination);
+        std::copy(source.diameters.begin() + begin,
+                  source.diameters.begin() + end,
+                  target.diameters.begin() + destination);
+        if (_hasPerimeters) {
+            std::copy(source.perimeters.begin() + begin,
+                      source.perimeters.begin() + end,
+                      target.perimeters.begin() + destination);
+        }
+        extent = moved;
+    }
+}
+
+std::vector<SectionHandle> FlatMorphology::depthFirstOrder() const {
+    std::vector<SectionHandle> order;
+    order.reserve(size());
+    std::vector<SectionHandle> stack(_rootSections.rbegin(), _rootSections.rend());
+    while (!stack.empty()) {
+        const SectionHandle section = stack.back();
+        stack.pop_back();
+        order.push_back(section);
+        pushChildren(stack, section.index);
+    }
+    return order;
+}
+
+}  // namespace mut
+}  // namespace morphio
@@ -46,8 +46,11 @@ void no_duplicate_point(morphio::mut::Morphology& morpho) {
 }
 
 void soma_sphere(morphio::mut::Morphology& morpho) {
-    auto soma = morpho.soma();
-    const auto size = static_cast<morphio::floatType>(soma->points().size());
+    soma_sphere(*morpho.soma());
+}
+
+void soma_sphere(morphio::mut::Soma& soma) {
+    const auto size = static_cast<morphio::floatType>(soma.points().size());
 
     if (size < 2) {
         return;
@@ -58,13 +61,13 @@ void soma_sphere(morphio::mut::Morphology& morpho) {
     floatType z = 0;
     floatType r = 0;
 
-    for (const Point& point : soma->points()) {
+    for (const Point& point : soma.points()) {
         x += point[0] / size;
         y += point[1] / size;
         z += point[2] / size;
     }
 
-    for (auto point : soma->points()) {
+    for (auto point : soma.points()) {
 #ifdef MORPHIO_USE_DOUBLE
         r += sqrt(pow(point[0] - x, 2) + pow(point[1] - y, 2) + pow(point[2] - z, 2)) / size;
 #else
@@ -72,8 +75,8 @@ void soma_sphere(morphio::mut::Morphology& morpho) {
 #endif
     }
 
-    soma->points() = {{x, y, z}};
-    soma->diameters() = {r};
+    soma.points() = {{x, y, z}};
+    soma.diameters() = {r};
 }
 
 static bool NRN_order_comparator(std::shared_ptr<Section> a, std::shared_ptr<Section> b) {
@@ -87,8 +87,64 @@ Morphology::Morphology(const morphio::Morphology& morphology,
     , _endoplasmicReticulum(morphology.endoplasmicReticulum())
     , _dendriticSpineLevel(morphology.properties_->_dendriticSpineLevel)
     , _handler(warning_handler != nullptr ? warning_handler : morphio::getWarningHandler()) {
-    for (const morphio::Section& root : morphology.rootSections()) {
-        appendRootSection(root, true);
+    // Same sections and IDs as appending the root sections recursively, but the
+    // points are copied once from the flat arrays, and the sections are
+    // registered in increasing ID order, at the end of the maps.
+    const Property::Properties& properties = *morphology.properties_;
+    const auto points = properties.get<Property::Point>();
+    const auto diameters = properties.get<Property::Diameter>();
+    const auto perimeters = properties.get<Property::Perimeter>();
+    const auto sections = properties.get<Property::Section>();
+    const auto types = properties.get<Property::SectionType>();
+    const auto& childrenIndex = properties.children<Property::Section>();
+
+    // Indexed by the IDs of `morphology`
+    std::vector<uint32_t> newIds(sections.size());
+    std::vector<std::vector<std::shared_ptr<Section>>*> children(sections.size(), nullptr);
+
+    for (const uint32_t oldId : morphology.depthFirstOrder()) {
+        const uint32_t id = _counter++;
+        newIds[oldId] = id;
+
+        const auto begin = static_cast<size_t>(sections[oldId][0]);
+        const size_t end = oldId + 1 < sections.size()
+                               ? static_cast<size_t>(sections[oldId + 1][0])
+                               : points.size();
+        std::shared_ptr<Section> section(
+            new Section(this, id, types[oldId], Property::PointLevel()));
+        auto& level = section->point_properties_;
+        level._points.assign(points.begin() + begin, points.begin() + end);
+        level._diameters.assign(diameters.begin() + begin, diameters.begin() + end);
+        if (!perimeters.empty()) {
+            level._perimeters.assign(perimeters.begin() + begin, perimeters.begin() + end);
+        }
+        _sections.emplace_hint(_sections.end(), id, section);
+
+        const auto nChildren = childrenIndex.of(static_cast<int32_t>(oldId)).size();
+        if (nChildren > 0) {
+            children[oldId] =
+                &_children.emplace_hint(_children.end(), id, std::vector<SectionP>())->second;
+            children[oldId]->reserve(nChildren);
+        }
+
+        const int32_t oldParent = sections[oldId][1];
+        if (oldParent < 0) {
+            _rootSections.push_back(section);
+            if (level._points.empty()) {
+                getWarningHandler()->emit(std::make_shared<AppendingEmptySection>(_uri, id));
+            }
+            continue;
+        }
+
+        const uint32_t parentId = newIds[static_cast<size_t>(oldParent)];
+        const auto& parent = _sections.at(parentId);
+        if (level._points.empty()) {
+            getWarningHandler()->emit(std::make_shared<AppendingEmptySection>(_uri, id));
+        } else if (!_checkDuplicatePoint(parent, section)) {
+            getWarningHandler()->emit(std::make_shared<WrongDuplicate>(_uri, section, parent));
+        }
+        _parent.emplace_hint(_parent.end(), id, parentId);
+        children[static_cast<size_t>(oldParent)]->push_back(section);
     }
 
     for (const morphio::MitoSection& root : morphology.mitochondria().rootSections()) {
@@ -300,17 +356,36 @@ void Morphology::removeUnifurcations() {
 
 Property::Properties Morphology::buildReadOnly() const {
     int sectionIdOnDisk = 0;
-    std::map<uint32_t, int32_t> newIds;
+    // Indexed by section ID, -1 until the section is written; parents are
+    // written before their children
+    std::vector<int32_t> newIds(_counter, -1);
     Property::Properties properties{};
 
     properties._cellLevel = *_cellProperties;
     properties._cellLevel._somaType = _soma->type();
     appendProperties(properties._somaLevel, _soma->point_properties_);
 
+    // Size the arrays up front, growing them one section at a time would
+    // temporarily need up to twice their final size.
+    size_t nPoints = 0;
+    bool hasPerimeters = false;
+    for (const auto& it : _sections) {
+        nPoints += it.second->points().size();
+        hasPerimeters = hasPerimeters || !it.second->perimeters().empty();
+    }
+    properties._pointLevel._points.reserve(nPoints);
+    properties._pointLevel._diameters.reserve(nPoints);
+    if (hasPerimeters) {
+        properties._pointLevel._perimeters.reserve(nPoints);
+    }
+    properties._sectionLevel._sections.reserve(_sections.size());
+    properties._sectionLevel._sectionTypes.reserve(_sections.size());
+
     for (auto it = depth_begin(); it != depth_end(); ++it) {
         const std::shared_ptr<Section>& section = *it;
         unsigned int sectionId = section->id();
-        int parentOnDisk = (section->isRoot() ? -1 : newIds[section->parent()->id()]);
+        const auto parent = _parent.find(sectionId);
+        int parentOnDisk = parent == _parent.end() ? -1 : newIds[parent->second];
 
         auto start = static_cast<int>(properties._pointLevel._points.size());
         properties._sectionLevel._sections.push_back({start, parentOnDisk});
@@ -365,6 +440,17 @@ void Morphology::applyModifiers(unsigned int modifierFlags) {
     }
 }
 
+void Morphology::transform(const AffineTransform& transform) {
+    for (const auto& section : _sections) {
+        morphio::transform(section.second->points(), transform);
+    }
+    morphio::transform(_soma->points(), transform);
+    for (auto& marker : _cellProperties->_markers) {
+        marker._pointLevel.own();
+        morphio::transform(marker._pointLevel._points, transform);
+    }
+}
+
 std::unordered_map<int, std::vector<unsigned int>> Morphology::connectivity() {
     std::unordered_map<int, std::vector<unsigned int>> connectivity;
 
@@ -404,6 +490,8 @@ void Morphology::write(const std::string& filename) const {
         writer::asc(*this, filename, _handler);
     } else if (extension == ".swc") {
         writer::swc(*this, filename, _handler);
+    } else if (extension == ".mbin") {
+        writer::mbin(*this, filename, _handler);
     } else {
         const auto err = details::ErrorMessages(_uri);
         throw UnknownFileType(err.ERROR_WRONG_EXTENSION(filename));
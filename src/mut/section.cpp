@@ -21,7 +21,9 @@ Section::Section(Morphology* morphology,
     : morphology_(morphology)
     , point_properties_(pointProperties)
     , id_(id)
-    , section_type_(type) {}
+    , section_type_(type) {
+    point_properties_.own();
+}
 
 Section::Section(Morphology* morphology, unsigned int id, const morphio::Section& section)
     : Section(morphology,
@@ -11,11 +11,15 @@
 namespace morphio {
 namespace mut {
 Soma::Soma(const Property::PointLevel& point_properties)
-    : point_properties_(point_properties) {}
+    : point_properties_(point_properties) {
+    point_properties_.own();
+}
 
 Soma::Soma(const morphio::Soma& soma)
     : soma_type_(soma.type())
-    , point_properties_(soma.properties_->_somaLevel) {}
+    , point_properties_(soma.properties_->_somaLevel) {
+    point_properties_.own();
+}
 
 Point Soma::center() const {
     return centerOfGravity(points());
@@ -26,7 +30,7 @@ floatType Soma::surface() const {
 }
 
 floatType Soma::maxDistance() const {
-    return maxDistanceToCenterOfGravity(point_properties_._points);
+    return maxDistanceToCenterOfGravity(points());
 }
 
 }  // end namespace mut
@@ -0,0 +1,51 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <fstream>
+
+#include <morphio/exceptions.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/mut/writers.h>
+#include <morphio/warning_handling.h>
+
+#include "../error_message_generation.h"
+#include "../readers/morphologyBinary.h"
+#include "writer_utils.h"
+
+namespace morphio {
+namespace mut {
+namespace writer {
+
+void mbin(const Morphology& morph,
+          const std::string& filename,
+          std::shared_ptr<morphio::WarningHandler> handler) {
+    if (details::emptyMorphology(morph, handler)) {
+        throw morphio::WriterError(morphio::details::ErrorMessages().ERROR_EMPTY_MORPHOLOGY());
+    }
+
+    details::validateContourSoma(morph, handler);
+    details::checkSomaHasSameNumberPointsDiameters(*morph.soma());
+    details::validateRootPointsHaveTwoOrMorePoints(morph);
+
+    const Property::Properties properties = morph.buildReadOnly();
+
+    const auto numberOfPoints = properties.get<Property::Point>().size();
+    const auto numberOfPerimeters = properties.get<Property::Perimeter>().size();
+    if (numberOfPerimeters > 0 && numberOfPerimeters != numberOfPoints) {
+        throw WriterError(morphio::details::ErrorMessages().ERROR_VECTOR_LENGTH_MISMATCH(
+            "points", numberOfPoints, "perimeters", numberOfPerimeters));
+    }
+
+    const std::vector<char> bytes = readers::binary::encode(properties);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+        throw morphio::WriterError("Failed to write: " + filename);
+    }
+}
+
+}  // end namespace writer
+}  // end namespace mut
+}  // end namespace morphio
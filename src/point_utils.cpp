@@ -54,7 +54,7 @@ Point centerOfGravity(const range<const Point>& points) {
     return Point({x / count, y / count, z / count});
 }
 
-floatType maxDistanceToCenterOfGravity(const Points& points) {
+floatType maxDistanceToCenterOfGravity(const range<const Point>& points) {
     const auto c = centerOfGravity(points);
     return std::accumulate(std::begin(points),
                            std::end(points),
@@ -14,7 +14,7 @@ Point subtract(const Point& left, const Point& right);
 
 Point centerOfGravity(const range<const Point>& points);
 
-floatType maxDistanceToCenterOfGravity(const Points& points);
+floatType maxDistanceToCenterOfGravity(const range<const Point>& points);
 
 std::string dumpPoint(const Point& point);
 std::string dumpPoints(const range<const Point>& points);
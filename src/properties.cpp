@@ -3,8 +3,12 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>  // std::equal, std::max
+
 #include <morphio/errorMessages.h>
+#include <morphio/morphometrics.h>
 #include <morphio/properties.h>
+#include <morphio/spatial_index.h>
 #include <morphio/vector_types.h>
 
 #include "point_utils.h"
@@ -12,8 +16,8 @@
 
 namespace {
 
-bool compare_section_structure(const std::vector<morphio::Property::Section::Type>& vec1,
-                               const std::vector<morphio::Property::Section::Type>& vec2) {
+bool compare_section_structure(const morphio::range<const morphio::Property::Section::Type>& vec1,
+                               const morphio::range<const morphio::Property::Section::Type>& vec2) {
     if (vec1.size() != vec2.size()) {
         return false;
     }
@@ -27,6 +31,11 @@ bool compare_section_structure(const std::vector<morphio::Property::Section::Typ
     return true;
 }
 
+template <typename T>
+bool compare_range(const morphio::range<const T>& el1, const morphio::range<const T>& el2) {
+    return el1.size() == el2.size() && std::equal(el1.begin(), el1.end(), el2.begin());
+}
+
 }  // namespace
 
 
@@ -52,30 +61,355 @@ PointLevel::PointLevel(std::vector<Point::Type> points,
     }
 }
 
-PointLevel::PointLevel(const PointLevel& data)
-    : PointLevel(data._points, data._diameters, data._perimeters) {}
+ChildrenIndex::ChildrenIndex(range<const std::array<int, 2>> sections)
+    : _offsets(sections.size() + 3, 0)
+    , _children(sections.size()) {
+    // Counting sort of the sections by parent, slot `parent + 1` for each
+    // parent. Sections with an invalid parent are unreachable and skipped.
+    const auto nSlots = sections.size() + 1;
+    for (const auto& section : sections) {
+        const auto slot = static_cast<size_t>(section[1]) + 1;  // wraps to 0 for -1
+        if (section[1] >= -1 && slot < nSlots) {
+            ++_offsets[slot + 2];
+        }
+    }
+
+    for (size_t i = 2; i < _offsets.size(); ++i) {
+        _offsets[i] += _offsets[i - 1];
+    }
+
+    // Until the end of the loop, `_offsets[slot + 1]` is where the next
+    // child of `slot` goes; it ends up being the end of its children.
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const auto slot = static_cast<size_t>(sections[i][1]) + 1;
+        if (sections[i][1] >= -1 && slot < nSlots) {
+            _children[_offsets[slot + 1]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    _offsets.pop_back();
+    _children.resize(_offsets.back());
+}
+
+ChildrenIndex::ChildrenIndex(const std::map<int, std::vector<unsigned int>>& children) {
+    if (children.empty()) {
+        return;
+    }
+
+    const auto nSlots = static_cast<size_t>(std::max(children.rbegin()->first + 2, 1));
+    _offsets.assign(nSlots + 1, 0);
+    for (size_t slot = 0; slot < nSlots; ++slot) {
+        const auto it = children.find(static_cast<int>(slot) - 1);
+        if (it != children.end()) {
+            _children.insert(_children.end(), it->second.begin(), it->second.end());
+        }
+        _offsets[slot + 1] = static_cast<uint32_t>(_children.size());
+    }
+}
+
+std::map<int, std::vector<unsigned int>> ChildrenIndex::toMap() const {
+    std::map<int, std::vector<unsigned int>> children;
+    for (size_t slot = 0; slot + 1 < _offsets.size(); ++slot) {
+        const auto ids = of(static_cast<int32_t>(slot) - 1);
+        if (!ids.empty()) {
+            children[static_cast<int>(slot) - 1].assign(ids.begin(), ids.end());
+        }
+    }
+    return children;
+}
+
+void ChildrenIndex::depthFirst(range<const uint32_t> starts, std::vector<uint32_t>& order) const {
+    // Pushed in reverse, such that the smallest ID is popped first
+    std::vector<uint32_t> stack;
+    for (size_t i = starts.size(); i > 0; --i) {
+        stack.push_back(starts[i - 1]);
+    }
+
+    while (!stack.empty()) {
+        const uint32_t id = stack.back();
+        stack.pop_back();
+        order.push_back(id);
+
+        const auto children = of(static_cast<int32_t>(id));
+        for (size_t i = children.size(); i > 0; --i) {
+            stack.push_back(children[i - 1]);
+        }
+    }
+}
+
+void ChildrenIndex::breadthFirst(range<const uint32_t> starts, std::vector<uint32_t>& order) const {
+    // `order` is its own queue: the sections after `next` are yet to be expanded
+    size_t next = order.size();
+    order.insert(order.end(), starts.begin(), starts.end());
+    for (; next < order.size(); ++next) {
+        const auto children = of(static_cast<int32_t>(order[next]));
+        order.insert(order.end(), children.begin(), children.end());
+    }
+}
+
+SectionTopology::SectionTopology(const ChildrenIndex& children, size_t nSections)
+    : _depthFirstPosition(nSections, 0)
+    , _depths(nSections, 0)
+    , _subtreeSizes(nSections, 0) {
+    const auto roots = children.of(-1);
+    children.depthFirst(roots, _depthFirst);
+    children.breadthFirst(roots, _breadthFirst);
+
+    // Parents come before their children in pre-order...
+    for (size_t i = 0; i < _depthFirst.size(); ++i) {
+        const uint32_t id = _depthFirst[i];
+        _depthFirstPosition[id] = static_cast<uint32_t>(i);
+        for (uint32_t child : children.of(static_cast<int32_t>(id))) {
+            _depths[child] = _depths[id] + 1;
+        }
+    }
+
+    // ... and after them in reverse pre-order
+    for (size_t i = _depthFirst.size(); i > 0; --i) {
+        const uint32_t id = _depthFirst[i - 1];
+        uint32_t size = 1;
+        for (uint32_t child : children.of(static_cast<int32_t>(id))) {
+            size += _subtreeSizes[child];
+        }
+        _subtreeSizes[id] = size;
+    }
+
+    // In post-order, a section comes after its whole subtree, minus the
+    // ancestors that come before it in pre-order
+    _postOrder.resize(_depthFirst.size());
+    for (uint32_t id : _depthFirst) {
+        _postOrder[_depthFirstPosition[id] + _subtreeSizes[id] - 1 - _depths[id]] = id;
+    }
+}
+
+SectionAggregates::SectionAggregates(range<const Point::Type> points,
+                                     range<const Diameter::Type> diameters,
+                                     range<const Section::Type> sections)
+    : _boundingBoxes(sections.size()) {
+    std::vector<uint32_t> offsets;
+    offsets.reserve(sections.size() + 1);
+    for (const auto& section : sections) {
+        offsets.push_back(static_cast<uint32_t>(section[0]));
+    }
+    offsets.push_back(static_cast<uint32_t>(points.size()));
+
+    _lengths = morphometrics::sectionSums(morphometrics::segmentLengths(points, offsets),
+                                          offsets);
+    _areas = morphometrics::sectionSums(
+        morphometrics::segmentLateralAreas(points, diameters, offsets), offsets);
+    _volumes = morphometrics::sectionSums(
+        morphometrics::segmentVolumes(points, diameters, offsets), offsets);
+
+    for (size_t s = 0; s < sections.size(); ++s) {
+        if (offsets[s] < offsets[s + 1]) {
+            _boundingBoxes[s] = morphometrics::boundingBox(
+                points.subspan(offsets[s], offsets[s + 1] - offsets[s]));
+        }
+    }
+}
+
+const SectionTopology& Properties::sectionTopology() const {
+    return *sharedSectionTopology();
+}
+
+std::shared_ptr<const SectionTopology> Properties::sharedSectionTopology() const {
+    return _sectionTopology.share(
+        [this]() { return SectionTopology(_sectionLevel._children, get<Section>().size()); });
+}
+
+const SectionAggregates& Properties::sectionAggregates() const {
+    return _sectionAggregates.get([this]() {
+        return SectionAggregates(get<Point>(), get<Diameter>(), get<Section>());
+    });
+}
+
+const SpatialIndex& Properties::spatialIndex() const {
+    return _spatialIndex.get(
+        [this]() { return SpatialIndex(get<Point>(), get<Diameter>(), get<Section>()); });
+}
+
+bool ChildrenIndex::operator==(const ChildrenIndex& other) const {
+    // Sections without children may or may not have a slot
+    const auto nSlots = std::max(_offsets.size(), other._offsets.size());
+    for (size_t slot = 0; slot + 1 < nSlots; ++slot) {
+        const auto parent = static_cast<int32_t>(slot) - 1;
+        if (!compare_range(of(parent), other.of(parent))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ChildrenIndex::operator!=(const ChildrenIndex& other) const {
+    return !(*this == other);
+}
 
 PointLevel::PointLevel(const PointLevel& data, SectionRange range) {
-    _points = copySpan<Property::Point>(data._points, range);
-    _diameters = copySpan<Property::Diameter>(data._diameters, range);
-    _perimeters = copySpan<Property::Perimeter>(data._perimeters, range);
+    _points = copySpan<Property::Point>(data.points(), range);
+    _diameters = copySpan<Property::Diameter>(data.diameters(), range);
+    _perimeters = copySpan<Property::Perimeter>(data.perimeters(), range);
+}
+
+PointColumns::PointColumns(const PointLevel& pointLevel)
+    : _diameters(pointLevel.diameters()) {
+    const size_t size = _diameters.size();
+    if (pointLevel.hasColumns()) {
+        const floatType* columns = pointLevel._columns.data();
+        _x = PointColumn(columns, size, 1);
+        _y = PointColumn(columns + size, size, 1);
+        _z = PointColumn(columns + 2 * size, size, 1);
+    } else if (size > 0) {
+        const floatType* points = pointLevel.points()[0].data();
+        const size_t stride = sizeof(Point::Type) / sizeof(floatType);
+        _x = PointColumn(points, size, stride);
+        _y = PointColumn(points + 1, size, stride);
+        _z = PointColumn(points + 2, size, stride);
+    }
+}
+
+void PointLevel::storeColumns(std::vector<floatType> columns) {
+    if (columns.size() % 4 != 0) {
+        throw MorphioError("Point columns have size: " + std::to_string(columns.size()) +
+                           ", which is not a multiple of 4");
+    }
+    if (!perimeters().empty() && perimeters().size() != columns.size() / 4) {
+        throw SectionBuilderError(
+            "Point columns have size: " + std::to_string(columns.size() / 4) +
+            " while Perimeter vector has size: " + std::to_string(perimeters().size()));
+    }
+
+    std::vector<Point::Type>().swap(_points);
+    std::vector<Diameter::Type>().swap(_diameters);
+    _borrowedPoints = {};
+    _borrowedDiameters = {};
+    _columns = std::move(columns);
+    _columnPoints = {};
+}
+
+void PointLevel::storeColumns() {
+    if (hasColumns()) {
+        return;
+    }
+
+    const auto points = this->points();
+    const auto diameters = this->diameters();
+    const size_t size = points.size();
+    std::vector<floatType> columns(4 * size);
+    for (size_t i = 0; i < size; ++i) {
+        columns[i] = points[i][0];
+        columns[size + i] = points[i][1];
+        columns[2 * size + i] = points[i][2];
+        columns[3 * size + i] = diameters[i];
+    }
+    storeColumns(std::move(columns));
+}
+
+range<const Point::Type> PointLevel::pointsFromColumns() const {
+    return _columnPoints.get([this]() {
+        const size_t size = _columns.size() / 4;
+        std::vector<Point::Type> points(size);
+        for (size_t i = 0; i < size; ++i) {
+            points[i] = {_columns[i], _columns[size + i], _columns[2 * size + i]};
+        }
+        return points;
+    });
+}
+
+void PointLevel::borrow(StorageOwner owner,
+                        range<const Point::Type> points,
+                        range<const Diameter::Type> diameters,
+                        range<const Perimeter::Type> perimeters) {
+    if (!owner) {
+        throw MorphioError("Borrowed point level arrays need an owner");
+    }
+
+    if (points.size() != diameters.size()) {
+        throw SectionBuilderError(
+            "Point vector have size: " + std::to_string(points.size()) +
+            " while Diameter vector has size: " + std::to_string(diameters.size()));
+    }
+
+    if (!perimeters.empty() && points.size() != perimeters.size()) {
+        throw SectionBuilderError(
+            "Point vector have size: " + std::to_string(points.size()) +
+            " while Perimeter vector has size: " + std::to_string(perimeters.size()));
+    }
+
+    _points.clear();
+    _diameters.clear();
+    _perimeters.clear();
+    _columns.clear();
+    _columnPoints = {};
+
+    _owner = std::move(owner);
+    _borrowedPoints = points;
+    _borrowedDiameters = diameters;
+    _borrowedPerimeters = perimeters;
+}
+
+void PointLevel::own() {
+    if (hasColumns()) {
+        const auto points = this->points();
+        const auto diameters = this->diameters();
+        _points.assign(points.begin(), points.end());
+        _diameters.assign(diameters.begin(), diameters.end());
+        std::vector<floatType>().swap(_columns);
+        _columnPoints = {};
+    }
+
+    if (!_owner) {
+        return;
+    }
+
+    if (_points.empty() && _diameters.empty()) {
+        _points.assign(_borrowedPoints.begin(), _borrowedPoints.end());
+        _diameters.assign(_borrowedDiameters.begin(), _borrowedDiameters.end());
+    }
+    _perimeters.assign(_borrowedPerimeters.begin(), _borrowedPerimeters.end());
+
+    _borrowedPoints = {};
+    _borrowedDiameters = {};
+    _borrowedPerimeters = {};
+    _owner.reset();
+}
+
+void SectionLevel::borrow(StorageOwner owner,
+                          range<const Section::Type> sections,
+                          range<const SectionType::Type> sectionTypes) {
+    if (!owner) {
+        throw MorphioError("Borrowed section level arrays need an owner");
+    }
+
+    if (sections.size() != sectionTypes.size()) {
+        throw SectionBuilderError(
+            "Section vector have size: " + std::to_string(sections.size()) +
+            " while SectionType vector has size: " + std::to_string(sectionTypes.size()));
+    }
+
+    _sections.clear();
+    _sectionTypes.clear();
+
+    _owner = std::move(owner);
+    _borrowedSections = sections;
+    _borrowedSectionTypes = sectionTypes;
 }
 
-PointLevel& PointLevel::operator=(const PointLevel& other) {
-    if (&other == this) {
-        return *this;
+void SectionLevel::own() {
+    if (!_owner) {
+        return;
     }
 
-    _points = other._points;
-    _diameters = other._diameters;
-    _perimeters = other._perimeters;
+    _sections.assign(_borrowedSections.begin(), _borrowedSections.end());
+    _sectionTypes.assign(_borrowedSectionTypes.begin(), _borrowedSectionTypes.end());
 
-    return *this;
+    _borrowedSections = {};
+    _borrowedSectionTypes = {};
+    _owner.reset();
 }
 
 bool SectionLevel::diff(const SectionLevel& other) const {
-    return !(this == &other || (compare_section_structure(_sections, other._sections) &&
-                                morphio::property::compare(_sectionTypes, other._sectionTypes) &&
+    return !(this == &other || (compare_section_structure(sections(), other.sections()) &&
+                                compare_range(sectionTypes(), other.sectionTypes()) &&
                                 morphio::property::compare(_children, other._children)));
 }
 
@@ -163,13 +497,15 @@ bool MitochondriaPointLevel::operator!=(const MitochondriaPointLevel& other) con
 }
 
 std::ostream& operator<<(std::ostream& os, const PointLevel& pointLevel) {
+    const auto points = pointLevel.points();
+    const auto diameters = pointLevel.diameters();
+    const auto perimeters = pointLevel.perimeters();
     os << "Point level properties:\n"
-       << "Point Diameter"
-       << (pointLevel._perimeters.size() == pointLevel._points.size() ? " Perimeter\n" : "\n");
-    for (unsigned int i = 0; i < pointLevel._points.size(); ++i) {
-        os << dumpPoint(pointLevel._points[i]) << ' ' << pointLevel._diameters[i];
-        if (pointLevel._perimeters.size() == pointLevel._points.size()) {
-            os << ' ' << pointLevel._perimeters[i];
+       << "Point Diameter" << (perimeters.size() == points.size() ? " Perimeter\n" : "\n");
+    for (unsigned int i = 0; i < points.size(); ++i) {
+        os << dumpPoint(points[i]) << ' ' << diameters[i];
+        if (perimeters.size() == points.size()) {
+            os << ' ' << perimeters[i];
         }
         os << '\n';
     }
@@ -0,0 +1,284 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#include <array>
+#include <cstring>  // std::memcmp
+#include <fstream>  // std::ifstream, std::ofstream
+
+#include "containerIndex.h"
+
+#include <morphio/errorMessages.h>
+
+#include "../shared_utils.hpp"
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+#define MORPHIO_HAS_PREAD 0
+#include <mutex>
+#else
+#define MORPHIO_HAS_PREAD 1
+#include <cerrno>     // errno, EINTR
+#include <fcntl.h>    // open
+#include <unistd.h>   // pread, close
+#endif
+
+namespace morphio {
+namespace readers {
+namespace h5 {
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'M', 'O', 'R', 'P', 'H', 'I', 'D', 'X'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+template <typename T>
+void writeValue(std::ofstream& stream, const T& value) {
+    stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T readValue(std::ifstream& stream, const std::string& path) {
+    T value;
+    stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+    if (!stream) {
+        throw RawDataError("Truncated container index: " + path);
+    }
+    return value;
+}
+
+/** Number of bytes left to read in `stream`, a file of `size` bytes */
+uint64_t remaining(std::ifstream& stream, uint64_t size) {
+    const auto position = static_cast<uint64_t>(stream.tellg());
+    return position < size ? size - position : 0;
+}
+
+void writeExtent(std::ofstream& stream, const DatasetExtent& extent) {
+    writeValue(stream, extent.offset);
+    writeValue(stream, extent.size);
+}
+
+DatasetExtent readExtent(std::ifstream& stream, const std::string& path) {
+    DatasetExtent extent;
+    extent.offset = readValue<uint64_t>(stream, path);
+    extent.size = readValue<uint64_t>(stream, path);
+    return extent;
+}
+
+}  // namespace
+
+#if MORPHIO_HAS_PREAD
+struct RawFileReader::Impl {
+    int fd = -1;
+};
+
+RawFileReader::RawFileReader(const std::string& path)
+    : _path(path)
+    , _impl(new Impl) {
+    _impl->fd = ::open(path.c_str(), O_RDONLY);
+}
+
+RawFileReader::~RawFileReader() {
+    if (_impl->fd >= 0) {
+        ::close(_impl->fd);
+    }
+}
+
+bool RawFileReader::isOpen() const {
+    return _impl->fd >= 0;
+}
+
+std::vector<char> RawFileReader::read(uint64_t begin, uint64_t end) const {
+    std::vector<char> buffer(end - begin);
+
+    size_t done = 0;
+    while (done < buffer.size()) {
+        const auto count = ::pread(_impl->fd,
+                                   buffer.data() + done,
+                                   buffer.size() - done,
+                                   static_cast<off_t>(begin + done));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            throw RawDataError("Failed to read bytes [" + std::to_string(begin) + ", " +
+                               std::to_string(end) + ") of " + _path);
+        }
+        done += static_cast<size_t>(count);
+    }
+
+    return buffer;
+}
+#else
+struct RawFileReader::Impl {
+    std::mutex mutex;
+    std::ifstream stream;
+};
+
+RawFileReader::RawFileReader(const std::string& path)
+    : _path(path)
+    , _impl(new Impl) {
+    _impl->stream.open(path, std::ios::binary);
+}
+
+RawFileReader::~RawFileReader() = default;
+
+bool RawFileReader::isOpen() const {
+    return _impl->stream.is_open();
+}
+
+std::vector<char> RawFileReader::read(uint64_t begin, uint64_t end) const {
+    std::vector<char> buffer(end - begin);
+
+    std::lock_guard<std::mutex> lock(_impl->mutex);
+    _impl->stream.seekg(static_cast<std::streamoff>(begin));
+    _impl->stream.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+    if (!_impl->stream) {
+        _impl->stream.clear();
+        throw RawDataError("Failed to read bytes [" + std::to_string(begin) + ", " +
+                           std::to_string(end) + ") of " + _path);
+    }
+
+    return buffer;
+}
+#endif
+
+ContainerIndex ContainerIndex::build(const HighFive::File& file,
+                                     const std::string& container_path) {
+    ContainerIndex index;
+    index._containerSize = file_size(container_path);
+    index._containerModificationTime = file_modification_time(container_path);
+
+    // Objects that aren't morphologies are left out, loading them goes
+    // through HDF5 and reports the error there.
+    for (const auto& name : file.listObjectNames()) {
+        if (file.getObjectType(name) != HighFive::ObjectType::Group) {
+            continue;
+        }
+        try {
+            index._layouts.emplace(name, MorphologyHDF5(file.getGroup(name), name).layout());
+        } catch (const MorphioError&) {
+            continue;
+        } catch (const HighFive::Exception&) {
+            continue;
+        }
+    }
+
+    return index;
+}
+
+ContainerIndex ContainerIndex::read(const std::string& index_path) {
+    std::ifstream stream(index_path, std::ios::binary | std::ios::ate);
+    if (!stream.is_open()) {
+        throw RawDataError("Could not open container index: " + index_path);
+    }
+    const auto index_size = static_cast<uint64_t>(stream.tellg());
+    stream.seekg(0);
+
+    const auto magic = readValue<std::array<char, 8>>(stream, index_path);
+    if (std::memcmp(magic.data(), MAGIC.data(), MAGIC.size()) != 0) {
+        throw RawDataError("Not a container index: " + index_path);
+    }
+
+    if (readValue<uint32_t>(stream, index_path) != FORMAT_VERSION ||
+        readValue<uint32_t>(stream, index_path) != BYTE_ORDER_MARK ||
+        readValue<uint32_t>(stream, index_path) != sizeof(floatType)) {
+        throw RawDataError("Incompatible container index: " + index_path);
+    }
+
+    ContainerIndex index;
+    index._containerSize = readValue<uint64_t>(stream, index_path);
+    index._containerModificationTime = readValue<int64_t>(stream, index_path);
+
+    const auto n_entries = readValue<uint64_t>(stream, index_path);
+    if (n_entries > remaining(stream, index_size)) {
+        throw RawDataError("Truncated container index: " + index_path);
+    }
+    index._layouts.reserve(n_entries);
+    for (uint64_t i = 0; i < n_entries; ++i) {
+        const auto name_size = readValue<uint32_t>(stream, index_path);
+        if (name_size > remaining(stream, index_size)) {
+            throw RawDataError("Truncated container index: " + index_path);
+        }
+        std::string name(name_size, '\0');
+        stream.read(&name[0], static_cast<std::streamsize>(name.size()));
+        if (!stream) {
+            throw RawDataError("Truncated container index: " + index_path);
+        }
+
+        MorphologyLayout layout;
+        layout.isDirectlyReadable = readValue<uint8_t>(stream, index_path) != 0;
+        layout.hasPerimeters = readValue<uint8_t>(stream, index_path) != 0;
+        layout.cellFamily = static_cast<CellFamily>(readValue<uint32_t>(stream, index_path));
+
+        const auto major = readValue<uint32_t>(stream, index_path);
+        const auto minor = readValue<uint32_t>(stream, index_path);
+        layout.version = {"h5", major, minor};
+
+        layout.points = readExtent(stream, index_path);
+        layout.structure = readExtent(stream, index_path);
+        layout.perimeters = readExtent(stream, index_path);
+
+        index._layouts.emplace(std::move(name), layout);
+    }
+
+    return index;
+}
+
+void ContainerIndex::write(const std::string& index_path) const {
+    std::ofstream stream(index_path, std::ios::binary | std::ios::trunc);
+    if (!stream.is_open()) {
+        throw MorphioError("Could not open container index for writing: " + index_path);
+    }
+
+    writeValue(stream, MAGIC);
+    writeValue(stream, FORMAT_VERSION);
+    writeValue(stream, BYTE_ORDER_MARK);
+    writeValue(stream, static_cast<uint32_t>(sizeof(floatType)));
+    writeValue(stream, _containerSize);
+    writeValue(stream, _containerModificationTime);
+
+    const uint64_t n_entries = _layouts.size();
+    writeValue(stream, n_entries);
+    for (const auto& entry : _layouts) {
+        const auto& name = entry.first;
+        const auto& layout = entry.second;
+
+        writeValue(stream, static_cast<uint32_t>(name.size()));
+        stream.write(name.data(), static_cast<std::streamsize>(name.size()));
+
+        writeValue(stream, static_cast<uint8_t>(layout.isDirectlyReadable));
+        writeValue(stream, static_cast<uint8_t>(layout.hasPerimeters));
+        writeValue(stream, static_cast<uint32_t>(layout.cellFamily));
+        writeValue(stream, std::get<1>(layout.version));
+        writeValue(stream, std::get<2>(layout.version));
+
+        writeExtent(stream, layout.points);
+        writeExtent(stream, layout.structure);
+        writeExtent(stream, layout.perimeters);
+    }
+
+    if (!stream) {
+        throw MorphioError("Failed to write container index: " + index_path);
+    }
+}
+
+bool ContainerIndex::isCurrent(const std::string& container_path) const {
+    return _containerSize == file_size(container_path) &&
+           _containerModificationTime == file_modification_time(container_path);
+}
+
+const MorphologyLayout* ContainerIndex::find(const std::string& name) const {
+    const auto it = _layouts.find(name);
+    return it == _layouts.end() ? nullptr : &it->second;
+}
+
+std::string containerIndexPath(const std::string& container_path) {
+    return container_path + ".index";
+}
+
+}  // namespace h5
+}  // namespace readers
+}  // namespace morphio
+
+#undef MORPHIO_HAS_PREAD
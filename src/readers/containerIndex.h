@@ -0,0 +1,103 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+#pragma once
+
+#include <cstdint>  // uint64_t
+#include <memory>   // std::unique_ptr
+#include <string>   // std::string
+#include <unordered_map>
+#include <vector>
+
+#include <highfive/H5File.hpp>
+
+#include "morphologyHDF5.h"
+
+namespace morphio {
+namespace readers {
+namespace h5 {
+
+/**
+ * Thread-safe reads of byte ranges of a file, bypassing HDF5.
+ *
+ * On POSIX systems, reads are positional (`pread`) and don't take any lock;
+ * elsewhere, they are serialized on a single stream.
+ */
+class RawFileReader
+{
+  public:
+    explicit RawFileReader(const std::string& path);
+    ~RawFileReader();
+
+    RawFileReader(const RawFileReader&) = delete;
+    RawFileReader& operator=(const RawFileReader&) = delete;
+
+    bool isOpen() const;
+
+    /** Read the bytes `[begin, end)` of the file */
+    std::vector<char> read(uint64_t begin, uint64_t end) const;
+
+  private:
+    struct Impl;
+
+    std::string _path;
+    std::unique_ptr<Impl> _impl;
+};
+
+/**
+ * The sidecar index of a container.
+ *
+ * It stores the layout (see `MorphologyLayout`) of every morphology in the
+ * container, such that a morphology can be found without traversing the
+ * HDF5 groups and, if it's directly readable, loaded without HDF5 at all.
+ *
+ * The index also stores the size and modification time of the container at
+ * the time it was built; if either changed the index is considered stale.
+ *
+ * The file format is binary, in native byte order:
+ *
+ *     magic, format version, byte order mark, sizeof(floatType),
+ *     container size, container modification time, number of entries,
+ *     entries: name, readable flag, perimeter flag, cell family,
+ *              version (major, minor), {offset, size} of points, structure
+ *              and perimeters
+ */
+class ContainerIndex
+{
+  public:
+    /**
+     * Inspect every morphology of `file`; the caller must hold `global_hdf5_mutex()`
+     *
+     * Root objects that aren't groups, or whose layout can't be decoded, are skipped.
+     */
+    static ContainerIndex build(const HighFive::File& file, const std::string& container_path);
+
+    /** Read the index stored at `index_path`; throws `RawDataError` if it's invalid */
+    static ContainerIndex read(const std::string& index_path);
+
+    void write(const std::string& index_path) const;
+
+    /** Is the index up to date with the container at `container_path`? */
+    bool isCurrent(const std::string& container_path) const;
+
+    /** The layout of the morphology `name`, or `nullptr` if it isn't indexed */
+    const MorphologyLayout* find(const std::string& name) const;
+
+    size_t size() const {
+        return _layouts.size();
+    }
+
+  private:
+    uint64_t _containerSize = 0;
+    int64_t _containerModificationTime = 0;
+    std::unordered_map<std::string, MorphologyLayout> _layouts;
+};
+
+/** Where the sidecar index of the container at `container_path` is stored */
+std::string containerIndexPath(const std::string& container_path);
+
+}  // namespace h5
+}  // namespace readers
+}  // namespace morphio
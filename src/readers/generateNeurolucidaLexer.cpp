@@ -0,0 +1,46 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+
+/**
+ * Write the DFA of the rules of NeurolucidaRules.h as C++ source.
+ *
+ * Run at build time, so that processes reading ASC files don't compile the
+ * regular expressions on their first use.
+ *
+ * Usage: generateNeurolucidaLexer output.hpp
+ */
+#include <fstream>
+#include <iostream>
+
+#include <lexertl/generate_cpp.hpp>
+#include <lexertl/generator.hpp>
+
+#include "NeurolucidaRules.h"
+
+int main(int argc, char* argv[]) {
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " output.hpp\n";
+        return 1;
+    }
+
+    const lexertl::rules rules = morphio::readers::asc::neurolucidaRules();
+    lexertl::state_machine sm;
+    lexertl::generator::build(rules, sm);
+    sm.minimise();
+
+    std::ofstream out(argv[1]);
+    out << "// Generated by generateNeurolucidaLexer from NeurolucidaRules.h, do not edit\n"
+        << "#pragma once\n\n"
+        << "#include <lexertl/match_results.hpp>\n\n"
+        << "namespace morphio {\nnamespace readers {\nnamespace asc {\n\n";
+    lexertl::table_based_cpp::generate_cpp("neurolucida_lookup", sm, false, out);
+    out << "\n}  // namespace asc\n}  // namespace readers\n}  // namespace morphio\n";
+
+    if (!out) {
+        std::cerr << "Failed to write: " << argv[1] << '\n';
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,79 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "mappedFile.h"
+
+#include <morphio/exceptions.h>
+
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+#define MORPHIO_HAS_MMAP 0
+#include <fstream>
+#else
+#define MORPHIO_HAS_MMAP 1
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, munmap
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close
+#endif
+
+namespace morphio {
+namespace readers {
+
+MappedFile::MappedFile(const std::string& path)
+    : _path(path) {
+#if MORPHIO_HAS_MMAP
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw RawDataError("File: " + path + " does not exist.");
+    }
+
+    struct stat info {};
+    if (::fstat(fd, &info) != 0) {
+        ::close(fd);
+        throw RawDataError("Failed to stat: " + path);
+    }
+
+    _size = static_cast<size_t>(info.st_size);
+    if (_size > 0) {
+        void* addr = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr == MAP_FAILED) {
+            ::close(fd);
+            throw RawDataError("Failed to map: " + path);
+        }
+        _data = static_cast<const char*>(addr);
+        _isMapped = true;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+#else
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        throw RawDataError("File: " + path + " does not exist.");
+    }
+
+    _buffer.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(_buffer.data(), static_cast<std::streamsize>(_buffer.size()));
+    if (!file) {
+        throw RawDataError("Failed to read: " + path);
+    }
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if MORPHIO_HAS_MMAP
+    if (_isMapped) {
+        ::munmap(const_cast<char*>(_data), _size);
+    }
+#endif
+}
+
+}  // namespace readers
+}  // namespace morphio
+
+#undef MORPHIO_HAS_MMAP
@@ -0,0 +1,51 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <morphio/types.h>
+
+namespace morphio {
+namespace readers {
+
+/**
+ * The read-only contents of a file.
+ *
+ * On POSIX systems, the file is mapped into memory and pages are only read
+ * when they are touched; elsewhere, it is read into a buffer in one go.
+ */
+class MappedFile
+{
+  public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    range<const char> bytes() const noexcept {
+        return {_data, _size};
+    }
+
+    size_t size() const noexcept {
+        return _size;
+    }
+
+    const std::string& path() const noexcept {
+        return _path;
+    }
+
+  private:
+    std::string _path;
+    const char* _data = nullptr;
+    size_t _size = 0;
+    bool _isMapped = false;
+    std::vector<char> _buffer;
+};
+
+}  // namespace readers
+}  // namespace morphio
@@ -0,0 +1,483 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "morphologyBinary.h"
+
+#include <algorithm>  // std::equal
+#include <array>
+#include <cstdint>  // std::uintptr_t
+#include <cstring>  // std::memcpy
+#include <memory>   // std::make_shared
+#include <string>
+#include <type_traits>
+
+#include <morphio/exceptions.h>
+
+#include "../error_message_generation.h"
+#include "mappedFile.h"
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'M', 'O', 'R', 'P', 'H', 'B', 'I', 'N'};
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t formatVersion;
+    uint32_t byteOrderMark;
+    uint32_t floatSize;
+    uint32_t cellFamily;
+    uint32_t somaType;
+    uint32_t nArrays;
+};
+static_assert(sizeof(Header) == 32, "the header must not contain padding");
+
+struct ArrayEntry {
+    uint32_t id;
+    uint32_t elementSize;
+    uint64_t offset;  // from the start of the morphology, in bytes
+    uint64_t count;   // in elements
+};
+static_assert(sizeof(ArrayEntry) == 24, "array entries must not contain padding");
+
+// The ids are part of the format: only ever append to this list.
+enum ArrayId : uint32_t {
+    POINTS = 1,
+    DIAMETERS,
+    PERIMETERS,
+    SECTIONS,
+    SECTION_TYPES,
+    SOMA_POINTS,
+    SOMA_DIAMETERS,
+    MITO_NEURITE_SECTION_IDS,
+    MITO_PATH_LENGTHS,
+    MITO_DIAMETERS,
+    MITO_SECTIONS,
+    ER_SECTION_INDICES,
+    ER_VOLUMES,
+    ER_SURFACE_AREAS,
+    ER_FILAMENT_COUNTS,
+    PSD_SECTION_IDS,
+    PSD_SEGMENT_IDS,
+    PSD_OFFSETS,
+};
+
+uint64_t alignUp(uint64_t offset) {
+    const uint64_t alignment = morphio::readers::binary::ARRAY_ALIGNMENT;
+    return (offset + alignment - 1) / alignment * alignment;
+}
+
+class Encoder
+{
+  public:
+    template <typename T>
+    void add(ArrayId id, const std::vector<T>& data) {
+        add(id, morphio::range<const T>(data));
+    }
+
+    template <typename T>
+    void add(ArrayId id, const morphio::range<const T>& data) {
+        static_assert(std::is_trivially_copyable<T>::value, "arrays are copied bytewise");
+        if (!data.empty()) {
+            _arrays.push_back({id, sizeof(T), data.data(), data.size()});
+        }
+    }
+
+    std::vector<char> finish(Header header) const {
+        header.nArrays = static_cast<uint32_t>(_arrays.size());
+
+        std::vector<ArrayEntry> entries;
+        entries.reserve(_arrays.size());
+
+        uint64_t end = alignUp(sizeof(Header) + _arrays.size() * sizeof(ArrayEntry));
+        for (const auto& array : _arrays) {
+            entries.push_back({array.id, array.elementSize, end, array.count});
+            end = alignUp(end + array.elementSize * array.count);
+        }
+
+        std::vector<char> bytes(end, 0);
+        std::memcpy(bytes.data(), &header, sizeof(Header));
+        std::memcpy(bytes.data() + sizeof(Header),
+                    entries.data(),
+                    entries.size() * sizeof(ArrayEntry));
+        for (size_t i = 0; i < _arrays.size(); ++i) {
+            std::memcpy(bytes.data() + entries[i].offset,
+                        _arrays[i].data,
+                        _arrays[i].elementSize * _arrays[i].count);
+        }
+
+        return bytes;
+    }
+
+  private:
+    struct Array {
+        ArrayId id;
+        uint32_t elementSize;
+        const void* data;
+        uint64_t count;
+    };
+
+    std::vector<Array> _arrays;
+};
+
+class Decoder
+{
+  public:
+    Decoder(const morphio::range<const char>& bytes, std::string uri)
+        : _bytes(bytes)
+        , _uri(std::move(uri)) {
+        if (_bytes.size() < sizeof(Header)) {
+            fail("it is too small to contain a header");
+        }
+        std::memcpy(&_header, _bytes.data(), sizeof(Header));
+
+        if (_header.magic != MAGIC) {
+            fail("it is not a compact binary morphology");
+        }
+        if (_header.byteOrderMark != BYTE_ORDER_MARK) {
+            fail("it was written on a machine with a different byte order");
+        }
+        if (_header.formatVersion != morphio::readers::binary::FORMAT_VERSION) {
+            fail("unsupported format version " + std::to_string(_header.formatVersion));
+        }
+        if (_header.floatSize != sizeof(morphio::floatType)) {
+            fail("it was written with " + std::to_string(_header.floatSize * 8) +
+                 " bit floats, but MorphIO uses " + std::to_string(sizeof(morphio::floatType) * 8) +
+                 " bit floats");
+        }
+
+        const uint64_t tableEnd = sizeof(Header) + uint64_t{_header.nArrays} * sizeof(ArrayEntry);
+        if (tableEnd > _bytes.size()) {
+            fail("the array table is truncated");
+        }
+
+        _entries.resize(_header.nArrays);
+        if (!_entries.empty()) {
+            std::memcpy(_entries.data(),
+                        _bytes.data() + sizeof(Header),
+                        _entries.size() * sizeof(ArrayEntry));
+        }
+
+        const auto alignment = morphio::readers::binary::ARRAY_ALIGNMENT;
+        _inPlace = reinterpret_cast<std::uintptr_t>(_bytes.data()) % alignment == 0;
+        for (const auto& entry : _entries) {
+            if (entry.elementSize == 0 || entry.offset > _bytes.size() ||
+                entry.count > (_bytes.size() - entry.offset) / entry.elementSize) {
+                fail("array " + std::to_string(entry.id) + " is truncated");
+            }
+            _inPlace = _inPlace && entry.offset % alignment == 0;
+        }
+    }
+
+    const Header& header() const noexcept {
+        return _header;
+    }
+
+    /** Are all arrays aligned in memory, such that they can be used in place with `view`? */
+    bool isInPlace() const noexcept {
+        return _inPlace;
+    }
+
+    /** The content of array `id`, empty if it isn't stored */
+    template <typename T>
+    std::vector<T> get(ArrayId id) const {
+        static_assert(std::is_trivially_copyable<T>::value, "arrays are copied bytewise");
+
+        const ArrayEntry* entry = find(id, sizeof(T));
+        if (entry == nullptr) {
+            return {};
+        }
+
+        std::vector<T> data(entry->count);
+        std::memcpy(data.data(), _bytes.data() + entry->offset, entry->count * sizeof(T));
+        return data;
+    }
+
+    /** The content of array `id` in place, without copying it; requires `isInPlace()` */
+    template <typename T>
+    morphio::range<const T> view(ArrayId id) const {
+        static_assert(std::is_trivially_copyable<T>::value, "arrays are read bytewise");
+        static_assert(alignof(T) <= morphio::readers::binary::ARRAY_ALIGNMENT,
+                      "arrays are only aligned to ARRAY_ALIGNMENT");
+
+        const ArrayEntry* entry = find(id, sizeof(T));
+        if (entry == nullptr) {
+            return {};
+        }
+
+        const void* data = _bytes.data() + entry->offset;
+        return {static_cast<const T*>(data), static_cast<size_t>(entry->count)};
+    }
+
+    [[noreturn]] void fail(const std::string& reason) const {
+        throw morphio::RawDataError("Error reading morphology " + _uri + ": " + reason);
+    }
+
+  private:
+    const ArrayEntry* find(ArrayId id, size_t elementSize) const {
+        for (const auto& entry : _entries) {
+            if (entry.id != id || entry.count == 0) {
+                continue;
+            }
+            if (entry.elementSize != elementSize) {
+                fail("array " + std::to_string(id) + " has elements of " +
+                     std::to_string(entry.elementSize) + " bytes, expected " +
+                     std::to_string(elementSize));
+            }
+            return &entry;
+        }
+
+        return nullptr;
+    }
+
+    morphio::range<const char> _bytes;
+    std::string _uri;
+    Header _header{};
+    std::vector<ArrayEntry> _entries;
+    bool _inPlace = false;
+};
+
+void checkSameSize(const Decoder& decoder,
+                   size_t size,
+                   size_t expected,
+                   const std::string& name) {
+    if (size != expected) {
+        decoder.fail(name + " has " + std::to_string(size) + " elements, expected " +
+                     std::to_string(expected));
+    }
+}
+
+void checkSectionTypes(const morphio::range<const int32_t>& types) {
+    for (const auto type : types) {
+        if (type <= 0 || type >= morphio::SECTION_OUT_OF_RANGE_START) {
+            morphio::details::ErrorMessages err;
+            throw morphio::RawDataError(
+                err.ERROR_UNSUPPORTED_SECTION_TYPE(0, static_cast<morphio::SectionType>(type)));
+        }
+    }
+}
+
+void checkSections(const Decoder& decoder, const morphio::Property::Properties& properties) {
+    const auto sections = properties.get<morphio::Property::Section>();
+    const auto nPoints = properties.get<morphio::Property::Point>().size();
+
+    int previousOffset = 0;
+    for (size_t i = 0; i < sections.size(); ++i) {
+        const int offset = sections[i][0];
+        const int parent = sections[i][1];
+
+        if (offset < previousOffset || static_cast<size_t>(offset) > nPoints) {
+            decoder.fail("section " + std::to_string(i) + " has an invalid point offset");
+        }
+        // parents come before their children
+        if (parent < -1 || parent >= static_cast<int>(i)) {
+            decoder.fail("section " + std::to_string(i) + " has an invalid parent");
+        }
+        previousOffset = offset;
+    }
+}
+
+}  // namespace
+
+namespace morphio {
+namespace readers {
+namespace binary {
+
+bool isBinary(const range<const char>& bytes) noexcept {
+    return bytes.size() >= MAGIC.size() && std::equal(MAGIC.begin(), MAGIC.end(), bytes.begin());
+}
+
+Property::Properties load(const std::string& uri,
+                          WarningHandler* warning_handler,
+                          unsigned int options) {
+    const auto file = std::make_shared<const MappedFile>(uri);
+    return decode(file->bytes(), uri, warning_handler, file, options);
+}
+
+Property::Properties decode(const range<const char>& bytes,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            const Property::StorageOwner& owner,
+                            unsigned int options) {
+    const Decoder decoder(bytes, uri);
+    const Header& header = decoder.header();
+
+    if (header.cellFamily > SPINE) {
+        decoder.fail("unknown cell family " + std::to_string(header.cellFamily));
+    }
+    if (header.somaType > SOMA_SIMPLE_CONTOUR) {
+        decoder.fail("unknown soma type " + std::to_string(header.somaType));
+    }
+
+    Property::Properties properties;
+    properties._cellLevel._version = {"mbin", FORMAT_VERSION, 0};
+    properties._cellLevel._cellFamily = static_cast<CellFamily>(header.cellFamily);
+    properties._cellLevel._somaType = static_cast<SomaType>(header.somaType);
+
+    auto& points = properties._pointLevel;
+    auto& sections = properties._sectionLevel;
+    auto& soma = properties._somaLevel;
+
+    // The arrays that are on the hot path of the immutable API are borrowed
+    // from `owner` when possible; everything else is small and copied.
+    if (owner && decoder.isInPlace()) {
+        const auto pointsView = decoder.view<Property::Point::Type>(POINTS);
+        const auto diametersView = decoder.view<Property::Diameter::Type>(DIAMETERS);
+        const auto perimetersView = decoder.view<Property::Perimeter::Type>(PERIMETERS);
+        checkSameSize(decoder, diametersView.size(), pointsView.size(), "diameters");
+        if (!perimetersView.empty()) {
+            checkSameSize(decoder, perimetersView.size(), pointsView.size(), "perimeters");
+        }
+        points.borrow(owner, pointsView, diametersView, perimetersView);
+
+        const auto sectionsView = decoder.view<Property::Section::Type>(SECTIONS);
+        const auto typesView = decoder.view<int32_t>(SECTION_TYPES);
+        checkSameSize(decoder, typesView.size(), sectionsView.size(), "section types");
+        checkSectionTypes(typesView);
+        if (sizeof(SectionType) == sizeof(int32_t)) {
+            const void* types = typesView.data();
+            sections.borrow(owner,
+                            sectionsView,
+                            {static_cast<const SectionType*>(types), typesView.size()});
+        } else {
+            sections._sections.assign(sectionsView.begin(), sectionsView.end());
+            for (const auto type : typesView) {
+                sections._sectionTypes.push_back(static_cast<SectionType>(type));
+            }
+        }
+
+        const auto somaPointsView = decoder.view<Property::Point::Type>(SOMA_POINTS);
+        const auto somaDiametersView = decoder.view<Property::Diameter::Type>(SOMA_DIAMETERS);
+        checkSameSize(decoder, somaDiametersView.size(), somaPointsView.size(), "soma diameters");
+        soma.borrow(owner, somaPointsView, somaDiametersView);
+    } else {
+        points._points = decoder.get<Property::Point::Type>(POINTS);
+        points._diameters = decoder.get<Property::Diameter::Type>(DIAMETERS);
+        points._perimeters = decoder.get<Property::Perimeter::Type>(PERIMETERS);
+        checkSameSize(decoder, points._diameters.size(), points._points.size(), "diameters");
+        if (!points._perimeters.empty()) {
+            checkSameSize(decoder, points._perimeters.size(), points._points.size(), "perimeters");
+        }
+
+        sections._sections = decoder.get<Property::Section::Type>(SECTIONS);
+        const auto types = decoder.get<int32_t>(SECTION_TYPES);
+        checkSameSize(decoder, types.size(), sections._sections.size(), "section types");
+        checkSectionTypes(types);
+        sections._sectionTypes.reserve(types.size());
+        for (const auto type : types) {
+            sections._sectionTypes.push_back(static_cast<SectionType>(type));
+        }
+
+        soma._points = decoder.get<Property::Point::Type>(SOMA_POINTS);
+        soma._diameters = decoder.get<Property::Diameter::Type>(SOMA_DIAMETERS);
+        checkSameSize(decoder, soma._diameters.size(), soma._points.size(), "soma diameters");
+    }
+    checkSections(decoder, properties);
+
+    if (options & POINT_COLUMNS) {
+        points.storeColumns();
+    }
+
+    if (soma.points().empty()) {
+        warning_handler->emit(std::make_shared<NoSomaFound>(uri));
+    }
+
+    auto& mitoPoints = properties._mitochondriaPointLevel;
+    mitoPoints._sectionIds = decoder.get<Property::MitoNeuriteSectionId::Type>(
+        MITO_NEURITE_SECTION_IDS);
+    mitoPoints._relativePathLengths = decoder.get<Property::MitoPathLength::Type>(
+        MITO_PATH_LENGTHS);
+    mitoPoints._diameters = decoder.get<Property::MitoDiameter::Type>(MITO_DIAMETERS);
+    checkSameSize(decoder,
+                  mitoPoints._relativePathLengths.size(),
+                  mitoPoints._sectionIds.size(),
+                  "mitochondria path lengths");
+    checkSameSize(decoder,
+                  mitoPoints._diameters.size(),
+                  mitoPoints._sectionIds.size(),
+                  "mitochondria diameters");
+    properties._mitochondriaSectionLevel._sections = decoder.get<Property::MitoSection::Type>(
+        MITO_SECTIONS);
+
+    auto& er = properties._endoplasmicReticulumLevel;
+    er._sectionIndices = decoder.get<uint32_t>(ER_SECTION_INDICES);
+    er._volumes = decoder.get<floatType>(ER_VOLUMES);
+    er._surfaceAreas = decoder.get<floatType>(ER_SURFACE_AREAS);
+    er._filamentCounts = decoder.get<uint32_t>(ER_FILAMENT_COUNTS);
+    checkSameSize(decoder, er._volumes.size(), er._sectionIndices.size(), "ER volumes");
+    checkSameSize(decoder, er._surfaceAreas.size(), er._sectionIndices.size(), "ER surface areas");
+    checkSameSize(decoder, er._filamentCounts.size(), er._sectionIndices.size(), "ER filament counts");
+
+    const auto psdSectionIds = decoder.get<Property::DendriticSpine::SectionId_t>(
+        PSD_SECTION_IDS);
+    const auto psdSegmentIds = decoder.get<Property::DendriticSpine::SegmentId_t>(
+        PSD_SEGMENT_IDS);
+    const auto psdOffsets = decoder.get<Property::DendriticSpine::Offset_t>(PSD_OFFSETS);
+    checkSameSize(decoder, psdSegmentIds.size(), psdSectionIds.size(), "PSD segment ids");
+    checkSameSize(decoder, psdOffsets.size(), psdSectionIds.size(), "PSD offsets");
+
+    auto& psd = properties._dendriticSpineLevel._post_synaptic_density;
+    psd.reserve(psdSectionIds.size());
+    for (size_t i = 0; i < psdSectionIds.size(); ++i) {
+        psd.push_back({psdSectionIds[i], psdSegmentIds[i], psdOffsets[i]});
+    }
+
+    return properties;
+}
+
+std::vector<char> encode(const Property::Properties& properties) {
+    const auto sectionTypes = properties._sectionLevel.sectionTypes();
+    std::vector<int32_t> types;
+    types.reserve(sectionTypes.size());
+    for (const auto type : sectionTypes) {
+        types.push_back(static_cast<int32_t>(type));
+    }
+
+    const auto& psd = properties._dendriticSpineLevel._post_synaptic_density;
+    std::vector<Property::DendriticSpine::SectionId_t> psdSectionIds;
+    std::vector<Property::DendriticSpine::SegmentId_t> psdSegmentIds;
+    std::vector<Property::DendriticSpine::Offset_t> psdOffsets;
+    psdSectionIds.reserve(psd.size());
+    psdSegmentIds.reserve(psd.size());
+    psdOffsets.reserve(psd.size());
+    for (const auto& density : psd) {
+        psdSectionIds.push_back(density.sectionId);
+        psdSegmentIds.push_back(density.segmentId);
+        psdOffsets.push_back(density.offset);
+    }
+
+    Encoder encoder;
+    encoder.add(POINTS, properties._pointLevel.points());
+    encoder.add(DIAMETERS, properties._pointLevel.diameters());
+    encoder.add(PERIMETERS, properties._pointLevel.perimeters());
+    encoder.add(SECTIONS, properties._sectionLevel.sections());
+    encoder.add(SECTION_TYPES, types);
+    encoder.add(SOMA_POINTS, properties._somaLevel.points());
+    encoder.add(SOMA_DIAMETERS, properties._somaLevel.diameters());
+    encoder.add(MITO_NEURITE_SECTION_IDS, properties._mitochondriaPointLevel._sectionIds);
+    encoder.add(MITO_PATH_LENGTHS, properties._mitochondriaPointLevel._relativePathLengths);
+    encoder.add(MITO_DIAMETERS, properties._mitochondriaPointLevel._diameters);
+    encoder.add(MITO_SECTIONS, properties._mitochondriaSectionLevel._sections);
+    encoder.add(ER_SECTION_INDICES, properties._endoplasmicReticulumLevel._sectionIndices);
+    encoder.add(ER_VOLUMES, properties._endoplasmicReticulumLevel._volumes);
+    encoder.add(ER_SURFACE_AREAS, properties._endoplasmicReticulumLevel._surfaceAreas);
+    encoder.add(ER_FILAMENT_COUNTS, properties._endoplasmicReticulumLevel._filamentCounts);
+    encoder.add(PSD_SECTION_IDS, psdSectionIds);
+    encoder.add(PSD_SEGMENT_IDS, psdSegmentIds);
+    encoder.add(PSD_OFFSETS, psdOffsets);
+
+    Header header{};
+    header.magic = MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.floatSize = sizeof(floatType);
+    header.cellFamily = static_cast<uint32_t>(properties._cellLevel._cellFamily);
+    header.somaType = static_cast<uint32_t>(properties._cellLevel._somaType);
+
+    return encoder.finish(header);
+}
+
+}  // namespace binary
+}  // namespace readers
+}  // namespace morphio
@@ -0,0 +1,67 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <morphio/properties.h>
+#include <morphio/types.h>
+#include <morphio/warning_handling.h>
+
+/**
+ * The compact binary morphology format (`.mbin`).
+ *
+ * A file is a fixed size header, a table of arrays and the arrays themselves.
+ * Each array is the raw, native-endian content of one of the vectors of
+ * `Property::Properties`, aligned to `ARRAY_ALIGNMENT` bytes from the start of
+ * the file:
+ *
+ *   header: magic "MORPHBIN", format version, byte order mark, sizeof(floatType),
+ *           cell family, soma type, number of arrays          (all uint32_t)
+ *   table:  one (id, element size, offset, count) per array   (uint32_t x 2, uint64_t x 2)
+ *   arrays
+ *
+ * Arrays that are empty are not stored, and readers skip the ids they don't know.
+ */
+namespace morphio {
+namespace readers {
+namespace binary {
+
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr size_t ARRAY_ALIGNMENT = 16;
+
+/** Does `bytes` start like a compact binary morphology? */
+bool isBinary(const range<const char>& bytes) noexcept;
+
+/** Load a compact binary morphology, its arrays are borrowed from the memory mapped file */
+Property::Properties load(const std::string& uri,
+                          WarningHandler* warning_handler,
+                          unsigned int options = NO_MODIFIER);
+
+/**
+ * Decode the compact binary morphology stored in `bytes`
+ *
+ * If `owner` is set, it must keep `bytes` alive: the point and section level
+ * arrays are then borrowed from `bytes` instead of being copied, provided
+ * they are suitably aligned in memory.
+ *
+ * With the `POINT_COLUMNS` option, the points are then converted to columns.
+ *
+ * Like the other readers, it emits `NoSomaFound` through `warning_handler` if
+ * the morphology doesn't have a soma.
+ */
+Property::Properties decode(const range<const char>& bytes,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            const Property::StorageOwner& owner = nullptr,
+                            unsigned int options = NO_MODIFIER);
+
+/** The compact binary representation of `properties` */
+std::vector<char> encode(const Property::Properties& properties);
+
+}  // namespace binary
+}  // namespace readers
+}  // namespace morphio
@@ -3,7 +3,11 @@
  * SPDX-License-Identifier: Apache-2.0
  */
 
+#include <algorithm>  // std::min
 #include <cassert>
+#include <cstdint>  // std::uintptr_t
+#include <cstring>  // std::memcpy
+#include <limits>
 
 #include "morphologyHDF5.h"
 
@@ -64,75 +68,479 @@ const std::string _g_v2root("neuron1");
 namespace morphio {
 namespace readers {
 namespace h5 {
+namespace {
+
+using StructureRow = std::array<int, 3>;
+using PointRow = std::array<floatType, 4>;
+
+int decodeSections(const range<const StructureRow>& structure,
+                   const std::string& uri,
+                   Property::Properties& properties) {
+    assert(!structure.empty());
+
+    bool hasSoma = true;
+    if (static_cast<SectionType>(structure[0][SECTION_TYPE]) != SECTION_SOMA) {
+        hasSoma = false;
+    } else if (structure.size() == 1) {
+        return SOMA_ONLY;
+    }
+
+    const size_t firstSection = hasSoma ? 1 : 0;
+    const int firstSectionOffset = structure[firstSection][SECTION_START_OFFSET];
+
+    auto& sections = properties.get_mut<Property::Section>();
+    sections.reserve(structure.size() - firstSection);
+
+    auto& types = properties.get_mut<Property::SectionType>();
+    types.reserve(structure.size() - firstSection);
+
+    // The first section is skipped if it corresponds to a soma
+    for (size_t i = firstSection; i < structure.size(); ++i) {
+        const auto& section = structure[i];
+        SectionType type = static_cast<SectionType>(section[SECTION_TYPE]);
+
+        if (section[SECTION_TYPE] >= SECTION_OUT_OF_RANGE_START || section[SECTION_TYPE] <= 0) {
+            details::ErrorMessages err;
+            throw RawDataError(err.ERROR_UNSUPPORTED_SECTION_TYPE(0, type));
+        } else if (!hasSoma && type == SECTION_SOMA) {
+            throw(RawDataError("Error reading morphology " + uri +
+                               ": it has soma section that doesn't come first"));
+        } else if (hasSoma && type == SECTION_SOMA) {
+            throw(RawDataError("Error reading morphology " + uri +
+                               ": it has multiple soma sections"));
+        }
+
+        sections.emplace_back(
+            Property::Section::Type{section[SECTION_START_OFFSET] - firstSectionOffset,
+                                    section[SECTION_PARENT_OFFSET] - (hasSoma ? 1 : 0)});
+        types.emplace_back(type);
+    }
+
+    return firstSectionOffset;
+}
+
+void decodePoints(const range<const PointRow>& rows,
+                  int firstSectionOffset,
+                  unsigned int options,
+                  Property::Properties& properties) {
+    const size_t numberPoints = rows.size();
+
+    const bool hasSoma = firstSectionOffset != 0;
+    const bool hasNeurites = static_cast<size_t>(firstSectionOffset) < numberPoints;
+    const size_t somaPointCount = hasNeurites ? static_cast<size_t>(firstSectionOffset)
+                                              : numberPoints;
+
+    auto& somaPoints = properties._somaLevel._points;
+    auto& somaDiameters = properties._somaLevel._diameters;
+
+    if (hasSoma) {
+        somaPoints.resize(somaPointCount);
+        somaDiameters.resize(somaPointCount);
+
+        for (size_t i = 0; i < somaPointCount; ++i) {
+            const auto& p = rows[i];
+            somaPoints[i] = {p[0], p[1], p[2]};
+            somaDiameters[i] = p[3];
+        }
+    }
+
+    if (hasNeurites && (options & POINT_COLUMNS)) {
+        const size_t size = numberPoints - somaPointCount;
+        std::vector<floatType> columns(4 * size);
+        for (size_t i = 0; i < size; ++i) {
+            const auto& p = rows[somaPointCount + i];
+            columns[i] = p[0];
+            columns[size + i] = p[1];
+            columns[2 * size + i] = p[2];
+            columns[3 * size + i] = p[3];
+        }
+        properties._pointLevel.storeColumns(std::move(columns));
+        return;
+    }
+
+    auto& points = properties.get_mut<Property::Point>();
+    auto& diameters = properties.get_mut<Property::Diameter>();
+
+    if (hasNeurites) {
+        const size_t size = (numberPoints - somaPointCount);
+        points.resize(size);
+        diameters.resize(size);
+        for (size_t i = somaPointCount; i < numberPoints; ++i) {
+            const auto& p = rows[i];
+            const size_t section = i - somaPointCount;
+            points[section] = {p[0], p[1], p[2]};
+            diameters[section] = p[3];
+        }
+    }
+}
+
+void decodePerimeters(bool hasPerimeters,
+                      const range<const floatType>& rawPerimeters,
+                      size_t numberPoints,
+                      int firstSectionOffset,
+                      Property::Properties& properties) {
+    // soma only, won't have perimeters
+    if (firstSectionOffset == SOMA_ONLY) {
+        return;
+    }
+
+    if (!hasPerimeters) {
+        if (properties._cellLevel._cellFamily == GLIA) {
+            throw RawDataError("No empty perimeters allowed for glia morphology");
+        }
+        return;
+    }
+
+    if (rawPerimeters.size() != numberPoints) {
+        throw RawDataError("Perimeters dataset has size: " + std::to_string(rawPerimeters.size()) +
+                           " while points dataset has size: " + std::to_string(numberPoints));
+    }
+
+    // Not through `get_mut`, which would turn point columns back into points
+    properties._pointLevel._perimeters.assign(rawPerimeters.begin() + firstSectionOffset,
+                                              rawPerimeters.end());
+}
+
+void decodeMitochondria(const RawMorphology& raw, Property::Properties& properties) {
+    const auto& points = raw.mitochondriaPoints;
+
+    auto& mitoSectionId = properties.get_mut<Property::MitoNeuriteSectionId>();
+    auto& pathlength = properties.get_mut<Property::MitoPathLength>();
+    auto& diameters = properties.get_mut<Property::MitoDiameter>();
+    mitoSectionId.reserve(mitoSectionId.size() + points.size());
+    pathlength.reserve(pathlength.size() + points.size());
+    diameters.reserve(diameters.size() + points.size());
+    for (const auto& p : points) {
+        mitoSectionId.push_back(static_cast<Property::MitoNeuriteSectionId::Type>(p[0]));
+        pathlength.push_back(p[1]);
+        diameters.push_back(p[2]);
+    }
+
+    const auto& structure = raw.mitochondriaStructure;
+
+    auto& mitoSection = properties.get_mut<Property::MitoSection>();
+    mitoSection.reserve(mitoSection.size() + structure.size());
+    for (const auto& s : structure) {
+        mitoSection.emplace_back(Property::MitoSection::Type{s[0], s[1]});
+    }
+}
+
+void decodeDendriticSpinePostSynapticDensity(const RawMorphology& raw,
+                                             Property::Properties& properties) {
+    const auto& sectionIds = raw.postSynapticDensitySectionIds;
+    const auto& segmentIds = raw.postSynapticDensitySegmentIds;
+    const auto& offsets = raw.postSynapticDensityOffsets;
+
+    if (sectionIds.size() != segmentIds.size() || offsets.size() != segmentIds.size()) {
+        throw(RawDataError(
+            "Dendritic datasets must match in size:"
+            " sectionIds: " +
+            std::to_string(sectionIds.size()) + " segmentIds: " +
+            std::to_string(segmentIds.size()) + " offsets: " + std::to_string(offsets.size())));
+    }
+
+    auto& psd = properties._dendriticSpineLevel._post_synaptic_density;
+
+    psd.reserve(sectionIds.size());
+    for (size_t i = 0; i < sectionIds.size(); ++i) {
+        psd.push_back({sectionIds[i], segmentIds[i], offsets[i]});
+    }
+}
+
+/**
+ * Return `extent` of the slab as a range of `T`; it is copied into `buffer`
+ * only if it isn't suitably aligned.
+ */
+template <typename T>
+range<const T> sliceSlab(const DatasetExtent& extent,
+                         const range<const char>& slab,
+                         uint64_t slabOffset,
+                         std::vector<T>& buffer) {
+    if (extent.size == 0) {
+        return {};
+    }
+
+    if (extent.offset < slabOffset || extent.offset + extent.size > slabOffset + slab.size()) {
+        throw MorphioError("Dataset at offset " + std::to_string(extent.offset) +
+                           " is not contained in the slab");
+    }
+
+    const char* begin = slab.data() + (extent.offset - slabOffset);
+    const size_t n = extent.size / sizeof(T);
+
+    if (reinterpret_cast<std::uintptr_t>(begin) % alignof(T) == 0) {
+        return {static_cast<const T*>(static_cast<const void*>(begin)), n};
+    }
+
+    buffer.resize(n);
+    std::memcpy(buffer.data(), begin, extent.size);
+    return buffer;
+}
+
+/**
+ * Fill `extent` if `dataset` can be read without HDF5: it has type `T`, the
+ * expected shape and contiguous storage. One dimensional if `columns` is 0.
+ */
+template <typename T>
+bool locateDataset(const HighFive::DataSet& dataset, size_t columns, DatasetExtent& extent) {
+    const auto dims = dataset.getSpace().getDimensions();
+    const size_t rank = columns == 0 ? 1 : 2;
+    if (dims.size() != rank || (rank == 2 && dims[1] != columns)) {
+        return false;
+    }
+
+    if (dataset.getDataType() != HighFive::AtomicType<T>()) {
+        return false;
+    }
+
+    const auto dcpl = dataset.getCreatePropertyList();
+    if (H5Pget_layout(dcpl.getId()) != H5D_CONTIGUOUS) {
+        return false;
+    }
+
+    const size_t n = dims[0] * std::max<size_t>(columns, 1);
+    extent.size = n * sizeof(T);
+    if (n == 0) {
+        extent.offset = 0;
+        return true;
+    }
+
+    if (dataset.getStorageSize() != extent.size) {
+        return false;
+    }
+
+    extent.offset = dataset.getOffset();
+    return true;
+}
+
+int decodeCommon(const RawMorphologySlice& raw,
+                 const std::string& uri,
+                 unsigned int options,
+                 Property::Properties& properties) {
+    properties._cellLevel._version = raw.version;
+    properties._cellLevel._cellFamily = raw.cellFamily;
+
+    const int firstSectionOffset = decodeSections(raw.structure, uri, properties);
+
+    decodePoints(raw.points, firstSectionOffset, options, properties);
+
+    if (properties._cellLevel.minorVersion() >= 1) {
+        decodePerimeters(
+            raw.hasPerimeters, raw.perimeters, raw.points.size(), firstSectionOffset, properties);
+    }
+
+    return firstSectionOffset;
+}
+
+void decodeSomaType(const std::string& uri,
+                    WarningHandler* warning_handler,
+                    Property::Properties& properties) {
+    switch (properties._somaLevel._points.size()) {
+    case 0:
+        warning_handler->emit(std::make_shared<NoSomaFound>(uri));
+        properties._cellLevel._somaType = enums::SOMA_UNDEFINED;
+        break;
+    case 1:
+        throw RawDataError("Morphology contour with only a single point is not valid: " + uri);
+    case 2:
+        properties._cellLevel._somaType = enums::SOMA_UNDEFINED;
+        break;
+    default:
+        properties._cellLevel._somaType = enums::SOMA_SIMPLE_CONTOUR;
+        break;
+    }
+}
+
+}  // namespace
 
 MorphologyHDF5::MorphologyHDF5(const HighFive::Group& group, const std::string& uri)
     : _group(group)
     , _uri(uri) {}
 
-Property::Properties load(const std::string& uri, WarningHandler* warning_handler) {
+Property::Properties load(const std::string& uri,
+                          WarningHandler* warning_handler,
+                          unsigned int options) {
+    RawMorphology raw;
     try {
         std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
         HighFive::SilenceHDF5 silence;
         auto file = HighFive::File(uri, HighFive::File::ReadOnly);
-        return MorphologyHDF5(file.getGroup("/"), uri).load(warning_handler);
-
+        raw = MorphologyHDF5(file.getGroup("/"), uri).read();
     } catch (const HighFive::FileException& exc) {
         throw RawDataError("Could not open morphology file " + uri + ": " + exc.what());
     }
+
+    return decode(raw, uri, warning_handler, options);
 }
 
-Property::Properties load(const HighFive::Group& group, WarningHandler* warning_handler) {
-    std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+Property::Properties load(const HighFive::Group& group,
+                          WarningHandler* warning_handler,
+                          unsigned int options) {
     if (warning_handler == nullptr) {
         warning_handler = getWarningHandler().get();
     }
-    return MorphologyHDF5(group).load(warning_handler);
+
+    const std::string uri = "HDF5 GROUP";
+    RawMorphology raw;
+    {
+        std::lock_guard<std::recursive_mutex> lock(morphio::readers::h5::global_hdf5_mutex());
+        raw = MorphologyHDF5(group, uri).read();
+    }
+
+    return decode(raw, uri, warning_handler, options);
 }
 
-Property::Properties MorphologyHDF5::load(WarningHandler* warning_handler) {
-    _readMetadata();
+Property::Properties decode(const RawMorphology& raw,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options) {
+    RawMorphologySlice slice;
+    slice.version = raw.version;
+    slice.cellFamily = raw.cellFamily;
+    slice.points = raw.points;
+    slice.structure = raw.structure;
+    slice.hasPerimeters = raw.hasPerimeters;
+    slice.perimeters = raw.perimeters;
+
+    Property::Properties properties;
+    decodeCommon(slice, uri, options, properties);
+
+    if (properties._cellLevel.minorVersion() >= 2) {
+        decodeMitochondria(raw, properties);
+        properties._endoplasmicReticulumLevel = raw.endoplasmicReticulum;
+    }
+
+    if (properties._cellLevel.minorVersion() >= 3 &&
+        properties._cellLevel._cellFamily == CellFamily::SPINE) {
+        decodeDendriticSpinePostSynapticDensity(raw, properties);
+    }
+
+    decodeSomaType(uri, warning_handler, properties);
+
+    return properties;
+}
+
+Property::Properties decode(const RawMorphologySlice& raw,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options) {
+    Property::Properties properties;
+    decodeCommon(raw, uri, options, properties);
+    decodeSomaType(uri, warning_handler, properties);
+
+    return properties;
+}
+
+Property::Properties decode(const MorphologyLayout& layout,
+                            const range<const char>& slab,
+                            uint64_t slabOffset,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options) {
+    std::vector<std::array<floatType, 4>> pointsBuffer;
+    std::vector<std::array<int, 3>> structureBuffer;
+    std::vector<floatType> perimetersBuffer;
+
+    RawMorphologySlice slice;
+    slice.version = layout.version;
+    slice.cellFamily = layout.cellFamily;
+    slice.points = sliceSlab(layout.points, slab, slabOffset, pointsBuffer);
+    slice.structure = sliceSlab(layout.structure, slab, slabOffset, structureBuffer);
+    slice.hasPerimeters = layout.hasPerimeters;
+    if (layout.hasPerimeters) {
+        slice.perimeters = sliceSlab(layout.perimeters, slab, slabOffset, perimetersBuffer);
+    }
+
+    return decode(slice, uri, warning_handler, options);
+}
+
+uint64_t MorphologyLayout::begin() const {
+    uint64_t offset = std::numeric_limits<uint64_t>::max();
+    for (const auto* extent : {&points, &structure, &perimeters}) {
+        if (extent->size > 0) {
+            offset = std::min(offset, extent->offset);
+        }
+    }
+    return offset == std::numeric_limits<uint64_t>::max() ? 0 : offset;
+}
+
+uint64_t MorphologyLayout::end() const {
+    uint64_t offset = 0;
+    for (const auto* extent : {&points, &structure, &perimeters}) {
+        if (extent->size > 0) {
+            offset = std::max(offset, extent->offset + extent->size);
+        }
+    }
+    return offset;
+}
+
+MorphologyLayout MorphologyHDF5::layout() {
+    MorphologyLayout layout;
+
+    // Anything unexpected is reported when the morphology is read through HDF5.
+    try {
+        _readMetadata();
+        layout.version = _raw.version;
+        layout.cellFamily = _raw.cellFamily;
+
+        const uint32_t minorVersion = std::get<2>(_raw.version);
+        if (minorVersion >= 2 &&
+            (_group.exist(_g_mitochondria) || _group.exist(_g_endoplasmic_reticulum))) {
+            return layout;
+        }
+
+        if (minorVersion >= 3 && _raw.cellFamily == CellFamily::SPINE) {
+            return layout;
+        }
+
+        if (!locateDataset<floatType>(_group.getDataSet(_d_points), 4, layout.points) ||
+            !locateDataset<int>(_group.getDataSet(_d_structure), 3, layout.structure)) {
+            return layout;
+        }
+
+        if (minorVersion >= 1 && _group.exist(_d_perimeters)) {
+            layout.hasPerimeters = true;
+            if (!locateDataset<floatType>(_group.getDataSet(_d_perimeters), 0, layout.perimeters)) {
+                return layout;
+            }
+        }
+    } catch (const MorphioError&) {
+        return layout;
+    } catch (const HighFive::Exception&) {
+        return layout;
+    }
 
-    int firstSectionOffset = _readSections();
+    layout.isDirectlyReadable = true;
+    return layout;
+}
 
-    _readPoints(firstSectionOffset);
+RawMorphology MorphologyHDF5::read() {
+    _readMetadata();
+    _readStructure();
+    _readPoints();
 
-    if (_properties._cellLevel.minorVersion() >= 1) {
-        _readPerimeters(firstSectionOffset);
+    const uint32_t minorVersion = std::get<2>(_raw.version);
+    if (minorVersion >= 1) {
+        _readPerimeters();
 
-        if (_properties._cellLevel.minorVersion() >= 2) {
+        if (minorVersion >= 2) {
             _readMitochondria();
             _readEndoplasmicReticulum();
         }
 
-        if (_properties._cellLevel.minorVersion() >= 3 &&
-            _properties._cellLevel._cellFamily == CellFamily::SPINE) {
+        if (minorVersion >= 3 && _raw.cellFamily == CellFamily::SPINE) {
             _readDendriticSpinePostSynapticDensity();
         }
     }
 
-    switch (_properties._somaLevel._points.size()) {
-    case 0:
-        warning_handler->emit(std::make_shared<NoSomaFound>(_uri));
-        _properties._cellLevel._somaType = enums::SOMA_UNDEFINED;
-        break;
-    case 1:
-        throw RawDataError("Morphology contour with only a single point is not valid: " + _uri);
-    case 2:
-        _properties._cellLevel._somaType = enums::SOMA_UNDEFINED;
-        break;
-    default:
-        _properties._cellLevel._somaType = enums::SOMA_SIMPLE_CONTOUR;
-        break;
-    }
-
-    return _properties;
+    return std::move(_raw);
 }
 
 void MorphologyHDF5::_readMetadata() {
     // default to h5v1.0
     uint32_t majorVersion = 1;
     uint32_t minorVersion = 0;
-    _properties._cellLevel._cellFamily = CellFamily::NEURON;
+    _raw.cellFamily = CellFamily::NEURON;
 
     if (!_group.exist(_d_points) || !_group.exist(_d_structure)) {
         // h5v2 is deprecated, but it can be detected, throw a custom error messages if it is
@@ -160,7 +568,7 @@ void MorphologyHDF5::_readMetadata() {
                 (minorVersion == 1 || minorVersion == 2 || minorVersion == 3)) {
                 uint32_t family;
                 metadata.getAttribute(_a_family).read(family);
-                _properties._cellLevel._cellFamily = static_cast<CellFamily>(family);
+                _raw.cellFamily = static_cast<CellFamily>(family);
             } else {
                 throw RawDataError("Error in " + _uri +
                                    "\nUnsupported h5 version: " + std::to_string(majorVersion) +
@@ -176,10 +584,10 @@ void MorphologyHDF5::_readMetadata() {
         }
     }
 
-    _properties._cellLevel._version = {"h5", majorVersion, minorVersion};
+    _raw.version = {"h5", majorVersion, minorVersion};
 }
 
-void MorphologyHDF5::_readPoints(int firstSectionOffset) {
+void MorphologyHDF5::_readPoints() {
     constexpr size_t pointColumns = 4;
 
     const auto pointsDataSet = _group.getDataSet(_d_points);
@@ -194,48 +602,14 @@ void MorphologyHDF5::_readPoints(int firstSectionOffset) {
                            "': incorrect number of columns for points");
     }
 
-    std::vector<std::array<floatType, pointColumns>> hdf5Data(numberPoints);
-
-    if (!hdf5Data.empty()) {
-        pointsDataSet.read(hdf5Data.front().data());
-    }
-
-    const bool hasSoma = firstSectionOffset != 0;
-    const bool hasNeurites = static_cast<size_t>(firstSectionOffset) < numberPoints;
-    const size_t somaPointCount = hasNeurites ? static_cast<size_t>(firstSectionOffset)
-                                              : hdf5Data.size();
-
-    auto& somaPoints = _properties._somaLevel._points;
-    auto& somaDiameters = _properties._somaLevel._diameters;
-
-    if (hasSoma) {
-        somaPoints.resize(somaPointCount);
-        somaDiameters.resize(somaPointCount);
+    _raw.points.resize(numberPoints);
 
-        for (size_t i = 0; i < somaPointCount; ++i) {
-            const auto& p = hdf5Data[i];
-            somaPoints[i] = {p[0], p[1], p[2]};
-            somaDiameters[i] = p[3];
-        }
-    }
-
-    auto& points = _properties.get_mut<Property::Point>();
-    auto& diameters = _properties.get_mut<Property::Diameter>();
-
-    if (hasNeurites) {
-        const size_t size = (hdf5Data.size() - somaPointCount);
-        points.resize(size);
-        diameters.resize(size);
-        for (size_t i = somaPointCount; i < hdf5Data.size(); ++i) {
-            const auto& p = hdf5Data[i];
-            const size_t section = i - somaPointCount;
-            points[section] = {p[0], p[1], p[2]};
-            diameters[section] = p[3];
-        }
+    if (!_raw.points.empty()) {
+        pointsDataSet.read(_raw.points.front().data());
     }
 }
 
-int MorphologyHDF5::_readSections() {
+void MorphologyHDF5::_readStructure() {
     // Important: The code used to split the reading of the sections and types
     //            into two separate fine-grained H5 selections. This does not
     //            reduce the number of I/O operations, but increases them by
@@ -252,75 +626,21 @@ int MorphologyHDF5::_readSections() {
                            " bad number of dimensions in 'structure' dataspace"));
     }
 
-    std::vector<std::array<int, structureV1Columns>> vec(dims[0]);
+    _raw.structure.resize(dims[0]);
     if (dims[0] > 0) {
-        structure.read(vec.front().data());
-    }
-
-    assert(!vec.empty());
-
-    bool hasSoma = true;
-    if (static_cast<SectionType>(vec[0][SECTION_TYPE]) != SECTION_SOMA) {
-        hasSoma = false;
-    } else if (vec.size() == 1) {
-        return SOMA_ONLY;
-    }
-
-    const size_t firstSection = hasSoma ? 1 : 0;
-    const int firstSectionOffset = vec[firstSection][SECTION_START_OFFSET];
-
-    auto& sections = _properties.get_mut<Property::Section>();
-    sections.reserve(vec.size() - firstSection);
-
-    auto& types = _properties.get_mut<Property::SectionType>();
-    types.reserve(vec.size() - firstSection);
-
-    // The first section is skipped if it corresponds to a soma
-    for (size_t i = firstSection; i < vec.size(); ++i) {
-        const auto& section = vec[i];
-        SectionType type = static_cast<SectionType>(section[SECTION_TYPE]);
-
-        if (section[SECTION_TYPE] >= SECTION_OUT_OF_RANGE_START || section[SECTION_TYPE] <= 0) {
-            details::ErrorMessages err;
-            throw RawDataError(err.ERROR_UNSUPPORTED_SECTION_TYPE(0, type));
-        } else if (!hasSoma && type == SECTION_SOMA) {
-            throw(RawDataError("Error reading morphology " + _uri +
-                               ": it has soma section that doesn't come first"));
-        } else if (hasSoma && type == SECTION_SOMA) {
-            throw(RawDataError("Error reading morphology " + _uri +
-                               ": it has multiple soma sections"));
-        }
-
-        sections.emplace_back(
-            Property::Section::Type{section[SECTION_START_OFFSET] - firstSectionOffset,
-                                    section[SECTION_PARENT_OFFSET] - (hasSoma ? 1 : 0)});
-        types.emplace_back(type);
+        structure.read(_raw.structure.front().data());
     }
-
-    return firstSectionOffset;
 }
 
-void MorphologyHDF5::_readPerimeters(int firstSectionOffset) {
-    if (!(_properties._cellLevel.majorVersion() == 1 &&
-          _properties._cellLevel.minorVersion() > 0)) {
+void MorphologyHDF5::_readPerimeters() {
+    if (!(std::get<1>(_raw.version) == 1 && std::get<2>(_raw.version) > 0)) {
         throw RawDataError("Perimeter information is available starting at v1.1");
     }
 
-    // soma only, won't have perimeters
-    if (firstSectionOffset == SOMA_ONLY) {
-        return;
+    _raw.hasPerimeters = _group.exist(_d_perimeters);
+    if (_raw.hasPerimeters) {
+        _read("", _d_perimeters, 1, _raw.perimeters);
     }
-
-    if (!_group.exist(_d_perimeters)) {
-        if (_properties._cellLevel._cellFamily == GLIA) {
-            throw RawDataError("No empty perimeters allowed for glia morphology");
-        }
-        return;
-    }
-
-    auto& perimeters = _properties.get_mut<Property::Perimeter>();
-    _read("", _d_perimeters, 1, perimeters);
-    perimeters.erase(perimeters.begin(), perimeters.begin() + firstSectionOffset);
 }
 
 
@@ -352,29 +672,15 @@ void MorphologyHDF5::_read(const std::string& groupName,
 }
 
 void MorphologyHDF5::_readDendriticSpinePostSynapticDensity() {
-    std::vector<morphio::Property::DendriticSpine::SectionId_t> sectionIds;
-    _read(_g_postsynaptic_density, _d_dendritic_spine_section_id, 1, sectionIds);
-
-    std::vector<morphio::Property::DendriticSpine::SegmentId_t> segmentIds;
-    _read(_g_postsynaptic_density, _d_dendritic_spine_segment_id, 1, segmentIds);
-
-    std::vector<morphio::Property::DendriticSpine::Offset_t> offsets;
-    _read(_g_postsynaptic_density, _d_dendritic_spine_offset, 1, offsets);
-
-    if (sectionIds.size() != segmentIds.size() || offsets.size() != segmentIds.size()) {
-        throw(RawDataError(
-            "Dendritic datasets must match in size:"
-            " sectionIds: " +
-            std::to_string(sectionIds.size()) + " segmentIds: " +
-            std::to_string(segmentIds.size()) + " offsets: " + std::to_string(offsets.size())));
-    }
-
-    auto& properties = _properties._dendriticSpineLevel._post_synaptic_density;
-
-    properties.reserve(sectionIds.size());
-    for (size_t i = 0; i < sectionIds.size(); ++i) {
-        properties.push_back({sectionIds[i], segmentIds[i], offsets[i]});
-    }
+    _read(_g_postsynaptic_density,
+          _d_dendritic_spine_section_id,
+          1,
+          _raw.postSynapticDensitySectionIds);
+    _read(_g_postsynaptic_density,
+          _d_dendritic_spine_segment_id,
+          1,
+          _raw.postSynapticDensitySegmentIds);
+    _read(_g_postsynaptic_density, _d_dendritic_spine_offset, 1, _raw.postSynapticDensityOffsets);
 }
 
 void MorphologyHDF5::_readEndoplasmicReticulum() {
@@ -382,22 +688,11 @@ void MorphologyHDF5::_readEndoplasmicReticulum() {
         return;
     }
 
-    _read(_g_endoplasmic_reticulum,
-          _d_section_index,
-          1,
-          _properties._endoplasmicReticulumLevel._sectionIndices);
-    _read(_g_endoplasmic_reticulum,
-          _d_volume,
-          1,
-          _properties._endoplasmicReticulumLevel._volumes);
-    _read(_g_endoplasmic_reticulum,
-          _d_surface_area,
-          1,
-          _properties._endoplasmicReticulumLevel._surfaceAreas);
-    _read(_g_endoplasmic_reticulum,
-          _d_filament_count,
-          1,
-          _properties._endoplasmicReticulumLevel._filamentCounts);
+    auto& reticulum = _raw.endoplasmicReticulum;
+    _read(_g_endoplasmic_reticulum, _d_section_index, 1, reticulum._sectionIndices);
+    _read(_g_endoplasmic_reticulum, _d_volume, 1, reticulum._volumes);
+    _read(_g_endoplasmic_reticulum, _d_surface_area, 1, reticulum._surfaceAreas);
+    _read(_g_endoplasmic_reticulum, _d_filament_count, 1, reticulum._filamentCounts);
 }
 
 void MorphologyHDF5::_readMitochondria() {
@@ -405,28 +700,8 @@ void MorphologyHDF5::_readMitochondria() {
         return;
     }
 
-    std::vector<std::vector<floatType>> points;
-    _read(_g_mitochondria, _d_points, 2, points);
-
-    auto& mitoSectionId = _properties.get_mut<Property::MitoNeuriteSectionId>();
-    auto& pathlength = _properties.get_mut<Property::MitoPathLength>();
-    auto& diameters = _properties.get_mut<Property::MitoDiameter>();
-    mitoSectionId.reserve(mitoSectionId.size() + points.size());
-    pathlength.reserve(pathlength.size() + points.size());
-    diameters.reserve(diameters.size() + points.size());
-    for (const auto& p : points) {
-        mitoSectionId.push_back(static_cast<Property::MitoNeuriteSectionId::Type>(p[0]));
-        pathlength.push_back(p[1]);
-        diameters.push_back(p[2]);
-    }
-
-    std::vector<std::vector<int32_t>> structure;
-    _read(_g_mitochondria, _d_structure, 2, structure);
-
-    auto& mitoSection = _properties.get_mut<Property::MitoSection>();
-    mitoSection.reserve(mitoSection.size() + structure.size());
-    for (auto& s : structure)
-        mitoSection.emplace_back(Property::MitoSection::Type{s[0], s[1]});
+    _read(_g_mitochondria, _d_points, 2, _raw.mitochondriaPoints);
+    _read(_g_mitochondria, _d_structure, 2, _raw.mitochondriaStructure);
 }
 
 }  // namespace h5
@@ -4,8 +4,10 @@
  */
 
 #pragma once
+#include <array>
 #include <mutex>
 #include <string>  // std::string
+#include <vector>
 
 #include <morphio/properties.h>
 #include <morphio/warning_handling.h>
@@ -15,22 +17,102 @@
 namespace morphio {
 namespace readers {
 namespace h5 {
-Property::Properties load(const std::string& uri, WarningHandler*);
-Property::Properties load(const HighFive::Group& group, WarningHandler*);
+Property::Properties load(const std::string& uri,
+                          WarningHandler*,
+                          unsigned int options = NO_MODIFIER);
+Property::Properties load(const HighFive::Group& group,
+                          WarningHandler*,
+                          unsigned int options = NO_MODIFIER);
+
+/**
+ * The content of the datasets of a morphology, as it is stored on disk.
+ *
+ * Fetching it requires holding `global_hdf5_mutex()`, turning it into
+ * `Property::Properties` (see `decode`) does not touch HDF5 at all.
+ */
+struct RawMorphology {
+    MorphologyVersion version = {"h5", 1, 0};
+    CellFamily cellFamily = CellFamily::NEURON;
+
+    std::vector<std::array<floatType, 4>> points;
+    std::vector<std::array<int, 3>> structure;
+
+    bool hasPerimeters = false;
+    std::vector<floatType> perimeters;
+
+    std::vector<std::vector<floatType>> mitochondriaPoints;
+    std::vector<std::vector<int32_t>> mitochondriaStructure;
+
+    Property::EndoplasmicReticulumLevel endoplasmicReticulum;
+
+    std::vector<Property::DendriticSpine::SectionId_t> postSynapticDensitySectionIds;
+    std::vector<Property::DendriticSpine::SegmentId_t> postSynapticDensitySegmentIds;
+    std::vector<Property::DendriticSpine::Offset_t> postSynapticDensityOffsets;
+};
+
+/**
+ * A non-owning view of the datasets of a morphology without organelles.
+ */
+struct RawMorphologySlice {
+    MorphologyVersion version = {"h5", 1, 0};
+    CellFamily cellFamily = CellFamily::NEURON;
+
+    range<const std::array<floatType, 4>> points;
+    range<const std::array<int, 3>> structure;
+
+    bool hasPerimeters = false;
+    range<const floatType> perimeters;
+};
+
+/**
+ * Where the bytes of a dataset are stored in the file.
+ */
+struct DatasetExtent {
+    uint64_t offset = 0;  // from the start of the file, in bytes
+    uint64_t size = 0;    // in bytes
+};
+
+/**
+ * Where the datasets of a morphology are stored in the file.
+ *
+ * If `isDirectlyReadable` is set, the datasets are stored contiguously, in
+ * native types, and the morphology can be decoded from the raw bytes of the
+ * file without going through HDF5.
+ */
+struct MorphologyLayout {
+    bool isDirectlyReadable = false;
+
+    MorphologyVersion version = {"h5", 1, 0};
+    CellFamily cellFamily = CellFamily::NEURON;
+
+    DatasetExtent points;
+    DatasetExtent structure;
+
+    bool hasPerimeters = false;
+    DatasetExtent perimeters;
+
+    /** The smallest range of bytes containing all datasets */
+    uint64_t begin() const;
+    uint64_t end() const;
+};
 
 class MorphologyHDF5
 {
   public:
     explicit MorphologyHDF5(const HighFive::Group& group, const std::string& uri = "HDF5 GROUP");
     virtual ~MorphologyHDF5() = default;
-    Property::Properties load(WarningHandler*);
+
+    /** Read all datasets; the caller must hold `global_hdf5_mutex()` */
+    RawMorphology read();
+
+    /** Locate the datasets without reading them; the caller must hold `global_hdf5_mutex()` */
+    MorphologyLayout layout();
 
   private:
-    void _checkVersion();
     void _readMetadata();
-    void _readPoints(int);
-    int _readSections();
-    void _readPerimeters(int);
+    void _readPoints();
+    void _readStructure();
+    void _readPerimeters();
     void _readMitochondria();
     void _readEndoplasmicReticulum();
     void _readDendriticSpinePostSynapticDensity();
@@ -42,10 +124,38 @@ class MorphologyHDF5
                T& data);
 
     HighFive::Group _group;
-    Property::Properties _properties;
+    RawMorphology _raw;
     std::string _uri;
 };
 
+/**
+ * Split, validate and assemble the raw datasets into `Property::Properties`.
+ *
+ * This is pure CPU work and is safe to run without holding `global_hdf5_mutex()`.
+ * With the `POINT_COLUMNS` option, the points are stored as columns (see
+ * `Property::PointLevel::storeColumns`).
+ */
+Property::Properties decode(const RawMorphology& raw,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options = NO_MODIFIER);
+
+Property::Properties decode(const RawMorphologySlice& raw,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options = NO_MODIFIER);
+
+/**
+ * Decode a directly readable morphology from `slab`, which contains the bytes
+ * of the file starting at `slabOffset`.
+ */
+Property::Properties decode(const MorphologyLayout& layout,
+                            const range<const char>& slab,
+                            uint64_t slabOffset,
+                            const std::string& uri,
+                            WarningHandler* warning_handler,
+                            unsigned int options = NO_MODIFIER);
+
 inline std::recursive_mutex& global_hdf5_mutex() {
     static std::recursive_mutex _mutex;
     return _mutex;
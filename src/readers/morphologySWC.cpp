@@ -5,17 +5,21 @@
 
 #include "morphologySWC.h"
 
+#include <algorithm>      // std::find, std::lower_bound, std::max, std::sort
+#include <atomic>         // std::atomic
 #include <cctype>         // isdigit
 #include <cstdint>        // uint32_t
+#include <cstring>        // std::memchr
+#include <exception>      // std::exception_ptr
+#include <istream>        // std::istream
 #include <memory>         // std::shared_ptr
 #include <string>         // std::string
-#include <unordered_map>  // std::unordered_map
+#include <thread>         // std::thread
 #include <utility>
 #include <vector>         // std::vector
 
+#include <morphio/morphology.h>
 #include <morphio/mut/morphology.h>
-#include <morphio/mut/section.h>
-#include <morphio/mut/soma.h>
 #include <morphio/properties.h>
 #include <morphio/warning_handling.h>
 
@@ -33,20 +37,20 @@ const unsigned int SWC_ROOT = 0xFFFFFFFD;
 /* simple stream parser for SWC file format which is a line oriented format
  *
  * This parser advances across comments and blank lines, and allows the caller
- * to get integers and floats
+ * to get integers and floats. It reads from a borrowed buffer, which needn't
+ * be null terminated.
  */
 class SWCTokenizer
 {
 public:
-  explicit SWCTokenizer(std::string contents, std::string path)
-      : contents_(std::move(contents))
-      , path_(std::move(path)) {
-      // ensure null termination
-      (void) contents_.c_str();
-  }
+  SWCTokenizer(range<const char> contents, std::string path, size_t firstLine = 1)
+      : pos_(contents.data())
+      , end_(contents.data() + contents.size())
+      , line_(firstLine)
+      , path_(std::move(path)) {}
 
   bool done() const noexcept {
-      return pos_ >= contents_.size();
+      return pos_ >= end_;
   }
 
   size_t lineNumber() const noexcept {
@@ -54,23 +58,19 @@ public:
   }
 
   void skip_to(char value) {
-      std::size_t pos = contents_.find_first_of(value, pos_);
-      if (pos == std::string::npos) {
-          pos_ = contents_.size();
-      }
-      pos_ = pos;
-  }
-
-  void advance_to_non_whitespace() {
       if (done()) {
           return;
       }
-      std::size_t pos = contents_.find_first_not_of(" \t\r", pos_);
-      if (pos == std::string::npos) {
-          pos_ = contents_.size();
-          return;
+      // memchr is vectorized by the standard libraries
+      const auto* found =
+          static_cast<const char*>(std::memchr(pos_, value, static_cast<size_t>(end_ - pos_)));
+      pos_ = found == nullptr ? end_ : found;
+  }
+
+  void advance_to_non_whitespace() noexcept {
+      while (!done() && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r')) {
+          ++pos_;
       }
-      pos_ = pos;
   }
 
   void advance_to_number() {
@@ -81,7 +81,7 @@ public:
           throw RawDataError(err.EARLY_END_OF_FILE(line_));
       }
 
-      auto c = contents_.at(pos_);
+      auto c = *pos_;
       if (std::isdigit(c) != 0 || c == '-' || c == '+' || c == '.') {
           return;
       }
@@ -92,31 +92,23 @@ public:
 
   int64_t read_int() {
       advance_to_number();
-      try {
-          auto parsed = stn_.toInt(contents_, pos_);
-          pos_ = std::get<1>(parsed);
-          return std::get<0>(parsed);
-      } catch(std::invalid_argument&e) {
-          throw RawDataError(e.what());
-      }
+      return consume(parseInt(remaining()));
   }
 
   floatType read_float() {
       advance_to_number();
-      auto parsed = stn_.toFloat(contents_, pos_);
-      pos_ = std::get<1>(parsed);
-      return std::get<0>(parsed);
+      return consume(parseFloat(remaining()));
   }
 
   void skip_blank_lines_and_comments() {
       advance_to_non_whitespace();
 
-      while (!done() && (contents_.at(pos_) == '#' || contents_.at(pos_) == '\n')) {
-          if (contents_.at(pos_) == '#') {
+      while (!done() && (*pos_ == '#' || *pos_ == '\n')) {
+          if (*pos_ == '#') {
               skip_to('\n');
           }
 
-          if (!done() && contents_.at(pos_) == '\n') {
+          if (!done() && *pos_ == '\n') {
               ++line_;
               ++pos_;
           }
@@ -126,7 +118,7 @@ public:
 
   void finish_line() {
       skip_to('\n');
-      if (!done() && contents_.at(pos_) == '\n') {
+      if (!done() && *pos_ == '\n') {
           ++line_;
           ++pos_;
       }
@@ -134,10 +126,23 @@ public:
 
 
 private:
-  size_t pos_ = 0;
+  range<const char> remaining() const noexcept {
+      return {pos_, static_cast<size_t>(end_ - pos_)};
+  }
+
+  template <typename T>
+  T consume(const std::tuple<T, size_t>& parsed) {
+      if (std::get<1>(parsed) == 0) {
+          details::ErrorMessages err(path_);
+          throw RawDataError(err.ERROR_LINE_NON_PARSABLE(line_));
+      }
+      pos_ += std::get<1>(parsed);
+      return std::get<0>(parsed);
+  }
+
+  const char* pos_ = nullptr;
+  const char* end_ = nullptr;
   size_t line_ = 1;
-  std::string contents_;
-  StringToNumber stn_;
   std::string path_;
 };
 
@@ -152,20 +157,17 @@ struct SWCSample {
     unsigned int lineNumber = 0;
 };
 
-static std::vector<unsigned int> gatherLineNumbers(const std::vector<SWCSample>& samples) {
-    std::vector<unsigned int> lineNumbers;
-    std::transform(samples.begin(),
-                   samples.cend(),
-                   std::back_inserter(lineNumbers),
-                   [](const SWCSample& sample) { return sample.lineNumber; });
-    return lineNumbers;
-}
-
-static std::vector<SWCSample> readSamples(const std::string& contents, const std::string& path) {
-    std::vector<SWCSample> samples;
+/* Append the samples of `contents` to `samples`, numbering its lines from `firstLine`
+ *
+ * Return the number of line feeds that were read.
+ */
+static size_t readChunk(range<const char> contents,
+                        const std::string& path,
+                        size_t firstLine,
+                        std::vector<SWCSample>& samples) {
     SWCSample sample;
 
-    SWCTokenizer tokenizer{contents, path};
+    SWCTokenizer tokenizer{contents, path, firstLine};
 
     tokenizer.skip_blank_lines_and_comments();
     while (!tokenizer.done()) {
@@ -216,6 +218,189 @@ static std::vector<SWCSample> readSamples(const std::string& contents, const std
         throw RawDataError(err.EARLY_END_OF_FILE(0));
     }
 
+    return tokenizer.lineNumber() - firstLine;
+}
+
+/* The input of the SWC reader, as a series of blocks that end after a line feed
+ *
+ * A buffer is a single block, which is borrowed. A stream is read `blockSize`
+ * bytes at a time into a buffer reused from one block to the next; the
+ * unfinished line at the end of a read is carried over to the next block, which
+ * grows if a line doesn't fit.
+ */
+class SWCInput
+{
+  public:
+    explicit SWCInput(range<const char> contents)
+        : contents_(contents) {}
+
+    SWCInput(std::istream& stream, std::string path, size_t blockSize)
+        : stream_(&stream)
+        , path_(std::move(path))
+        , blockSize_(blockSize) {}
+
+    /** The next block, empty at the end of the input */
+    range<const char> next() {
+        if (stream_ == nullptr) {
+            const auto block = contents_;
+            contents_ = {};
+            return block;
+        }
+
+        buffer_.erase(buffer_.begin(), buffer_.begin() + static_cast<std::ptrdiff_t>(returned_));
+        while (true) {
+            const size_t carried = buffer_.size();
+            buffer_.resize(carried + blockSize_);
+            stream_->read(buffer_.data() + carried, static_cast<std::streamsize>(blockSize_));
+            buffer_.resize(carried + static_cast<size_t>(stream_->gcount()));
+            if (stream_->bad()) {
+                throw RawDataError("Failed to read: " + path_);
+            }
+
+            if (buffer_.size() == carried) {
+                // The end of the stream, the last line may have no line feed
+                returned_ = buffer_.size();
+                return {buffer_.data(), returned_};
+            }
+
+            // The carried over bytes have no line feed
+            const char* const readBegin = buffer_.data() + carried;
+            const char* blockEnd = buffer_.data() + buffer_.size();
+            while (blockEnd != readBegin && blockEnd[-1] != '\n') {
+                --blockEnd;
+            }
+            if (blockEnd != readBegin) {
+                returned_ = static_cast<size_t>(blockEnd - buffer_.data());
+                return {buffer_.data(), returned_};
+            }
+        }
+    }
+
+  private:
+    range<const char> contents_;
+
+    std::istream* stream_ = nullptr;
+    std::string path_;
+    size_t blockSize_ = 0;
+    std::vector<char> buffer_;
+    size_t returned_ = 0;  // the size of the last block, at the start of buffer_
+};
+
+// Below this size per thread, starting the threads costs more than it saves
+const size_t MIN_CHUNK_SIZE = 4 * 1024 * 1024;
+
+// Smaller blocks are read on the calling thread
+const size_t MIN_PARALLEL_SIZE = 2 * MIN_CHUNK_SIZE;
+
+// The size of the blocks read from a stream, which can be split in a few chunks
+const size_t STREAM_BLOCK_SIZE = 64 * 1024 * 1024;
+
+// Set by set_maximum_swc_threads, 0 for one per hardware thread
+std::atomic<unsigned int> maximumThreads{0};
+
+// Set on the threads of the collection loaders, which keep the cores busy already
+thread_local bool serialParsing = false;
+
+static size_t threadCount() noexcept {
+    if (serialParsing) {
+        return 1;
+    }
+    const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+    const unsigned int maximum = maximumThreads.load(std::memory_order_relaxed);
+    return maximum == 0 ? hardware : std::min(maximum, hardware);
+}
+
+/* Append the samples of `block` to `samples`, on several threads if it's large
+ *
+ * `lineCount` is the number of line feeds before the block, and is advanced
+ * past it. The block is split after line feeds into chunks that are tokenized
+ * independently, and whose line numbers are shifted when they are merged. If a
+ * chunk is invalid, the first invalid one is parsed again with its actual line
+ * numbers, so the error is the first of the block and points at its line.
+ */
+static void readBlock(range<const char> block,
+                      const std::string& path,
+                      size_t& lineCount,
+                      std::vector<SWCSample>& samples) {
+    const size_t n_threads = block.size() < MIN_PARALLEL_SIZE
+                                 ? 1
+                                 : std::min(threadCount(), block.size() / MIN_CHUNK_SIZE);
+    if (n_threads < 2) {
+        lineCount += readChunk(block, path, lineCount + 1, samples);
+        return;
+    }
+
+    std::vector<range<const char>> chunks;
+    const char* begin = block.data();
+    const char* const end = block.data() + block.size();
+    for (size_t i = 1; i <= n_threads && begin < end; ++i) {
+        const char* split = block.data() + i * block.size() / n_threads;
+        if (split < begin) {
+            split = begin;
+        }
+        if (split < end) {
+            const auto* found = static_cast<const char*>(
+                std::memchr(split, '\n', static_cast<size_t>(end - split)));
+            split = found == nullptr ? end : found + 1;
+        }
+        chunks.emplace_back(begin, static_cast<size_t>(split - begin));
+        begin = split;
+    }
+
+    std::vector<std::vector<SWCSample>> chunkSamples(chunks.size());
+    std::vector<size_t> lineCounts(chunks.size());
+    std::vector<std::exception_ptr> errors(chunks.size());
+    const auto work = [&](size_t chunk) {
+        try {
+            lineCounts[chunk] = readChunk(chunks[chunk], path, 1, chunkSamples[chunk]);
+        } catch (...) {
+            errors[chunk] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t chunk = 1; chunk < chunks.size(); ++chunk) {
+        workers.emplace_back(work, chunk);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    size_t linesBefore = lineCount;
+    for (size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        if (errors[chunk]) {
+            std::vector<SWCSample> ignored;
+            readChunk(chunks[chunk], path, linesBefore + 1, ignored);
+            std::rethrow_exception(errors[chunk]);
+        }
+        linesBefore += lineCounts[chunk];
+    }
+
+    size_t total = samples.size();
+    for (const auto& chunk : chunkSamples) {
+        total += chunk.size();
+    }
+    if (total > samples.capacity()) {
+        // Geometric growth, the stream may hold many more blocks
+        samples.reserve(std::max(total, 2 * samples.capacity()));
+    }
+    for (size_t chunk = 0; chunk < chunks.size(); ++chunk) {
+        for (auto& sample : chunkSamples[chunk]) {
+            sample.lineNumber += static_cast<unsigned int>(lineCount);
+        }
+        samples.insert(samples.end(), chunkSamples[chunk].begin(), chunkSamples[chunk].end());
+        std::vector<SWCSample>().swap(chunkSamples[chunk]);
+        lineCount += lineCounts[chunk];
+    }
+}
+
+static std::vector<SWCSample> readSamples(SWCInput& input, const std::string& path) {
+    std::vector<SWCSample> samples;
+    size_t lineCount = 0;
+    for (auto block = input.next(); !block.empty(); block = input.next()) {
+        readBlock(block, path, lineCount, samples);
+    }
     return samples;
 }
 
@@ -224,13 +409,15 @@ static std::vector<SWCSample> readSamples(const std::string& contents, const std
 http://www.neuronland.org/NLMorphologyConverter/MorphologyFormats/SWC/Spec.html
  **/
 
-enum class DeclaredID : unsigned int {};
-
+/* The samples are addressed by their index in the file: the declared IDs are
+ * only used to find the parents, and the children are stored in CSR form.
+ * Sections are assembled depth first, without recursion, and written straight
+ * to the Properties.
+ */
 class SWCBuilder
 {
-    using MorphioID = uint32_t;
-    using PhysicalID = size_t;
-    using Samples = std::vector<SWCSample>;
+    using SampleIndex = uint32_t;
+    enum : SampleIndex { NO_SAMPLE = 0xFFFFFFFF };
 
   public:
     SWCBuilder(std::string path, WarningHandler* warning_handler, unsigned int options)
@@ -238,110 +425,88 @@ class SWCBuilder
         , warning_handler_(warning_handler)
         , options_(options) {}
 
-    Property::Properties buildProperties(const std::string& contents) {
-        const Samples samples = readSamples(contents, path_);
-        buildSWC(samples);
-        morph_.applyModifiers(options_);
-        return morph_.buildReadOnly();
+    Property::Properties buildProperties(SWCInput& input) {
+        samples_ = readSamples(input, path_);
+        indexSamples();
+        checkSamples();
+        buildChildren();
+        build_soma();
+        buildSections();
+        return std::move(properties_);
     }
 
   private:
-    void build_soma(const Samples& soma_samples) {
-        auto& soma = morph_.soma();
-
-        if (soma_samples.empty()) {
-            soma->type() = SOMA_UNDEFINED;
-            warning_handler_->emit(std::make_unique<NoSomaFound>(path_));
-            return;
-        } else if (soma_samples.size() == 1) {
-            SWCSample sample = soma_samples[0];
+    range<const SampleIndex> childrenOf(SampleIndex sample) const noexcept {
+        return {children_.data() + childrenOffsets_[sample],
+                childrenOffsets_[sample + 1] - childrenOffsets_[sample]};
+    }
 
-            if (sample.parentId != SWC_ROOT && samples_.at(sample.parentId).type != SECTION_SOMA) {
-                details::ErrorMessages err_(path_);
-                throw SomaError(err_.ERROR_SOMA_WITH_NEURITE_PARENT(sample.lineNumber));
-            }
+    SampleIndex indexOf(unsigned int id) const noexcept {
+        if (!sortedIds_.empty()) {
+            const auto it = std::lower_bound(sortedIds_.begin(),
+                                             sortedIds_.end(),
+                                             std::make_pair(id, SampleIndex{0}));
+            return it != sortedIds_.end() && it->first == id ? it->second : NO_SAMPLE;
+        }
+        return id < idToIndex_.size() ? idToIndex_[id] : NO_SAMPLE;
+    }
 
-            soma->type() = SOMA_SINGLE_POINT;
-            soma->points() = {sample.point};
-            soma->diameters() = {sample.diameter};
-            return;
-        } else if (soma_samples.size() == 3 &&
-                   (soma_samples[0].id == 1 && soma_samples[0].parentId == SWC_ROOT &&
-                    soma_samples[1].id == 2 && soma_samples[1].parentId == 1 &&
-                    soma_samples[2].id == 3 && soma_samples[2].parentId == 1)) {
-            const std::array<Point, 3> points = {
-                soma_samples[0].point,
-                soma_samples[1].point,
-                soma_samples[2].point,
-            };
-            // All soma that bifurcate with the first parent having two children are considered
-            // SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS
-            const details::ThreePointSomaStatus status =
-                details::checkNeuroMorphoSoma(points, soma_samples[0].diameter / 2);
-            if (status != details::ThreePointSomaStatus::Conforms) {
-                std::stringstream stream;
-                stream << status;
-                warning_handler_->emit(std::make_unique<SomaNonConform>(path_, stream.str()));
-            }
-            soma->type() = SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS;
-            soma->points() = std::vector<Point>(points.begin(), points.end());
-            soma->diameters() = {
-                soma_samples[0].diameter,
-                soma_samples[1].diameter,
-                soma_samples[2].diameter,
-            };
-            return;
+    std::vector<unsigned int> gatherLineNumbers(const std::vector<SampleIndex>& samples) const {
+        std::vector<unsigned int> lineNumbers;
+        lineNumbers.reserve(samples.size());
+        for (const SampleIndex sample : samples) {
+            lineNumbers.push_back(samples_[sample].lineNumber);
         }
-        // might also have 3 points at this point, as well
+        return lineNumbers;
+    }
 
-        // a "normal" SWC soma
-        soma->type() = SOMA_CYLINDERS;
-        auto& points = soma->points();
-        auto& diameters = soma->diameters();
-        points.reserve(soma_samples.size());
-        diameters.reserve(soma_samples.size());
+    // Map the declared IDs to sample indices: a table when the IDs are dense,
+    // like in almost all files, sorted pairs otherwise. The first sample that
+    // repeats an ID is only reported by `checkSamples`, so that the errors
+    // come in the same order as the lines.
+    void indexSamples() {
+        size_t maxId = 0;
+        for (const auto& sample : samples_) {
+            maxId = std::max(maxId, static_cast<size_t>(sample.id));
+        }
 
-        size_t parent_count = 0;
-        for (const auto& s : soma_samples) {
-            if (s.parentId == SWC_ROOT) {
-                parent_count++;
-            } else if (samples_.at(s.parentId).type != SECTION_SOMA) {
-                details::ErrorMessages err_(path_);
-                throw SomaError(err_.ERROR_SOMA_WITH_NEURITE_PARENT(s.lineNumber));
+        const auto setRepeat = [this](SampleIndex repeat, SampleIndex original) {
+            if (firstRepeat_ == NO_SAMPLE || repeat < firstRepeat_) {
+                firstRepeat_ = repeat;
+                repeatedOriginal_ = original;
             }
+        };
 
-            if (children_.count(s.id) > 0 && children_.at(s.id).size() > 1) {
-                std::vector<SWCSample> soma_bifurcations;
-                for (auto id : children_.at(s.id)) {
-                    if (samples_[id].type == SECTION_SOMA && s.parentId != SWC_ROOT) {
-                        soma_bifurcations.push_back(samples_[id]);
-                    }
-                }
-                if (soma_bifurcations.size() > 1) {
-                    details::ErrorMessages err_(path_);
-                    throw SomaError(
-                        err_.ERROR_SOMA_BIFURCATION(s.lineNumber,
-                                                    gatherLineNumbers(soma_bifurcations)));
+        if (maxId <= 4 * samples_.size() + 1024) {
+            idToIndex_.assign(maxId + 1, NO_SAMPLE);
+            for (SampleIndex i = 0; i < samples_.size(); ++i) {
+                auto& index = idToIndex_[samples_[i].id];
+                if (index == NO_SAMPLE) {
+                    index = i;
+                } else {
+                    setRepeat(i, index);
                 }
             }
-            points.push_back(s.point);
-            diameters.push_back(s.diameter);
+            return;
         }
 
-        if (parent_count > 1) {
-            details::ErrorMessages err_(path_);
-            throw SomaError(err_.ERROR_MULTIPLE_SOMATA(gatherLineNumbers(soma_samples)));
+        sortedIds_.reserve(samples_.size());
+        for (SampleIndex i = 0; i < samples_.size(); ++i) {
+            sortedIds_.emplace_back(samples_[i].id, i);
+        }
+        std::sort(sortedIds_.begin(), sortedIds_.end());
+        for (size_t i = 1; i < sortedIds_.size(); ++i) {
+            if (sortedIds_[i].first == sortedIds_[i - 1].first) {
+                setRepeat(sortedIds_[i].second, sortedIds_[i - 1].second);
+            }
         }
     }
 
-    void buildSWC(const Samples& samples) {
-        Samples soma_samples;
-        Samples root_samples;
-
-        for (const auto& sample: samples) {
+    void checkSamples() {
+        for (SampleIndex i = 0; i < samples_.size(); ++i) {
+            const SWCSample& sample = samples_[i];
             // { checks
             if (sample.diameter < morphio::epsilon) {
-                details::ErrorMessages err_(path_);
                 warning_handler_->emit(std::make_unique<ZeroDiameter>(path_, sample.lineNumber));
             }
 
@@ -359,166 +524,268 @@ class SWCBuilder
                 warning_handler_->emit(
                     std::make_unique<DisconnectedNeurite>(path_, sample.lineNumber));
             }
+
+            if (i == firstRepeat_) {
+                const auto& original = samples_[repeatedOriginal_];
+                details::ErrorMessages err_(path_);
+                throw RawDataError(
+                    err_.ERROR_REPEATED_ID(original.id, original.lineNumber, sample.id));
+            }
             // } checks
 
             if (sample.type == SECTION_SOMA) {
-                soma_samples.push_back(sample);
+                soma_samples_.push_back(i);
             }
 
             if (sample.parentId == SWC_ROOT || sample.type == SECTION_SOMA) {
-                root_samples.push_back(sample);
+                root_samples_.push_back(i);
             }
-
-            if (!samples_.insert({sample.id, sample}).second) {
-                const auto& original = samples_[sample.id];
-                details::ErrorMessages err_(path_);
-                throw RawDataError(err_.ERROR_REPEATED_ID(original.id, original.lineNumber, sample.id));
-            }
-
-            children_[sample.parentId].push_back(sample.id);
         }
 
         // can only check for missing parents once all samples are loaded
         // since it's possible there may be forward references
-        for (const auto& sample: samples) {
-            if(sample.parentId != SWC_ROOT && samples_.count(sample.parentId) == 0){
+        parents_.assign(samples_.size(), NO_SAMPLE);
+        for (SampleIndex i = 0; i < samples_.size(); ++i) {
+            const SWCSample& sample = samples_[i];
+            if (sample.parentId == SWC_ROOT) {
+                continue;
+            }
+            parents_[i] = indexOf(sample.parentId);
+            if (parents_[i] == NO_SAMPLE) {
                 details::ErrorMessages err_(path_);
                 throw MissingParentError(err_.ERROR_MISSING_PARENT(
                     sample.id, static_cast<int>(sample.parentId), sample.lineNumber));
             }
         }
+    }
+
+    // Counting sort of the samples by parent: the children stay in file order
+    void buildChildren() {
+        childrenOffsets_.assign(samples_.size() + 1, 0);
+        for (const SampleIndex parent : parents_) {
+            if (parent != NO_SAMPLE) {
+                ++childrenOffsets_[parent + 1];
+            }
+        }
+        for (size_t i = 1; i < childrenOffsets_.size(); ++i) {
+            childrenOffsets_[i] += childrenOffsets_[i - 1];
+        }
+
+        children_.resize(childrenOffsets_.back());
+        std::vector<SampleIndex> next(childrenOffsets_.begin(), childrenOffsets_.end() - 1);
+        for (SampleIndex i = 0; i < samples_.size(); ++i) {
+            if (parents_[i] != NO_SAMPLE) {
+                children_[next[parents_[i]]++] = i;
+            }
+        }
+    }
+
+    void build_soma() {
+        auto& somaType = properties_._cellLevel._somaType;
+        auto& points = properties_._somaLevel._points;
+        auto& diameters = properties_._somaLevel._diameters;
 
-        build_soma(soma_samples);
+        if (soma_samples_.empty()) {
+            somaType = SOMA_UNDEFINED;
+            warning_handler_->emit(std::make_unique<NoSomaFound>(path_));
+            return;
+        } else if (soma_samples_.size() == 1) {
+            const SWCSample& sample = samples_[soma_samples_[0]];
 
-        std::unordered_map<DeclaredID, std::shared_ptr<morphio::mut::Section>> declared_to_swc;
-        declared_to_swc.reserve(samples.size());
+            if (sample.parentId != SWC_ROOT &&
+                samples_[parents_[soma_samples_[0]]].type != SECTION_SOMA) {
+                details::ErrorMessages err_(path_);
+                throw SomaError(err_.ERROR_SOMA_WITH_NEURITE_PARENT(sample.lineNumber));
+            }
 
-        for (const SWCSample& root_sample : root_samples) {
-            if (children_.count(root_sample.id) == 0) {
+            somaType = SOMA_SINGLE_POINT;
+            points = {sample.point};
+            diameters = {sample.diameter};
+            return;
+        } else if (soma_samples_.size() == 3 &&
+                   (samples_[soma_samples_[0]].id == 1 &&
+                    samples_[soma_samples_[0]].parentId == SWC_ROOT &&
+                    samples_[soma_samples_[1]].id == 2 &&
+                    samples_[soma_samples_[1]].parentId == 1 &&
+                    samples_[soma_samples_[2]].id == 3 &&
+                    samples_[soma_samples_[2]].parentId == 1)) {
+            const std::array<Point, 3> somaPoints = {
+                samples_[soma_samples_[0]].point,
+                samples_[soma_samples_[1]].point,
+                samples_[soma_samples_[2]].point,
+            };
+            // All soma that bifurcate with the first parent having two children are considered
+            // SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS
+            const details::ThreePointSomaStatus status =
+                details::checkNeuroMorphoSoma(somaPoints, samples_[soma_samples_[0]].diameter / 2);
+            if (status != details::ThreePointSomaStatus::Conforms) {
+                std::stringstream stream;
+                stream << status;
+                warning_handler_->emit(std::make_unique<SomaNonConform>(path_, stream.str()));
+            }
+            somaType = SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS;
+            points.assign(somaPoints.begin(), somaPoints.end());
+            diameters = {
+                samples_[soma_samples_[0]].diameter,
+                samples_[soma_samples_[1]].diameter,
+                samples_[soma_samples_[2]].diameter,
+            };
+            return;
+        }
+        // might also have 3 points at this point, as well
+
+        // a "normal" SWC soma
+        somaType = SOMA_CYLINDERS;
+        points.reserve(soma_samples_.size());
+        diameters.reserve(soma_samples_.size());
+
+        size_t parent_count = 0;
+        for (const SampleIndex i : soma_samples_) {
+            const SWCSample& s = samples_[i];
+            if (s.parentId == SWC_ROOT) {
+                parent_count++;
+            } else if (samples_[parents_[i]].type != SECTION_SOMA) {
+                details::ErrorMessages err_(path_);
+                throw SomaError(err_.ERROR_SOMA_WITH_NEURITE_PARENT(s.lineNumber));
+            }
+
+            const auto children = childrenOf(i);
+            if (children.size() > 1) {
+                std::vector<SampleIndex> soma_bifurcations;
+                for (const SampleIndex child : children) {
+                    if (samples_[child].type == SECTION_SOMA && s.parentId != SWC_ROOT) {
+                        soma_bifurcations.push_back(child);
+                    }
+                }
+                if (soma_bifurcations.size() > 1) {
+                    details::ErrorMessages err_(path_);
+                    throw SomaError(
+                        err_.ERROR_SOMA_BIFURCATION(s.lineNumber,
+                                                    gatherLineNumbers(soma_bifurcations)));
+                }
+            }
+            points.push_back(s.point);
+            diameters.push_back(s.diameter);
+        }
+
+        if (parent_count > 1) {
+            details::ErrorMessages err_(path_);
+            throw SomaError(err_.ERROR_MULTIPLE_SOMATA(gatherLineNumbers(soma_samples_)));
+        }
+    }
+
+    void buildSections() {
+        // Every sample is written once, plus the duplicated first points
+        properties_._pointLevel._points.reserve(samples_.size());
+        properties_._pointLevel._diameters.reserve(samples_.size());
+
+        for (const SampleIndex root : root_samples_) {
+            const auto children = childrenOf(root);
+            if (children.empty()) {
                 continue;
             }
+            const SWCSample& root_sample = samples_[root];
 
             // https://neuromorpho.org/SomaFormat.html
             // "The second and third soma points, as well as all starting points
             // (roots) of dendritic and axonal arbors have this first point as
             // the parent (parent ID 1)."
-            if (morph_.soma()->type() == SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS &&
+            if (properties_._cellLevel._somaType == SOMA_NEUROMORPHO_THREE_POINT_CYLINDERS &&
                 root_sample.type == SECTION_SOMA && root_sample.id != 1) {
                 warning_handler_->emit(std::make_unique<WrongRootPoint>(
                     path_, std::vector<unsigned int>{root_sample.lineNumber}));
             }
 
-            for (unsigned int child_id : children_.at(root_sample.id)) {
-                if (samples_.at(child_id).type == SECTION_SOMA) {
+            for (const SampleIndex child : children) {
+                if (samples_[child].type == SECTION_SOMA) {
                     continue;
                 }
                 if (root_sample.type == SECTION_SOMA) {
-                    assembleSections(child_id,
-                                     DeclaredID(root_sample.id),
-                                     declared_to_swc,
-                                     morph_.soma()->points()[0],
-                                     morph_.soma()->diameters()[0],
-                                     true);
+                    assembleSections(child);
                 } else {
                     // this is neurite as the start
-                    assembleSections(root_sample.id,
-                                     DeclaredID(SWC_ROOT),
-                                     declared_to_swc,
-                                     root_sample.point,
-                                     root_sample.diameter,
-                                     true);
+                    assembleSections(root);
                     break;
                 }
             }
         }
     }
 
-    void assembleSections(
-        unsigned int id,
-        DeclaredID parent_id,
-        std::unordered_map<DeclaredID, std::shared_ptr<morphio::mut::Section>>& declared_to_swc,
-        const Point& start_point,
-        floatType start_diameter,
-        bool is_root)
-    {
-        Property::PointLevel properties;
-        auto& points = properties._points;
-        auto& diameters = properties._diameters;
-
-        auto appendSection = [&](DeclaredID section_id_, DeclaredID parent_id_, SectionType starting_section_type) {
-            std::shared_ptr<morphio::mut::Section> new_section;
-            if (is_root) {
-                new_section = morph_.appendRootSection(properties, starting_section_type);
-            } else {
-                new_section = declared_to_swc.at(parent_id_)
-                                  ->appendSection(properties, starting_section_type);
-            }
-            declared_to_swc[section_id_] = new_section;
-        };
-
-        auto get_child_count = [&](unsigned int child_id) {
-            return children_.count(child_id) == 0 ? 0 : children_.at(child_id).size();
+    // Append the root section starting at `root` and all its descendants, depth first
+    void assembleSections(SampleIndex root) {
+        struct PendingSection {
+            SampleIndex sample;
+            int32_t parent;
+            Point start;
+            floatType startDiameter;
         };
 
-        const SWCSample* sample = &samples_.at(id);
-
-        // create duplicate point if needed
-        if (!is_root && sample->point != start_point) {
-            points.push_back(start_point);
-            diameters.push_back(start_diameter);
-        }
+        auto& points = properties_._pointLevel._points;
+        auto& diameters = properties_._pointLevel._diameters;
+        auto& sections = properties_._sectionLevel._sections;
+        auto& types = properties_._sectionLevel._sectionTypes;
+
+        std::vector<PendingSection> stack{{root, -1, Point{}, 0}};
+        while (!stack.empty()) {
+            const PendingSection pending = stack.back();
+            stack.pop_back();
+            const auto start = static_cast<int>(points.size());
+            SampleIndex id = pending.sample;
+
+            // create duplicate point if needed
+            if (pending.parent >= 0 && samples_[id].point != pending.start) {
+                points.push_back(pending.start);
+                diameters.push_back(pending.startDiameter);
+            }
 
-        // try and combine as many single samples into a single section as possible
-        size_t children_count = get_child_count(id);
-        while (children_count == 1) {
-            sample = &samples_.at(id);
-            if(sample->type != samples_.at(children_.at(id)[0]).type){
-                if (options_ & ALLOW_UNIFURCATED_SECTION_CHANGE) {
-                    warning_handler_->emit(
-                        std::make_unique<SectionTypeChanged>(path_, sample->lineNumber));
-                    break;
+            // try and combine as many single samples into a single section as possible
+            auto children = childrenOf(id);
+            while (children.size() == 1) {
+                const SWCSample& sample = samples_[id];
+                if (sample.type != samples_[children[0]].type) {
+                    if (options_ & ALLOW_UNIFURCATED_SECTION_CHANGE) {
+                        warning_handler_->emit(
+                            std::make_unique<SectionTypeChanged>(path_, sample.lineNumber));
+                        break;
+                    }
+                    throw RawDataError("Section type changed without a bifucation at line: " +
+                                       std::to_string(sample.lineNumber) +
+                                       ", consider using UNIFURCATED_SECTION_CHANGE option");
                 }
-                throw RawDataError("Section type changed without a bifucation at line: " +
-                                   std::to_string(sample->lineNumber) +
-                                   ", consider using UNIFURCATED_SECTION_CHANGE option");
+                points.push_back(sample.point);
+                diameters.push_back(sample.diameter);
+                id = children[0];
+                children = childrenOf(id);
             }
-            points.push_back(sample->point);
-            diameters.push_back(sample->diameter);
-            id = children_.at(id)[0];
-            children_count = get_child_count(id);
-        }
 
-        sample = &samples_.at(id);
-        points.push_back(sample->point);
-        diameters.push_back(sample->diameter);
-        appendSection(DeclaredID(id), parent_id, sample->type);
-
-        if (children_count == 0) {
-            // section was already appended above, nothing to do
-        } else if (children_count == 1) {
-            // section_type changed
-            size_t offset = properties._points.size() - 1;
-            const Point& new_start_point = properties._points[offset];
-            floatType new_start_diameter = properties._diameters[offset];
-            assembleSections(children_.at(id)[0], DeclaredID(id), declared_to_swc, new_start_point, new_start_diameter, false);
-        } else {
-            size_t offset = properties._points.size() - 1;
-            const Point& new_start_point = properties._points[offset];
-            floatType new_start_diameter = properties._diameters[offset];
-            for (unsigned int child_id : children_.at(id)) {
-                assembleSections(child_id,
-                                 DeclaredID(id),
-                                 declared_to_swc,
-                                 new_start_point,
-                                 new_start_diameter,
-                                 false);
+            const SWCSample& last = samples_[id];
+            points.push_back(last.point);
+            diameters.push_back(last.diameter);
+            const auto section = static_cast<int32_t>(sections.size());
+            sections.push_back({start, pending.parent});
+            types.push_back(last.type);
+
+            // pushed in reverse, so that the children are assembled in file order
+            for (auto child = children.rbegin(); child != children.rend(); ++child) {
+                stack.push_back({*child, section, last.point, last.diameter});
             }
         }
     }
 
-    std::unordered_map<unsigned int, std::vector<unsigned int>> children_;
-    std::unordered_map<unsigned int, SWCSample> samples_;
-    mut::Morphology morph_;
+    std::vector<SWCSample> samples_;
+    std::vector<SampleIndex> parents_;
+    std::vector<SampleIndex> childrenOffsets_;
+    std::vector<SampleIndex> children_;
+    std::vector<SampleIndex> soma_samples_;
+    std::vector<SampleIndex> root_samples_;
+
+    // declared ID to sample index, only one of them is used
+    std::vector<SampleIndex> idToIndex_;
+    std::vector<std::pair<unsigned int, SampleIndex>> sortedIds_;
+    SampleIndex firstRepeat_ = NO_SAMPLE;
+    SampleIndex repeatedOriginal_ = NO_SAMPLE;
+
+    Property::Properties properties_;
     std::string path_;
     WarningHandler* warning_handler_;
     unsigned int options_;
@@ -526,19 +793,61 @@ class SWCBuilder
 
 }  // namespace details
 
+void set_maximum_swc_threads(unsigned int n_threads) {
+    details::maximumThreads.store(n_threads, std::memory_order_relaxed);
+}
+
 namespace readers {
 namespace swc {
+namespace {
 Property::Properties load(const std::string& path,
-                          const std::string& contents,
+                          details::SWCInput& input,
                           unsigned int options,
                           std::shared_ptr<WarningHandler>& warning_handler) {
     auto properties =
-        details::SWCBuilder(path, warning_handler.get(), options).buildProperties(contents);
+        details::SWCBuilder(path, warning_handler.get(), options).buildProperties(input);
 
     properties._cellLevel._cellFamily = NEURON;
     properties._cellLevel._version = {"swc", 1, 0};
+
+    // The modifiers are applied through a mutable morphology, like for H5 files
+    const unsigned int modifiers = TWO_POINTS_SECTIONS | SOMA_SPHERE | NO_DUPLICATES | NRN_ORDER;
+    if (options & modifiers) {
+        const mut::Morphology morph(
+            Morphology(std::move(properties), NO_MODIFIER), options & modifiers, warning_handler);
+        properties = morph.buildReadOnly();
+    }
     return properties;
 }
+}  // namespace
+
+Property::Properties load(const std::string& path,
+                          range<const char> contents,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler>& warning_handler) {
+    details::SWCInput input(contents);
+    return load(path, input, options, warning_handler);
+}
+
+Property::Properties load(const std::string& path,
+                          const std::string& contents,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler>& warning_handler) {
+    return load(
+        path, range<const char>(contents.data(), contents.size()), options, warning_handler);
+}
+
+Property::Properties load(const std::string& path,
+                          std::istream& stream,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler>& warning_handler) {
+    details::SWCInput input(stream, path, details::STREAM_BLOCK_SIZE);
+    return load(path, input, options, warning_handler);
+}
+
+void setSerialParsing(bool serial) noexcept {
+    details::serialParsing = serial;
+}
 
 }  // namespace swc
 }  // namespace readers
@@ -5,6 +5,8 @@
 
 #pragma once
 
+#include <iosfwd>  // std::istream
+
 #include <morphio/errorMessages.h>
 #include <morphio/properties.h>
 #include <morphio/types.h>
@@ -12,10 +14,23 @@
 namespace morphio {
 namespace readers {
 namespace swc {
+/** Parse `contents`, which is borrowed for the duration of the call */
+Property::Properties load(const std::string& path,
+                          range<const char> contents,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler>& warning_handler);
 Property::Properties load(const std::string& path,
                           const std::string& contents,
                           unsigned int options,
                           std::shared_ptr<WarningHandler>& warning_handler);
+/** Parse `stream` block by block, without reading it whole into memory */
+Property::Properties load(const std::string& path,
+                          std::istream& stream,
+                          unsigned int options,
+                          std::shared_ptr<WarningHandler>& warning_handler);
+
+/** Read the files on the calling thread only, for threads loading morphologies in parallel */
+void setSerialParsing(bool serial) noexcept;
 }  // namespace swc
 }  // namespace readers
 }  // namespace morphio
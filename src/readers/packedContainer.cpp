@@ -0,0 +1,223 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include "packedContainer.h"
+
+#include <algorithm>  // std::sort, std::min
+#include <array>
+#include <cstring>  // std::memcmp, std::memcpy
+
+#include <morphio/exceptions.h>
+
+#include "morphologyBinary.h"
+
+namespace morphio {
+namespace readers {
+namespace packed {
+namespace {
+
+constexpr std::array<char, 8> MAGIC = {'M', 'O', 'R', 'P', 'H', 'P', 'A', 'K'};
+constexpr uint32_t FORMAT_VERSION = 1;
+constexpr uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+struct Header {
+    std::array<char, 8> magic;
+    uint32_t formatVersion;
+    uint32_t byteOrderMark;
+    uint32_t floatSize;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+static_assert(sizeof(Header) == 56, "the header must not contain padding");
+
+constexpr uint64_t TOC_ENTRY_SIZE = 4 * sizeof(uint64_t);
+
+/** Lexicographic comparison of `name` with `size` bytes at `data`, like `std::string::compare` */
+int compareName(const std::string& name, const char* data, uint64_t size) {
+    const auto common = std::min(uint64_t{name.size()}, size);
+    const int cmp = common == 0 ? 0 : std::memcmp(name.data(), data, common);
+    if (cmp != 0) {
+        return cmp;
+    }
+    return name.size() < size ? -1 : (name.size() > size ? 1 : 0);
+}
+
+}  // namespace
+
+Container::Container(const std::string& path)
+    : _file(path) {
+    const auto bytes = _file.bytes();
+    if (bytes.size() < sizeof(Header)) {
+        throw RawDataError("Not a packed container: " + path);
+    }
+
+    Header header{};
+    std::memcpy(&header, bytes.data(), sizeof(Header));
+    if (header.magic != MAGIC) {
+        throw RawDataError("Not a packed container: " + path);
+    }
+    if (header.formatVersion != FORMAT_VERSION || header.byteOrderMark != BYTE_ORDER_MARK ||
+        header.floatSize != sizeof(floatType)) {
+        throw RawDataError("Incompatible packed container: " + path);
+    }
+
+    const uint64_t size = bytes.size();
+    if (header.tocOffset > size || header.count > (size - header.tocOffset) / TOC_ENTRY_SIZE ||
+        header.namesOffset > size || header.namesSize > size - header.namesOffset) {
+        throw RawDataError("Truncated packed container: " + path);
+    }
+
+    _count = header.count;
+    _tocOffset = header.tocOffset;
+    _namesOffset = header.namesOffset;
+    _namesSize = header.namesSize;
+}
+
+Container::Entry Container::entry(uint64_t i) const noexcept {
+    Entry entry{};
+    std::memcpy(&entry, _file.bytes().data() + _tocOffset + i * TOC_ENTRY_SIZE, TOC_ENTRY_SIZE);
+    return entry;
+}
+
+const char* Container::name(const Entry& entry) const noexcept {
+    return _file.bytes().data() + _namesOffset + entry.nameOffset;
+}
+
+range<const char> Container::find(const std::string& name) const {
+    uint64_t first = 0;
+    uint64_t last = _count;
+    while (first < last) {
+        const uint64_t middle = first + (last - first) / 2;
+        const Entry candidate = entry(middle);
+        if (candidate.nameOffset > _namesSize ||
+            candidate.nameSize > _namesSize - candidate.nameOffset) {
+            throw RawDataError("Corrupted table of contents in packed container: " + path());
+        }
+
+        const int cmp = compareName(name, this->name(candidate), candidate.nameSize);
+        if (cmp < 0) {
+            last = middle;
+        } else if (cmp > 0) {
+            first = middle + 1;
+        } else {
+            const uint64_t size = _file.size();
+            if (candidate.offset > size || candidate.size > size - candidate.offset) {
+                throw RawDataError("Morphology '" + name + "' is truncated in: " + path());
+            }
+            return {_file.bytes().data() + candidate.offset, candidate.size};
+        }
+    }
+
+    return {};
+}
+
+uint64_t Container::offset(const range<const char>& bytes) const noexcept {
+    return static_cast<uint64_t>(bytes.data() - _file.bytes().data());
+}
+
+std::vector<std::string> Container::names() const {
+    std::vector<std::string> names;
+    names.reserve(_count);
+    for (uint64_t i = 0; i < _count; ++i) {
+        const Entry e = entry(i);
+        if (e.nameOffset > _namesSize || e.nameSize > _namesSize - e.nameOffset) {
+            throw RawDataError("Corrupted table of contents in packed container: " + path());
+        }
+        names.emplace_back(name(e), e.nameSize);
+    }
+    return names;
+}
+
+ContainerWriter::ContainerWriter(const std::string& path)
+    : _path(path)
+    , _stream(path, std::ios::binary | std::ios::trunc) {
+    if (!_stream.is_open()) {
+        throw WriterError("Could not open packed container for writing: " + path);
+    }
+
+    // The header is written by `close`, until then the file isn't recognized
+    // as a container.
+    const std::array<char, sizeof(Header)> placeholder{};
+    write(placeholder.data(), placeholder.size());
+}
+
+void ContainerWriter::write(const char* data, uint64_t size) {
+    _stream.write(data, static_cast<std::streamsize>(size));
+    _end += size;
+}
+
+void ContainerWriter::add(const std::string& name, const Property::Properties& properties) {
+    const std::array<char, binary::ARRAY_ALIGNMENT> padding{};
+    write(padding.data(), (binary::ARRAY_ALIGNMENT - _end % binary::ARRAY_ALIGNMENT) %
+                              binary::ARRAY_ALIGNMENT);
+
+    const auto bytes = binary::encode(properties);
+    _entries.push_back({name, _end, bytes.size()});
+    write(bytes.data(), bytes.size());
+
+    if (!_stream) {
+        throw WriterError("Failed to write packed container: " + _path);
+    }
+}
+
+void ContainerWriter::add(const std::string& name, const Morphology& morphology) {
+    add(name, *morphology.properties_);
+}
+
+void ContainerWriter::close() {
+    std::sort(_entries.begin(), _entries.end(), [](const Pending& a, const Pending& b) {
+        return a.name < b.name;
+    });
+
+    for (size_t i = 1; i < _entries.size(); ++i) {
+        if (_entries[i - 1].name == _entries[i].name) {
+            throw WriterError("Morphology '" + _entries[i].name +
+                              "' was added twice to: " + _path);
+        }
+    }
+
+    Header header{};
+    header.magic = MAGIC;
+    header.formatVersion = FORMAT_VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.floatSize = sizeof(floatType);
+    header.count = _entries.size();
+    header.tocOffset = _end;
+
+    uint64_t nameOffset = 0;
+    for (const auto& pending : _entries) {
+        const std::array<uint64_t, 4> entry = {
+            nameOffset, pending.name.size(), pending.offset, pending.size};
+        write(static_cast<const char*>(static_cast<const void*>(entry.data())), TOC_ENTRY_SIZE);
+        nameOffset += pending.name.size();
+    }
+
+    header.namesOffset = _end;
+    header.namesSize = nameOffset;
+    for (const auto& pending : _entries) {
+        write(pending.name.data(), pending.name.size());
+    }
+
+    _stream.seekp(0);
+    _stream.write(static_cast<const char*>(static_cast<const void*>(&header)), sizeof(Header));
+    _stream.close();
+
+    if (!_stream) {
+        throw WriterError("Failed to write packed container: " + _path);
+    }
+}
+
+bool isPackedContainer(const std::string& path) {
+    std::ifstream stream(path, std::ios::binary);
+    std::array<char, MAGIC.size()> magic{};
+    stream.read(magic.data(), magic.size());
+    return stream && magic == MAGIC;
+}
+
+}  // namespace packed
+}  // namespace readers
+}  // namespace morphio
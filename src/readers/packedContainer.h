@@ -0,0 +1,115 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#pragma once
+
+#include <cstdint>  // uint64_t
+#include <fstream>  // std::ofstream
+#include <string>
+#include <vector>
+
+#include <morphio/morphology.h>
+#include <morphio/properties.h>
+
+#include "mappedFile.h"
+
+namespace morphio {
+namespace readers {
+namespace packed {
+
+/**
+ * A single file containing many morphologies in the compact binary format
+ * (see `morphologyBinary.h`), packed back to back.
+ *
+ * The file format is binary, in native byte order:
+ *
+ *     header: magic "MORPHPAK", format version, byte order mark, sizeof(floatType),
+ *             reserved (all uint32_t), number of morphologies, offset of the table
+ *             of contents, offset and size of the names (all uint64_t)
+ *     morphologies, each aligned to `binary::ARRAY_ALIGNMENT`
+ *     table of contents: one (name offset, name size, offset, size) per
+ *                        morphology, sorted by name (all uint64_t)
+ *     names
+ *
+ * The file is mapped into memory: finding a morphology is a binary search over
+ * the table of contents and doesn't require any system call.
+ */
+class Container
+{
+  public:
+    /** Open the container at `path`; throws `RawDataError` if it's invalid */
+    explicit Container(const std::string& path);
+
+    size_t size() const noexcept {
+        return _count;
+    }
+
+    const std::string& path() const noexcept {
+        return _file.path();
+    }
+
+    /** The bytes of the morphology `name`, or an empty range if it isn't in the container */
+    range<const char> find(const std::string& name) const;
+
+    /** Offset, from the start of the file, of `bytes` which was returned by `find` */
+    uint64_t offset(const range<const char>& bytes) const noexcept;
+
+    /** The names of all morphologies, sorted */
+    std::vector<std::string> names() const;
+
+  private:
+    struct Entry {
+        uint64_t nameOffset;
+        uint64_t nameSize;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    Entry entry(uint64_t i) const noexcept;
+    const char* name(const Entry& entry) const noexcept;
+
+    MappedFile _file;
+    uint64_t _count = 0;
+    uint64_t _tocOffset = 0;
+    uint64_t _namesOffset = 0;
+    uint64_t _namesSize = 0;
+};
+
+/**
+ * Write a packed container, one morphology at a time.
+ *
+ * The container is only valid after `close()` has been called.
+ */
+class ContainerWriter
+{
+  public:
+    explicit ContainerWriter(const std::string& path);
+
+    void add(const std::string& name, const Property::Properties& properties);
+    void add(const std::string& name, const Morphology& morphology);
+
+    /** Write the table of contents; throws `WriterError` if a name was added twice */
+    void close();
+
+  private:
+    struct Pending {
+        std::string name;
+        uint64_t offset;
+        uint64_t size;
+    };
+
+    void write(const char* data, uint64_t size);
+
+    std::string _path;
+    std::ofstream _stream;
+    uint64_t _end = 0;
+    std::vector<Pending> _entries;
+};
+
+/** Does the file at `path` start like a packed container? */
+bool isPackedContainer(const std::string& path);
+
+}  // namespace packed
+}  // namespace readers
+}  // namespace morphio
@@ -1,5 +1,13 @@
 #include "./utils.h"
 
+#include <algorithm>  // std::find_if
+#include <cfloat>     // FLT_EVAL_METHOD, FLT_MAX, FLT_MIN
+#include <cmath>      // std::fabs
+#include <cstdint>    // uint64_t
+#include <cstring>    // std::memcpy
+#include <limits>     // std::numeric_limits
+#include <stdexcept>  // std::invalid_argument
+
 namespace morphio {
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
 #define freelocale _free_locale
@@ -71,6 +79,161 @@ StringToNumber& getStringToNumber() {
     return stn;
 }
 
+namespace {
+
+bool isDigit(char c) noexcept {
+    return c >= '0' && c <= '9';
+}
+
+// Rare numbers (long mantissas, large exponents, nan, inf...) go through strtof
+std::tuple<floatType, size_t> parseFloatWithLocale(range<const char> chars) {
+    // strtof needs a null terminated string
+    const auto end = std::find_if(chars.begin(), chars.end(), [](char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    });
+    const std::string token(chars.begin(), end);
+    try {
+        return getStringToNumber().toFloat(token, 0);
+    } catch (const std::invalid_argument&) {
+        return std::tuple<floatType, size_t>{0, 0};
+    }
+}
+
+#ifndef MORPHIO_USE_DOUBLE
+// `value` is an exactly rounded double: it rounds to the exactly rounded float
+// unless it lies halfway between two floats, where rounding twice may go the
+// wrong way
+bool roundsToNearestFloat(double value) noexcept {
+    const double magnitude = std::fabs(value);
+    if (magnitude == 0) {
+        return true;
+    }
+    if (magnitude < FLT_MIN || magnitude > FLT_MAX) {
+        return false;
+    }
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    // the 29 low bits of the double significand are dropped by the conversion
+    const uint64_t dropped = bits & ((uint64_t{1} << 29) - 1);
+    return dropped != (uint64_t{1} << 28);
+}
+#endif
+
+}  // namespace
+
+std::tuple<int64_t, size_t> parseInt(range<const char> chars) noexcept {
+    const char* const begin = chars.data();
+    const char* const end = begin + chars.size();
+    const char* pos = begin;
+
+    const bool negative = pos != end && *pos == '-';
+    if (pos != end && (*pos == '-' || *pos == '+')) {
+        ++pos;
+    }
+
+    const char* const digits = pos;
+    const uint64_t limit = negative
+                               ? uint64_t{1} + std::numeric_limits<int64_t>::max()
+                               : static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+    uint64_t value = 0;
+    for (; pos != end && isDigit(*pos); ++pos) {
+        const auto digit = static_cast<uint64_t>(*pos - '0');
+        // clamped like strtol
+        value = value > (limit - digit) / 10 ? limit : value * 10 + digit;
+    }
+    if (pos == digits) {
+        return std::tuple<int64_t, size_t>{0, 0};
+    }
+
+    int64_t result = 0;
+    if (!negative) {
+        result = static_cast<int64_t>(value);
+    } else if (value == limit) {
+        result = std::numeric_limits<int64_t>::min();
+    } else {
+        result = -static_cast<int64_t>(value);
+    }
+    return std::tuple<int64_t, size_t>{result, static_cast<size_t>(pos - begin)};
+}
+
+std::tuple<floatType, size_t> parseFloat(range<const char> chars) {
+    // Powers of ten that are exact doubles
+    static constexpr double powers[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+                                        1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+                                        1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+    constexpr int maxExponent = 22;
+    constexpr int maxDigits = 19;  // fit in an uint64_t
+
+    const char* const begin = chars.data();
+    const char* const end = begin + chars.size();
+    const char* pos = begin;
+
+    const bool negative = pos != end && *pos == '-';
+    if (pos != end && (*pos == '-' || *pos == '+')) {
+        ++pos;
+    }
+
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    bool hasDigits = false;
+    const auto accumulate = [&](char c) {
+        hasDigits = true;
+        if (mantissa != 0 || c != '0') {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(c - '0');
+            ++digits;
+        }
+    };
+    for (; pos != end && isDigit(*pos) && digits < maxDigits; ++pos) {
+        accumulate(*pos);
+    }
+    if (pos != end && *pos == '.') {
+        ++pos;
+        for (; pos != end && isDigit(*pos) && digits < maxDigits; ++pos) {
+            accumulate(*pos);
+            --exponent;
+        }
+    }
+    if (!hasDigits || digits == maxDigits) {
+        return parseFloatWithLocale(chars);
+    }
+
+    // The exponent is only read if it has digits, like strtof does
+    if (pos != end && (*pos == 'e' || *pos == 'E')) {
+        const char* next = pos + 1;
+        const bool negativeExponent = next != end && *next == '-';
+        if (next != end && (*next == '-' || *next == '+')) {
+            ++next;
+        }
+        int value = 0;
+        const char* const exponentDigits = next;
+        for (; next != end && isDigit(*next); ++next) {
+            value = std::min(value * 10 + (*next - '0'), 100000);
+        }
+        if (next != exponentDigits) {
+            exponent += negativeExponent ? -value : value;
+            pos = next;
+        }
+    }
+
+    // Clinger's fast path: both the mantissa and the power of ten are exact
+    // doubles, so the division or product is exactly rounded
+    if (FLT_EVAL_METHOD != 0 || mantissa > (uint64_t{1} << 53) || exponent < -maxExponent ||
+        exponent > maxExponent) {
+        return parseFloatWithLocale(chars);
+    }
+    double value = static_cast<double>(mantissa);
+    value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+    value = negative ? -value : value;
+#ifndef MORPHIO_USE_DOUBLE
+    if (!roundsToNearestFloat(value)) {
+        return parseFloatWithLocale(chars);
+    }
+#endif
+    return std::tuple<floatType, size_t>{static_cast<floatType>(value),
+                                         static_cast<size_t>(pos - begin)};
+}
+
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
 #undef freelocale
 #undef strtol_l
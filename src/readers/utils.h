@@ -1,8 +1,9 @@
 #pragma once
 #include <clocale>  // locale_t
 #include <string>
-#include <utility> // std::tuple
+#include <tuple>    // std::tuple
 
+#include <morphio/types.h>         // range
 #include <morphio/vector_types.h>  // floatType
 
 namespace morphio {
@@ -23,4 +24,17 @@ struct StringToNumber {
 
 StringToNumber& getStringToNumber();
 
+/**
+ * Locale independent parsing of the number at the start of `chars`, which
+ * needn't be null terminated
+ *
+ * Same syntax as `strtol` and `strtof` without leading whitespace: return the
+ * value and the number of characters read, 0 if `chars` doesn't start with a
+ * number. Integers that overflow are clamped. Floats are exactly rounded:
+ * the common short decimals are converted directly, the others go through
+ * `StringToNumber`.
+ */
+std::tuple<int64_t, size_t> parseInt(range<const char> chars) noexcept;
+std::tuple<floatType, size_t> parseFloat(range<const char> chars);
+
 }  // namespace morphio
@@ -2,7 +2,10 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
-#include <algorithm>  // any_of
+#include <algorithm>  // any_of, std::equal
+#include <iterator>   // std::next
+#include <memory>     // std::make_shared
+#include <new>        // placement new
 
 #include <morphio/section.h>
 
@@ -23,6 +26,117 @@ bool Section::hasSameShape(const Section& other) const noexcept {
             other.points() == points() && other.perimeters() == perimeters());
 }
 
+floatType Section::length() const {
+    return properties_->sectionAggregates()._lengths[id_];
+}
+
+floatType Section::area() const {
+    return properties_->sectionAggregates()._areas[id_];
+}
+
+floatType Section::volume() const {
+    return properties_->sectionAggregates()._volumes[id_];
+}
+
+std::array<Point, 2> Section::boundingBox() const {
+    return properties_->sectionAggregates()._boundingBoxes[id_];
+}
+
+SectionOrderIterator::SectionOrderIterator() noexcept
+    : unused_(0) {}
+
+SectionOrderIterator::SectionOrderIterator(const Morphology& morphology, SectionOrder order)
+    : properties_(morphology.properties_)
+    , unused_(0) {
+    if (order == SectionOrder::DEPTH_FIRST || order == SectionOrder::BREADTH_FIRST) {
+        // Share the cached order instead of copying it
+        auto topology = properties_->sharedSectionTopology();
+        const auto* ids = order == SectionOrder::DEPTH_FIRST ? &topology->_depthFirst
+                                                             : &topology->_breadthFirst;
+        order_ = std::shared_ptr<const std::vector<uint32_t>>(std::move(topology), ids);
+    } else {
+        order_ = std::make_shared<const std::vector<uint32_t>>(morphology.sectionOrder(order));
+    }
+}
+
+SectionOrderIterator::SectionOrderIterator(const Section& section, SectionOrder order)
+    : properties_(section.properties_)
+    , unused_(0) {
+    const uint32_t start = section.id();
+    const range<const uint32_t> starts(&start, 1);
+    const auto& children = properties_->children<Property::Section>();
+
+    auto ids = std::make_shared<std::vector<uint32_t>>();
+    if (order == SectionOrder::BREADTH_FIRST) {
+        children.breadthFirst(starts, *ids);
+    } else {
+        children.depthFirst(starts, *ids);
+    }
+    order_ = std::move(ids);
+}
+
+SectionOrderIterator::SectionOrderIterator(const SectionOrderIterator& other)
+    : order_(other.order_)
+    , position_(other.position_)
+    , properties_(other.properties_)
+    , unused_(0) {}
+
+SectionOrderIterator& SectionOrderIterator::operator=(const SectionOrderIterator& other) {
+    if (&other != this) {
+        resetCurrent();
+        order_ = other.order_;
+        position_ = other.position_;
+        properties_ = other.properties_;
+    }
+    return *this;
+}
+
+SectionOrderIterator::~SectionOrderIterator() {
+    resetCurrent();
+}
+
+void SectionOrderIterator::resetCurrent() const noexcept {
+    if (hasCurrent_) {
+        current_.~Section();
+        hasCurrent_ = false;
+    }
+}
+
+Section SectionOrderIterator::operator*() const {
+    return Section((*order_)[position_], properties_);
+}
+
+Section const* SectionOrderIterator::operator->() const {
+    if (!hasCurrent_) {
+        new (&current_) Section((*order_)[position_], properties_);
+        hasCurrent_ = true;
+    }
+    return &current_;
+}
+
+void SectionOrderIterator::increment() {
+    if (atEnd()) {
+        throw MorphioError("Can't iterate past the end");
+    }
+    resetCurrent();
+    ++position_;
+}
+
+bool SectionOrderIterator::operator==(const SectionOrderIterator& other) const {
+    if (atEnd() || other.atEnd()) {
+        return atEnd() == other.atEnd();
+    }
+    return properties_ == other.properties_ &&
+           std::equal(std::next(order_->begin(), static_cast<std::ptrdiff_t>(position_)),
+                      order_->end(),
+                      std::next(other.order_->begin(), static_cast<std::ptrdiff_t>(other.position_)),
+                      other.order_->end());
+}
+
+bool SectionOrderIterator::operator!=(const SectionOrderIterator& other) const {
+    return !(*this == other);
+}
+
 }  // namespace morphio
 
 std::ostream& operator<<(std::ostream& os, const morphio::Section& section) {
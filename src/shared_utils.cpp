@@ -70,6 +70,25 @@ bool is_regular_file(const std::string& path) {
            ghc::filesystem::is_regular_file(ghc::filesystem::canonical(path));
 }
 
+uint64_t file_size(const std::string& path) {
+    return ghc::filesystem::file_size(path);
+}
+
+int64_t file_modification_time(const std::string& path) {
+    const int64_t ticks = ghc::filesystem::last_write_time(path).time_since_epoch().count();
+    return ticks;
+}
+
+std::vector<std::string> list_regular_files(const std::string& path) {
+    std::vector<std::string> filenames;
+    for (const auto& entry : ghc::filesystem::directory_iterator(path)) {
+        if (entry.is_regular_file()) {
+            filenames.push_back(entry.path().filename().string());
+        }
+    }
+    return filenames;
+}
+
 std::string join_path(const std::string& dirname, const std::string& filename) {
     return (ghc::filesystem::path(dirname) / filename).string();
 }
@@ -21,7 +21,7 @@ void _appendVector(std::vector<T>& to, const std::vector<T>& from, int offset) {
 }
 
 template <typename T>
-std::vector<typename T::Type> copySpan(const std::vector<typename T::Type>& data,
+std::vector<typename T::Type> copySpan(range<const typename T::Type> data,
                                        SectionRange range) {
     if (data.empty()) {
         return {};
@@ -45,6 +45,23 @@ bool is_directory(const std::string& path);
  */
 bool is_regular_file(const std::string& path);
 
+/**
+ * Size of the file at `path`, in bytes.
+ */
+uint64_t file_size(const std::string& path);
+
+/**
+ * Time of the last modification of the file at `path`.
+ *
+ * The unit is unspecified; it's only meant to detect changes.
+ */
+int64_t file_modification_time(const std::string& path);
+
+/**
+ * Names of the regular files in the directory `path`, in unspecified order.
+ */
+std::vector<std::string> list_regular_files(const std::string& path);
+
 /**
  * Join `dirname` and `filename` into one path.
  *
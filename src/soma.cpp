@@ -15,7 +15,7 @@ Soma::Soma(const std::shared_ptr<Property::Properties>& properties)
     : properties_(properties) {}
 
 Point Soma::center() const {
-    return centerOfGravity(properties_->_somaLevel._points);
+    return centerOfGravity(points());
 }
 
 floatType Soma::volume() const {
@@ -39,7 +39,7 @@ floatType Soma::surface() const {
 }
 
 floatType Soma::maxDistance() const {
-    return maxDistanceToCenterOfGravity(properties_->_somaLevel._points);
+    return maxDistanceToCenterOfGravity(points());
 }
 
 }  // namespace morphio
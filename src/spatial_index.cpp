@@ -0,0 +1,662 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>   // std::min, std::max, std::nth_element, std::sort
+#include <atomic>      // std::atomic
+#include <cmath>       // std::abs, std::sqrt
+#include <functional>  // std::greater
+#include <limits>      // std::numeric_limits
+#include <queue>       // std::priority_queue
+#include <stdexcept>   // std::invalid_argument
+#include <string>      // std::to_string
+#include <thread>      // std::thread
+#include <tuple>       // std::tie
+#include <utility>     // std::pair, std::swap
+
+#include <morphio/collection.h>
+#include <morphio/spatial_index.h>
+
+namespace morphio {
+
+namespace {
+
+using Box = std::array<Point, 2>;
+
+constexpr uint32_t maxLeafSize = 4;
+
+floatType dot(const Point& a, const Point& b) {
+    return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+Point difference(const Point& a, const Point& b) {
+    return {a[0] - b[0], a[1] - b[1], a[2] - b[2]};
+}
+
+Point along(const Point& start, const Point& direction, floatType t) {
+    return {start[0] + t * direction[0],
+            start[1] + t * direction[1],
+            start[2] + t * direction[2]};
+}
+
+floatType distance(const Point& a, const Point& b) {
+    const auto d = difference(a, b);
+    return std::sqrt(dot(d, d));
+}
+
+floatType clamp(floatType value, floatType low, floatType high) {
+    return std::min(std::max(value, low), high);
+}
+
+Box emptyBox() {
+    const auto inf = std::numeric_limits<floatType>::infinity();
+    return {Point{inf, inf, inf}, Point{-inf, -inf, -inf}};
+}
+
+void grow(Box& box, const Box& other) {
+    for (size_t axis = 0; axis < 3; ++axis) {
+        box[0][axis] = std::min(box[0][axis], other[0][axis]);
+        box[1][axis] = std::max(box[1][axis], other[1][axis]);
+    }
+}
+
+Box boxOf(const SpatialIndex::Capsule& capsule) {
+    const floatType r = std::max(capsule.startRadius, capsule.endRadius);
+    Box box;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        box[0][axis] = std::min(capsule.start[axis], capsule.end[axis]) - r;
+        box[1][axis] = std::max(capsule.start[axis], capsule.end[axis]) + r;
+    }
+    return box;
+}
+
+floatType boxDistance(const Box& box, const Point& point) {
+    floatType squared = 0;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        const floatType d = std::max(
+            {box[0][axis] - point[axis], floatType{0}, point[axis] - box[1][axis]});
+        squared += d * d;
+    }
+    return std::sqrt(squared);
+}
+
+bool overlaps(const Box& a, const Box& b) {
+    for (size_t axis = 0; axis < 3; ++axis) {
+        if (a[1][axis] < b[0][axis] || b[1][axis] < a[0][axis]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Clip the segment `start + t * direction`, `t` in [`tmin`, `tmax`], by `box`
+ *
+ * Return false if it does not intersect the box.
+ */
+bool clip(const Box& box,
+          const Point& start,
+          const Point& direction,
+          floatType& tmin,
+          floatType& tmax) {
+    for (size_t axis = 0; axis < 3; ++axis) {
+        if (direction[axis] == 0) {
+            if (start[axis] < box[0][axis] || start[axis] > box[1][axis]) {
+                return false;
+            }
+            continue;
+        }
+        floatType t0 = (box[0][axis] - start[axis]) / direction[axis];
+        floatType t1 = (box[1][axis] - start[axis]) / direction[axis];
+        if (t0 > t1) {
+            std::swap(t0, t1);
+        }
+        tmin = std::max(tmin, t0);
+        tmax = std::min(tmax, t1);
+        if (tmin > tmax) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/** The parameter along the axis of `capsule` of the point closest to `point` */
+floatType closestOnAxis(const SpatialIndex::Capsule& capsule, const Point& point) {
+    const auto axis = difference(capsule.end, capsule.start);
+    const floatType squaredLength = dot(axis, axis);
+    if (squaredLength == 0) {
+        return 0;
+    }
+    return clamp(dot(difference(point, capsule.start), axis) / squaredLength, 0, 1);
+}
+
+floatType radiusAt(const SpatialIndex::Capsule& capsule, floatType t) {
+    return capsule.startRadius + t * (capsule.endRadius - capsule.startRadius);
+}
+
+SegmentLocation locate(const SpatialIndex::Capsule& capsule, const Point& point) {
+    const floatType t = closestOnAxis(capsule, point);
+    const auto axis = difference(capsule.end, capsule.start);
+    const floatType toAxis = distance(point, along(capsule.start, axis, t));
+    return {capsule.sectionId,
+            capsule.segmentId,
+            t * std::sqrt(dot(axis, axis)),
+            std::max(floatType{0}, toAxis - radiusAt(capsule, t))};
+}
+
+/**
+ * The parameters of the closest points between the segments `p0 + s * d0` and
+ * `p1 + t * d1`, `s` and `t` in [0, 1]
+ *
+ * From "Real-Time Collision Detection", C. Ericson, 5.1.9
+ */
+std::pair<floatType, floatType> closestBetween(const Point& p0,
+                                               const Point& d0,
+                                               const Point& p1,
+                                               const Point& d1) {
+    const auto r = difference(p0, p1);
+    const floatType a = dot(d0, d0);
+    const floatType e = dot(d1, d1);
+    const floatType f = dot(d1, r);
+
+    if (a == 0 && e == 0) {
+        return {0, 0};
+    }
+    if (a == 0) {
+        return {0, clamp(f / e, 0, 1)};
+    }
+
+    const floatType c = dot(d0, r);
+    if (e == 0) {
+        return {clamp(-c / a, 0, 1), 0};
+    }
+
+    const floatType b = dot(d0, d1);
+    const floatType denominator = a * e - b * b;
+    floatType s = denominator != 0 ? clamp((b * f - c * e) / denominator, 0, 1) : 0;
+    floatType t = (b * s + f) / e;
+    if (t < 0) {
+        t = 0;
+        s = clamp(-c / a, 0, 1);
+    } else if (t > 1) {
+        t = 1;
+        s = clamp((b - c) / a, 0, 1);
+    }
+    return {s, t};
+}
+
+std::vector<SpatialIndex::Capsule> capsulesOf(range<const Point> points,
+                                              range<const floatType> diameters,
+                                              range<const Property::Section::Type> sections) {
+    std::vector<SpatialIndex::Capsule> capsules;
+    capsules.reserve(points.size());
+    for (size_t s = 0; s < sections.size(); ++s) {
+        const auto begin = static_cast<size_t>(sections[s][0]);
+        const size_t end = s + 1 < sections.size() ? static_cast<size_t>(sections[s + 1][0])
+                                                   : points.size();
+        for (size_t i = begin; i + 1 < end; ++i) {
+            capsules.push_back({points[i],
+                                points[i + 1],
+                                diameters[i] / 2,
+                                diameters[i + 1] / 2,
+                                static_cast<uint32_t>(s),
+                                static_cast<uint32_t>(i - begin)});
+        }
+    }
+    return capsules;
+}
+
+std::vector<SpatialIndex::Capsule> capsulesOf(const Collection& collection,
+                                              const std::vector<std::string>& morphology_names,
+                                              const std::vector<AffineTransform>& transforms,
+                                              unsigned int options,
+                                              size_t n_threads) {
+    if (!transforms.empty() && transforms.size() != morphology_names.size()) {
+        throw std::invalid_argument("Expected one transform per morphology, got " +
+                                    std::to_string(transforms.size()) + " for " +
+                                    std::to_string(morphology_names.size()) + " morphologies.");
+    }
+
+    // Only the segments are kept; each morphology is released as soon as it's indexed
+    std::vector<SpatialIndex::Capsule> capsules;
+    for (const auto& loaded :
+         collection.load_parallel<Morphology>(morphology_names, options, n_threads)) {
+        const auto cellId = static_cast<uint32_t>(loaded.first);
+        const auto points = loaded.second.points();
+        const auto diameters = loaded.second.diameters();
+        const auto offsets = loaded.second.sectionOffsets();
+        for (size_t s = 0; s + 1 < offsets.size(); ++s) {
+            for (size_t i = offsets[s]; i + 1 < offsets[s + 1]; ++i) {
+                SpatialIndex::Capsule capsule{points[i],
+                                              points[i + 1],
+                                              diameters[i] / 2,
+                                              diameters[i + 1] / 2,
+                                              static_cast<uint32_t>(s),
+                                              static_cast<uint32_t>(i - offsets[s]),
+                                              cellId};
+                if (!transforms.empty()) {
+                    capsule.start = transformed(capsule.start, transforms[loaded.first]);
+                    capsule.end = transformed(capsule.end, transforms[loaded.first]);
+                }
+                capsules.push_back(capsule);
+            }
+        }
+    }
+    return capsules;
+}
+
+struct Gap {
+    floatType s;  //!< Parameter along the axis of the first capsule
+    floatType t;  //!< Parameter along the axis of the second capsule
+    floatType distance;
+};
+
+/**
+ * The smallest distance between the surfaces of two capsules
+ *
+ * It's measured between the closest points of the axes, and from the ends of
+ * each axis to the other one, which covers tapered segments lying side by side.
+ */
+Gap gapBetween(const SpatialIndex::Capsule& a, const SpatialIndex::Capsule& b) {
+    const auto axisA = difference(a.end, a.start);
+    const auto axisB = difference(b.end, b.start);
+    const auto closest = closestBetween(a.start, axisA, b.start, axisB);
+    const std::array<std::pair<floatType, floatType>, 5> candidates{
+        closest,
+        std::make_pair(floatType{0}, closestOnAxis(b, a.start)),
+        std::make_pair(floatType{1}, closestOnAxis(b, a.end)),
+        std::make_pair(closestOnAxis(a, b.start), floatType{0}),
+        std::make_pair(closestOnAxis(a, b.end), floatType{1})};
+
+    Gap best{0, 0, std::numeric_limits<floatType>::infinity()};
+    for (const auto& params : candidates) {
+        const floatType gap = distance(along(a.start, axisA, params.first),
+                                       along(b.start, axisB, params.second)) -
+                              radiusAt(a, params.first) - radiusAt(b, params.second);
+        if (gap < best.distance) {
+            best = {params.first, params.second, gap};
+        }
+    }
+    best.distance = std::max(best.distance, floatType{0});
+    return best;
+}
+
+size_t threadCount(size_t n_threads) {
+    return n_threads != 0 ? n_threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+bool closerFirst(const SegmentLocation& a, const SegmentLocation& b) {
+    if (a.distance != b.distance) {
+        return a.distance < b.distance;
+    }
+    return a.sectionId != b.sectionId ? a.sectionId < b.sectionId : a.segmentId < b.segmentId;
+}
+
+}  // namespace
+
+SpatialIndex::SpatialIndex(range<const Point> points,
+                           range<const floatType> diameters,
+                           range<const Property::Section::Type> sections)
+    : SpatialIndex(capsulesOf(points, diameters, sections)) {}
+
+SpatialIndex::SpatialIndex(std::vector<Capsule> capsules)
+    : _capsules(std::move(capsules)) {
+    if (!_capsules.empty()) {
+        _nodes.reserve(2 * _capsules.size() / maxLeafSize + 1);
+        build(0, static_cast<uint32_t>(_capsules.size()));
+    }
+}
+
+uint32_t SpatialIndex::build(uint32_t begin, uint32_t end) {
+    const auto index = static_cast<uint32_t>(_nodes.size());
+    _nodes.push_back({emptyBox(), begin, end, 0});
+
+    Box centers = emptyBox();
+    for (uint32_t i = begin; i < end; ++i) {
+        grow(_nodes[index].box, boxOf(_capsules[i]));
+        const Point center = along(_capsules[i].start,
+                                   difference(_capsules[i].end, _capsules[i].start),
+                                   floatType{0.5});
+        grow(centers, {center, center});
+    }
+    if (end - begin <= maxLeafSize) {
+        return index;
+    }
+
+    // Median split along the axis where the segment centers spread the most
+    size_t axis = 0;
+    for (size_t i = 1; i < 3; ++i) {
+        if (centers[1][i] - centers[0][i] > centers[1][axis] - centers[0][axis]) {
+            axis = i;
+        }
+    }
+    const uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(_capsules.begin() + begin,
+                     _capsules.begin() + middle,
+                     _capsules.begin() + end,
+                     [axis](const Capsule& a, const Capsule& b) {
+                         return a.start[axis] + a.end[axis] < b.start[axis] + b.end[axis];
+                     });
+
+    build(begin, middle);
+    const uint32_t right = build(middle, end);
+    _nodes[index].right = right;
+    return index;
+}
+
+std::vector<SegmentLocation> SpatialIndex::nearest(const Point& point, size_t k) const {
+    std::vector<SegmentLocation> best;  // max-heap on the distance, of at most k locations
+    if (k == 0 || _nodes.empty()) {
+        return best;
+    }
+
+    using Candidate = std::pair<floatType, uint32_t>;  // (distance to the box, node)
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> queue;
+    queue.emplace(boxDistance(_nodes[0].box, point), 0);
+
+    while (!queue.empty()) {
+        const Candidate candidate = queue.top();
+        queue.pop();
+        if (best.size() == k && candidate.first > best.front().distance) {
+            break;
+        }
+
+        const Node& node = _nodes[candidate.second];
+        if (node.right != 0) {
+            const uint32_t left = candidate.second + 1;
+            queue.emplace(boxDistance(_nodes[left].box, point), left);
+            queue.emplace(boxDistance(_nodes[node.right].box, point), node.right);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const auto location = locate(_capsules[i], point);
+            if (best.size() < k) {
+                best.push_back(location);
+                std::push_heap(best.begin(), best.end(), closerFirst);
+            } else if (closerFirst(location, best.front())) {
+                std::pop_heap(best.begin(), best.end(), closerFirst);
+                best.back() = location;
+                std::push_heap(best.begin(), best.end(), closerFirst);
+            }
+        }
+    }
+
+    std::sort_heap(best.begin(), best.end(), closerFirst);
+    return best;
+}
+
+std::vector<SegmentLocation> SpatialIndex::within(const Point& point, floatType radius) const {
+    std::vector<SegmentLocation> found;
+    std::vector<uint32_t> stack;
+    if (!_nodes.empty()) {
+        stack.push_back(0);
+    }
+
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        if (boxDistance(node.box, point) > radius) {
+            continue;
+        }
+        if (node.right != 0) {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const auto location = locate(_capsules[i], point);
+            if (location.distance <= radius) {
+                found.push_back(location);
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end(), closerFirst);
+    return found;
+}
+
+bool SpatialIndex::contains(const Point& point) const {
+    std::vector<uint32_t> stack;
+    if (!_nodes.empty()) {
+        stack.push_back(0);
+    }
+
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        if (boxDistance(node.box, point) > 0) {
+            continue;
+        }
+        if (node.right != 0) {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            if (locate(_capsules[i], point).distance == 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+std::vector<SegmentLocation> SpatialIndex::intersecting(const std::array<Point, 2>& box) const {
+    std::vector<SegmentLocation> found;
+    std::vector<uint32_t> stack;
+    if (!_nodes.empty()) {
+        stack.push_back(0);
+    }
+
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        if (!overlaps(node.box, box)) {
+            continue;
+        }
+        if (node.right != 0) {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const Capsule& capsule = _capsules[i];
+            const floatType r = std::max(capsule.startRadius, capsule.endRadius);
+            const Box grown{Point{box[0][0] - r, box[0][1] - r, box[0][2] - r},
+                            Point{box[1][0] + r, box[1][1] + r, box[1][2] + r}};
+            const auto axis = difference(capsule.end, capsule.start);
+            floatType tmin = 0;
+            floatType tmax = 1;
+            if (clip(grown, capsule.start, axis, tmin, tmax)) {
+                found.push_back(
+                    {capsule.sectionId, capsule.segmentId, tmin * std::sqrt(dot(axis, axis)), 0});
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end(), closerFirst);
+    return found;
+}
+
+std::vector<SegmentLocation> SpatialIndex::raycast(const Point& origin,
+                                                   const Point& direction,
+                                                   floatType maxDistance) const {
+    std::vector<SegmentLocation> found;
+    const floatType norm = std::sqrt(dot(direction, direction));
+    if (norm == 0 || _nodes.empty()) {
+        return found;
+    }
+
+    // Nothing is hit past the farthest corner of the index: stopping there
+    // keeps the ray finite when `maxDistance` is infinite
+    const Box& bounds = _nodes[0].box;
+    floatType farthest = 0;
+    for (size_t axis = 0; axis < 3; ++axis) {
+        const floatType extent = std::max(std::abs(origin[axis] - bounds[0][axis]),
+                                          std::abs(bounds[1][axis] - origin[axis]));
+        farthest += extent * extent;
+    }
+    const floatType length = std::min(maxDistance, std::sqrt(farthest) + 1);
+
+    // The ray as a segment, parameterized in [0, 1]
+    const Point ray{direction[0] / norm * length,
+                    direction[1] / norm * length,
+                    direction[2] / norm * length};
+
+    std::vector<uint32_t> stack{0};
+    while (!stack.empty()) {
+        const uint32_t index = stack.back();
+        stack.pop_back();
+        const Node& node = _nodes[index];
+        floatType tmin = 0;
+        floatType tmax = 1;
+        if (!clip(node.box, origin, ray, tmin, tmax)) {
+            continue;
+        }
+        if (node.right != 0) {
+            stack.push_back(node.right);
+            stack.push_back(index + 1);
+            continue;
+        }
+
+        for (uint32_t i = node.begin; i < node.end; ++i) {
+            const Capsule& capsule = _capsules[i];
+            const auto axis = difference(capsule.end, capsule.start);
+            const auto params = closestBetween(capsule.start, axis, origin, ray);
+            const floatType gap = distance(along(capsule.start, axis, params.first),
+                                           along(origin, ray, params.second));
+            if (gap <= radiusAt(capsule, params.first)) {
+                found.push_back({capsule.sectionId,
+                                 capsule.segmentId,
+                                 params.first * std::sqrt(dot(axis, axis)),
+                                 params.second * length});
+            }
+        }
+    }
+
+    std::sort(found.begin(), found.end(), closerFirst);
+    return found;
+}
+
+CollectionSpatialIndex::CollectionSpatialIndex(const Collection& collection,
+                                               const std::vector<std::string>& morphology_names,
+                                               const std::vector<AffineTransform>& transforms,
+                                               unsigned int options,
+                                               size_t n_threads)
+    : _index(capsulesOf(
+          collection, morphology_names, transforms, options, n_threads)) {}
+
+CollectionSpatialIndex::CollectionSpatialIndex(std::vector<SpatialIndex::Capsule> capsules)
+    : _index(std::move(capsules)) {}
+
+std::vector<Apposition> CollectionSpatialIndex::appositions(floatType distance,
+                                                            size_t n_threads) const {
+    using Capsule = SpatialIndex::Capsule;
+    const auto& capsules = _index._capsules;
+    const auto& nodes = _index._nodes;
+
+    // Each segment is matched against the ones after it in the index, which
+    // are spatially sorted; blocks of segments are handed out to the threads
+    constexpr size_t blockSize = 256;
+    std::atomic<size_t> nextBlock{0};
+    std::vector<std::vector<Apposition>> found(threadCount(n_threads));
+
+    const auto search = [&](std::vector<Apposition>& pairs) {
+        std::vector<uint32_t> stack;
+        for (size_t block = nextBlock++; block * blockSize < capsules.size();
+             block = nextBlock++) {
+            const size_t end = std::min(capsules.size(), (block + 1) * blockSize);
+            for (size_t i = block * blockSize; i < end; ++i) {
+                const Capsule& a = capsules[i];
+                Box query = boxOf(a);
+                for (size_t axis = 0; axis < 3; ++axis) {
+                    query[0][axis] -= distance;
+                    query[1][axis] += distance;
+                }
+
+                stack.assign(1, 0);
+                while (!stack.empty()) {
+                    const uint32_t index = stack.back();
+                    stack.pop_back();
+                    const auto& node = nodes[index];
+                    if (node.end <= i + 1 || !overlaps(node.box, query)) {
+                        continue;
+                    }
+                    if (node.right != 0) {
+                        stack.push_back(node.right);
+                        stack.push_back(index + 1);
+                        continue;
+                    }
+
+                    for (uint32_t j = std::max(node.begin, static_cast<uint32_t>(i + 1));
+                         j < node.end;
+                         ++j) {
+                        const Capsule& b = capsules[j];
+                        if (a.cellId == b.cellId) {
+                            continue;
+                        }
+                        const auto gap = gapBetween(a, b);
+                        if (gap.distance > distance) {
+                            continue;
+                        }
+
+                        const auto axisA = difference(a.end, a.start);
+                        const auto axisB = difference(b.end, b.start);
+                        const SegmentLocation onA{a.sectionId,
+                                                  a.segmentId,
+                                                  gap.s * std::sqrt(dot(axisA, axisA)),
+                                                  gap.distance};
+                        const SegmentLocation onB{b.sectionId,
+                                                  b.segmentId,
+                                                  gap.t * std::sqrt(dot(axisB, axisB)),
+                                                  gap.distance};
+                        if (a.cellId < b.cellId) {
+                            pairs.push_back({a.cellId, b.cellId, onA, onB});
+                        } else {
+                            pairs.push_back({b.cellId, a.cellId, onB, onA});
+                        }
+                    }
+                }
+            }
+        }
+    };
+
+    if (!nodes.empty()) {
+        std::vector<std::thread> workers;
+        for (size_t t = 1; t < found.size(); ++t) {
+            workers.emplace_back(search, std::ref(found[t]));
+        }
+        search(found[0]);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    std::vector<Apposition> result;
+    for (auto& pairs : found) {
+        result.insert(result.end(), pairs.begin(), pairs.end());
+    }
+    std::sort(result.begin(), result.end(), [](const Apposition& a, const Apposition& b) {
+        return std::tie(a.firstCell,
+                        a.secondCell,
+                        a.first.sectionId,
+                        a.first.segmentId,
+                        a.second.sectionId,
+                        a.second.segmentId) < std::tie(b.firstCell,
+                                                       b.secondCell,
+                                                       b.first.sectionId,
+                                                       b.first.segmentId,
+                                                       b.second.sectionId,
+                                                       b.second.segmentId);
+    });
+    return result;
+}
+
+}  // namespace morphio
@@ -0,0 +1,116 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::max, std::min
+#include <atomic>     // std::atomic
+#include <cmath>      // std::cos, std::sin, std::sqrt
+#include <exception>  // std::exception_ptr, std::rethrow_exception
+#include <stdexcept>  // std::invalid_argument
+#include <string>     // std::to_string
+#include <thread>     // std::thread
+
+#include <morphio/morphology.h>
+#include <morphio/transform.h>
+
+namespace morphio {
+
+AffineTransform translation(const Point& offset) noexcept {
+    auto result = identityTransform();
+    for (size_t row = 0; row < 3; ++row) {
+        result[row][3] = offset[row];
+    }
+    return result;
+}
+
+AffineTransform rotation(const Point& axis, floatType angle) {
+    const floatType norm = std::sqrt(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+    if (norm == 0) {
+        throw std::invalid_argument("The rotation axis can't be the null vector.");
+    }
+
+    // Rodrigues' rotation formula, as a matrix
+    const floatType x = axis[0] / norm;
+    const floatType y = axis[1] / norm;
+    const floatType z = axis[2] / norm;
+    const floatType c = std::cos(angle);
+    const floatType s = std::sin(angle);
+    const floatType t = 1 - c;
+    return {{{t * x * x + c, t * x * y - s * z, t * x * z + s * y, 0},
+             {t * x * y + s * z, t * y * y + c, t * y * z - s * x, 0},
+             {t * x * z - s * y, t * y * z + s * x, t * z * z + c, 0}}};
+}
+
+AffineTransform compose(const AffineTransform& outer, const AffineTransform& inner) noexcept {
+    AffineTransform result{};
+    for (size_t row = 0; row < 3; ++row) {
+        for (size_t column = 0; column < 4; ++column) {
+            for (size_t k = 0; k < 3; ++k) {
+                result[row][column] += outer[row][k] * inner[k][column];
+            }
+        }
+        result[row][3] += outer[row][3];
+    }
+    return result;
+}
+
+void transform(range<Point> points, const AffineTransform& transform) noexcept {
+    for (auto& point : points) {
+        point = transformed(point, transform);
+    }
+}
+
+void transform(range<const Point> points,
+               range<Point> out,
+               const AffineTransform& transform) noexcept {
+    for (size_t i = 0; i < points.size(); ++i) {
+        out[i] = transformed(points[i], transform);
+    }
+}
+
+std::vector<Morphology> transformed(const std::vector<Morphology>& morphologies,
+                                    const std::vector<AffineTransform>& transforms,
+                                    size_t n_threads) {
+    if (transforms.size() != morphologies.size()) {
+        throw std::invalid_argument("Expected one transform per morphology, got " +
+                                    std::to_string(transforms.size()) + " for " +
+                                    std::to_string(morphologies.size()) + " morphologies.");
+    }
+    if (n_threads == 0) {
+        n_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    n_threads = std::max(size_t{1}, std::min(n_threads, morphologies.size()));
+
+    // Every copy is a few large allocations and one pass over the points, the
+    // morphologies are handed out one at a time
+    std::vector<Morphology> result(morphologies);
+    std::atomic<size_t> next{0};
+    std::vector<std::exception_ptr> errors(n_threads);
+    const auto work = [&](size_t thread) {
+        try {
+            for (size_t k = next++; k < morphologies.size(); k = next++) {
+                result[k] = morphologies[k].transformed(transforms[k]);
+            }
+        } catch (...) {
+            errors[thread] = std::current_exception();
+            next = morphologies.size();
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < n_threads; ++t) {
+        workers.emplace_back(work, t);
+    }
+    work(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+    return result;
+}
+
+}  // namespace morphio
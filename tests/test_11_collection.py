@@ -6,6 +6,7 @@ import numpy as np
 import pytest
 
 import morphio
+from utils import captured_output
 
 
 DATA_DIR = Path(__file__).parent / "data"
@@ -69,6 +70,20 @@ def test_container_unordered(collection_path):
         )
 
 
+@pytest.mark.parametrize("collection_path", COLLECTION_PATHS)
+@pytest.mark.parametrize("prefetch", [1, 2, 16])
+def test_container_unordered_prefetch(collection_path, prefetch):
+    with morphio.Collection(collection_path) as collection:
+        morphology_names = available_morphologies()
+
+        expected = list(collection.load_unordered(morphology_names))
+        actual = list(collection.load_unordered(morphology_names, prefetch=prefetch))
+
+        assert [k for k, _ in actual] == [k for k, _ in expected]
+        for (_, morph), (_, expected_morph) in zip(actual, expected):
+            np.testing.assert_array_equal(morph.points, expected_morph.points)
+
+
 @pytest.mark.parametrize("collection_path", COLLECTION_PATHS)
 def test_container_unordered1(collection_path):
     with morphio.Collection(collection_path) as collection:
@@ -81,8 +96,86 @@ def test_container_unordered1(collection_path):
             np.arange(len(morphology_names))
         )
 
+@pytest.mark.parametrize("collection_path", COLLECTION_PATHS)
+@pytest.mark.parametrize("n_threads", [1, 2, 8])
+def test_container_parallel(collection_path, n_threads):
+    with morphio.Collection(collection_path) as collection:
+        morphology_names = available_morphologies()
+
+        loop_indices = []
+        for k, morph in collection.load_parallel(morphology_names, n_threads=n_threads):
+            assert len(morph.sections) == len(collection.load(morphology_names[k]).sections)
+            loop_indices.append(k)
+
+        np.testing.assert_array_equal(
+            sorted(loop_indices),
+            np.arange(len(morphology_names))
+        )
+
+
+@pytest.mark.parametrize("load", [
+    lambda collection, names: collection.load_parallel(names, n_threads=1),
+    lambda collection, names: collection.load_unordered(names, prefetch=2),
+])
+def test_container_ostream_redirect(load):
+    # the loading thread prints warnings while the main thread waits for it
+    morphology_names = ["neurite_wrong_root_point"] * 4
+    with captured_output() as (_, err):
+        with morphio.ostream_redirect(stdout=True, stderr=True):
+            with morphio.Collection(DATA_DIR) as collection:
+                loaded = load(collection, morphology_names)
+                assert len(list(loaded)) == len(morphology_names)
+
+    assert "neurite_wrong_root_point" in err.getvalue()
+
+
 def test_container_with_warning_handler():
     with morphio.Collection(DATA_DIR) as collection:
         warning_handler = morphio.WarningHandlerCollector()
         collection.load('neurite_wrong_root_point', warning_handler=warning_handler)
         assert len(warning_handler.get_all()) == 2
+
+
+def test_container_index(tmp_path):
+    container_path = tmp_path / "merged.h5"
+    container_path.write_bytes((DATA_DIR / "h5/v1/merged.h5").read_bytes())
+
+    with morphio.Collection(container_path) as collection:
+        assert not collection.index_stats().found
+
+    morphio.write_container_index(container_path)
+
+    with morphio.Collection(container_path) as collection:
+        check_load_from_collection(collection)
+
+        stats = collection.index_stats()
+        assert stats.found
+        assert not stats.stale
+        # the container also holds `reversed_NRN_neurite_order`
+        assert stats.size == len(available_morphologies()) + 1
+        assert stats.n_hits == stats.n_lookups > 0
+
+
+@pytest.mark.parametrize("collection_path", COLLECTION_PATHS)
+def test_packed_collection(tmp_path, collection_path):
+    packed_path = tmp_path / "morphologies.pack"
+    if collection_path.is_dir():
+        morphology_dir = tmp_path / "morphologies"
+        morphology_dir.mkdir()
+        for morph_name in available_morphologies():
+            filename = morph_name + ".h5"
+            (morphology_dir / filename).write_bytes((collection_path / filename).read_bytes())
+        morphio.pack_collection(morphology_dir, packed_path)
+    else:
+        morphio.pack_collection(collection_path, packed_path)
+
+    with morphio.Collection(packed_path) as collection:
+        check_load_from_collection(collection)
+
+        with morphio.Collection(collection_path) as reference:
+            for morph_name in available_morphologies():
+                np.testing.assert_array_equal(collection.load(morph_name).points,
+                                              reference.load(morph_name).points)
+
+        for k, morph in collection.load_unordered(available_morphologies()):
+            assert isinstance(morph, morphio.Morphology)
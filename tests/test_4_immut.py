@@ -253,3 +253,55 @@ def test_dendritic_spine_add_root_section():
     assert spine_morph.root_sections[0].type == morphio.SectionType.spine_head
     assert_array_almost_equal(spine_morph.root_sections[0].diameters,
                               [0.1, 0.2, 0.15])
+
+
+def test_morphometrics():
+    from morphio import morphometrics
+
+    for cell in CELLS.values():
+        assert_array_almost_equal(morphometrics.section_path_distances(cell),
+                                  [5, 10, 11, 4, 10, 9])
+        assert_array_almost_equal(morphometrics.segment_lengths(cell),
+                                  [5, 0, 5, 0, 6, 0, 4, 0, 6, 0, 5, 0])
+        assert_equal(len(morphometrics.segment_volumes(cell)), len(cell.points))
+        assert_equal(len(morphometrics.segment_lateral_areas(cell)), len(cell.points))
+        assert_array_almost_equal(morphometrics.radial_distances(cell)[:2], [0, 5])
+        assert_array_equal(morphometrics.bounding_box(cell), [[-5, -4, 0], [6, 5, 0]])
+
+
+def test_point_columns():
+    for name in ('simple.asc', 'simple.swc', 'h5/v1/simple.h5'):
+        for options in (morphio.Option.no_modifier, morphio.Option.point_columns):
+            morph = Morphology(DATA_DIR / name, options=options)
+            x, y, z, diameters = morph.point_columns
+            assert_array_equal(np.stack([x, y, z], axis=1), morph.points)
+            assert_array_equal(diameters, morph.diameters)
+            assert not x.flags.writeable
+
+    # the views keep the morphology alive
+    x = Morphology(DATA_DIR / 'simple.swc', options=morphio.Option.point_columns).point_columns[0]
+    assert x.flags.c_contiguous
+    assert_array_equal(x, CELLS['swc'].points[:, 0])
+
+
+def test_section_aggregates():
+    for cell in CELLS.values():
+        assert_array_almost_equal(cell.section_lengths, [5, 5, 6, 4, 6, 5])
+        assert_equal(len(cell.section_areas), 6)
+        assert_equal(len(cell.section_volumes), 6)
+
+        section = cell.section(0)
+        assert_array_almost_equal(section.length, 5)
+        assert_array_almost_equal(section.area, 10 * np.pi, decimal=5)
+        assert_array_almost_equal(section.volume, 5 * np.pi, decimal=5)
+        assert_array_equal(section.bounding_box, [[0, 0, 0], [0, 5, 0]])
+
+
+def test_transformed():
+    translation = [[1, 0, 0, 1], [0, 1, 0, 2], [0, 0, 1, 3]]
+    for cell in CELLS.values():
+        moved = cell.transformed(translation)
+        assert_array_almost_equal(moved.points, cell.points + [1, 2, 3])
+        assert_array_almost_equal(moved.soma.points, cell.soma.points + [1, 2, 3])
+        assert_array_equal(moved.diameters, cell.diameters)
+        assert_array_almost_equal(moved.section_lengths, cell.section_lengths)
@@ -1053,3 +1053,10 @@ def test_delete_section__traversals():
 
     assert [s.id for s in morph.iter(morphio.IterType.depth_first)] == [2, 5]
     assert [s.id for s in morph.iter(morphio.IterType.breadth_first)] == [2, 5]
+
+
+def test_transform():
+    morph = Morphology(DATA_DIR / "simple.swc")
+    expected = ImmutableMorphology(morph).points + [1, 2, 3]
+    morph.transform(np.array([[1, 0, 0, 1], [0, 1, 0, 2], [0, 0, 1, 3]]))
+    npt.assert_array_almost_equal(ImmutableMorphology(morph).points, expected)
@@ -22,7 +22,7 @@ def test_write_empty_file(tmp_path):
     '''Check that empty morphology are not written to disk'''
     with captured_output():
         with ostream_redirect(stdout=True, stderr=True):
-            for ext in ['asc', 'swc', 'h5']:
+            for ext in ['asc', 'swc', 'h5', 'mbin']:
                 outname = tmp_path / f'empty.{ext}'
                 with pytest.raises(WriterError, match='Morphology is empty.'):
                     Morphology().write(outname)
@@ -82,7 +82,7 @@ def test_write_basic(tmp_path):
                 [0., 5., 0.], [6., 5., 0.], [0., 0., 0.], [0., -4., 0.],
                 [0., -4., 0.], [6., -4., 0.], [0., -4., 0.], [-5., -4., 0.]]
 
-    for ext in ("asc", "swc", "h5"):
+    for ext in ("asc", "swc", "h5", "mbin"):
         morpho.soma.type = (morphio.SomaType.SOMA_CYLINDERS
                             if ext == 'swc' else morphio.SomaType.SOMA_SIMPLE_CONTOUR)
         path = tmp_path / f"test_write.{ext}"
@@ -189,6 +189,12 @@ def test_write_perimeter(tmp_path):
     assert_array_equal(ImmutMorphology(h5_out).perimeters,
                        [5., 6., 6., 7., 6., 8.])
 
+    mbin_out = tmp_path / "test_write.mbin"
+    morpho.write(mbin_out)
+    assert_array_equal(ImmutMorphology(mbin_out).perimeters,
+                       [5., 6., 6., 7., 6., 8.])
+    assert ImmutMorphology(mbin_out).version == ('mbin', 1, 0)
+
     # Cannot right a morph with perimeter data to ASC and SWC
     for ext in ['swc', 'asc']:
         with pytest.raises(WriterError):
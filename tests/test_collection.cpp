@@ -7,9 +7,12 @@
 #include <morphio/collection.h>
 #include <morphio/morphology.h>
 #include <morphio/mut/morphology.h>
+#include <morphio/warning_handling.h>
 
 #include <algorithm>
 #include <filesystem>
+
+#include <highfive/H5File.hpp>
 namespace fs = std::filesystem;
 
 template <class T>
@@ -126,6 +129,229 @@ static void check_collection_load_unordered(const std::string& collection_path)
     }
 }
 
+TEST_CASE("Collection::load_unordered merged matches load", "[collection]") {
+    morphio::Collection collection("data/h5/v1/merged.h5");
+
+    auto morphology_names = std::vector<std::string>{
+        "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+    for (auto [k, morph] : collection.load_unordered<morphio::Morphology>(morphology_names)) {
+        auto expected = collection.load<morphio::Morphology>(morphology_names[k]);
+        REQUIRE(morph.points() == expected.points());
+        REQUIRE(morph.diameters() == expected.diameters());
+        REQUIRE(morph.perimeters() == expected.perimeters());
+        REQUIRE(morph.sectionTypes() == expected.sectionTypes());
+        REQUIRE(morph.soma().points() == expected.soma().points());
+        REQUIRE(morph.somaType() == expected.somaType());
+        REQUIRE(morph.cellFamily() == expected.cellFamily());
+        REQUIRE(morph.version() == expected.version());
+        REQUIRE(morph.mitochondria().rootSections().size() ==
+                expected.mitochondria().rootSections().size());
+    }
+}
+
+TEST_CASE("Collection sidecar index", "[collection]") {
+    const auto directory = fs::temp_directory_path() / "morphio-test-collection-index";
+    fs::create_directories(directory);
+    const auto container_path = (directory / "merged.h5").string();
+    fs::copy_file("data/h5/v1/merged.h5", container_path, fs::copy_options::overwrite_existing);
+    fs::remove(container_path + ".index");
+
+    auto morphology_names = std::vector<std::string>{
+        "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+    SECTION("without index") {
+        auto stats = morphio::Collection(container_path).index_stats();
+        REQUIRE(!stats.found);
+        REQUIRE(stats.n_lookups == 0);
+    }
+
+    SECTION("with index") {
+        REQUIRE(morphio::write_container_index(container_path) >= 0.0);
+
+        auto collection = morphio::Collection(container_path);
+        auto reference = morphio::Collection("data/h5/v1/merged.h5");
+        for (const auto& morph_name : morphology_names) {
+            auto actual = collection.load<morphio::Morphology>(morph_name);
+            auto expected = reference.load<morphio::Morphology>(morph_name);
+            REQUIRE(actual.points() == expected.points());
+            REQUIRE(actual.perimeters() == expected.perimeters());
+            REQUIRE(actual.soma().points() == expected.soma().points());
+        }
+
+        auto loop_indices = collection.argsort(morphology_names);
+        check_loop_indices(loop_indices, morphology_names.size());
+
+        auto stats = collection.index_stats();
+        REQUIRE(stats.found);
+        REQUIRE(!stats.stale);
+        // The container also holds `reversed_NRN_neurite_order`.
+        REQUIRE(stats.size == morphology_names.size() + 1);
+        REQUIRE(stats.n_lookups == 2 * morphology_names.size());
+        REQUIRE(stats.n_hits == stats.n_lookups);
+    }
+
+    SECTION("stale index") {
+        morphio::write_container_index(container_path);
+        fs::last_write_time(container_path,
+                            fs::last_write_time(container_path) + std::chrono::seconds(10));
+
+        auto collection = morphio::Collection(container_path);
+        auto stats = collection.index_stats();
+        REQUIRE(stats.found);
+        REQUIRE(stats.stale);
+
+        auto morph = collection.load<morphio::Morphology>("simple");
+        REQUIRE(morph.sections().size() == 6);
+        REQUIRE(collection.index_stats().n_lookups == 0);
+    }
+
+    SECTION("objects that aren't morphologies") {
+        {
+            HighFive::File file(container_path, HighFive::File::ReadWrite);
+            file.createDataSet<int>("dataset", HighFive::DataSpace(3))
+                .write(std::vector<int>{1, 2, 3});
+            file.createGroup("empty");
+        }
+        REQUIRE(morphio::write_container_index(container_path) >= 0.0);
+
+        auto collection = morphio::Collection(container_path);
+        REQUIRE(collection.index_stats().size == morphology_names.size() + 1);
+        auto morph = collection.load<morphio::Morphology>("simple");
+        REQUIRE(morph.sections().size() == 6);
+        REQUIRE_THROWS(collection.load<morphio::Morphology>("empty"));
+    }
+
+    fs::remove_all(directory);
+}
+
+TEST_CASE("Collection packed container", "[collection]") {
+    const auto directory = fs::temp_directory_path() / "morphio-test-collection-packed";
+    fs::create_directories(directory);
+
+    auto morphology_names = std::vector<std::string>{
+        "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+    const auto check_matches = [&morphology_names](const morphio::Collection& collection,
+                                                   const morphio::Collection& reference) {
+        for (const auto& morph_name : morphology_names) {
+            auto actual = collection.load<morphio::Morphology>(morph_name);
+            auto expected = reference.load<morphio::Morphology>(morph_name);
+            REQUIRE(actual.points() == expected.points());
+            REQUIRE(actual.diameters() == expected.diameters());
+            REQUIRE(actual.perimeters() == expected.perimeters());
+            REQUIRE(actual.sectionTypes() == expected.sectionTypes());
+            REQUIRE(actual.connectivity() == expected.connectivity());
+            REQUIRE(actual.soma().points() == expected.soma().points());
+            REQUIRE(actual.cellFamily() == expected.cellFamily());
+
+            auto actual_mut = collection.load<morphio::mut::Morphology>(morph_name);
+            REQUIRE(actual_mut.sections().size() == expected.sections().size());
+        }
+    };
+
+    SECTION("from an HDF5 container") {
+        const auto packed_path = (directory / "merged.pack").string();
+        morphio::pack_collection("data/h5/v1/merged.h5", packed_path);
+
+        auto collection = morphio::Collection(packed_path);
+        auto reference = morphio::Collection("data/h5/v1/merged.h5");
+        check_matches(collection, reference);
+
+        auto loop_indices = collection.argsort(morphology_names);
+        check_loop_indices(loop_indices, morphology_names.size());
+
+        std::vector<size_t> parallel_indices;
+        for (auto [k, morph] : collection.load_parallel<morphio::Morphology>(morphology_names)) {
+            REQUIRE(morph.points() ==
+                    reference.load<morphio::Morphology>(morphology_names[k]).points());
+            parallel_indices.push_back(k);
+        }
+        check_loop_indices(parallel_indices, morphology_names.size());
+
+        CHECK_THROWS_AS(collection.load<morphio::Morphology>("does-not-exist"),
+                        morphio::MorphioError);
+
+        // Packing a packed container gives the same morphologies.
+        const auto repacked_path = (directory / "repacked.pack").string();
+        morphio::pack_collection(packed_path, repacked_path);
+        check_matches(morphio::Collection(repacked_path), reference);
+    }
+
+    SECTION("from a directory") {
+        const auto morphology_dir = directory / "morphologies";
+        fs::create_directories(morphology_dir);
+        for (const auto& morph_name : morphology_names) {
+            fs::copy_file(fs::path("data/h5/v1") / (morph_name + ".h5"),
+                          morphology_dir / (morph_name + ".h5"),
+                          fs::copy_options::overwrite_existing);
+        }
+
+        const auto packed_path = (directory / "directory.pack").string();
+        morphio::pack_collection(morphology_dir.string(), packed_path);
+        check_matches(morphio::Collection(packed_path), morphio::Collection("data/h5/v1"));
+    }
+
+    SECTION("warnings go to the given handler") {
+        const auto morphology_dir = directory / "no-soma";
+        fs::create_directories(morphology_dir);
+        fs::copy_file("data/h5/v1/Neuron-no-soma.h5",
+                      morphology_dir / "Neuron-no-soma.h5",
+                      fs::copy_options::overwrite_existing);
+
+        const auto packed_path = (directory / "no-soma.pack").string();
+        morphio::pack_collection(morphology_dir.string(), packed_path);
+        auto collection = morphio::Collection(packed_path);
+
+        auto warning_handler = std::make_shared<morphio::WarningHandlerCollector>();
+        collection.load<morphio::Morphology>("Neuron-no-soma",
+                                             morphio::NO_MODIFIER,
+                                             warning_handler);
+        REQUIRE(warning_handler->getAll().size() == 1);
+
+        warning_handler->reset();
+        collection.load<morphio::mut::Morphology>("Neuron-no-soma",
+                                                  morphio::NO_MODIFIER,
+                                                  warning_handler);
+        REQUIRE(warning_handler->getAll().size() == 1);
+    }
+
+    fs::remove_all(directory);
+}
+
+static void check_collection_load_unordered_prefetch(const std::string& collection_path) {
+    morphio::Collection collection(collection_path);
+
+    auto morphology_names = std::vector<std::string>{
+        "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+    for (size_t prefetch : {1, 2, 16}) {
+        DYNAMIC_SECTION("prefetch = " << prefetch) {
+            auto expected = collection.load_unordered<morphio::Morphology>(morphology_names);
+            auto actual = collection.load_unordered<morphio::Morphology>(morphology_names,
+                                                                         morphio::NO_MODIFIER,
+                                                                         nullptr,
+                                                                         prefetch);
+
+            auto expected_it = expected.begin();
+            for (auto it = actual.begin(); it != actual.end(); ++it, ++expected_it) {
+                auto [k, morph] = *it;
+                auto [expected_k, expected_morph] = *expected_it;
+                REQUIRE(k == expected_k);
+                REQUIRE(morph.points().size() == expected_morph.points().size());
+
+                // Dereferencing again must give the same morphology.
+                REQUIRE((*it).second.points().size() == morph.points().size());
+            }
+        }
+    }
+}
+
+TEST_CASE("Collection::load_unordered prefetch", "[collection]") {
+    check_collection_load_unordered_prefetch("data/h5/v1");
+    check_collection_load_unordered_prefetch("data/h5/v1/merged.h5");
+}
+
 TEST_CASE("Collection::load_unordered directory", "[collection]") {
     check_collection_load_unordered("data/h5/v1");
 }
@@ -134,6 +360,60 @@ TEST_CASE("Collection::load_unordered merged", "[collection]") {
     check_collection_load_unordered("data/h5/v1/merged.h5");
 }
 
+template <class M>
+static void check_collection_load_parallel(const std::string& collection_path) {
+    morphio::Collection collection(collection_path);
+
+    auto morphology_names = std::vector<std::string>{
+        "simple", "glia", "mitochondria", "endoplasmic-reticulum", "simple-dendritric-spine"};
+
+    for (size_t n_threads : {1, 2, 8}) {
+        DYNAMIC_SECTION(mutability_label<M>() << ": n_threads = " << n_threads) {
+            std::vector<size_t> loop_indices;
+            for (auto [k, morph] :
+                 collection.load_parallel<M>(morphology_names, morphio::NO_MODIFIER, n_threads)) {
+                auto expected = collection.load<M>(morphology_names[k]);
+                REQUIRE(morph.sections().size() == expected.sections().size());
+                loop_indices.push_back(k);
+            }
+            check_loop_indices(loop_indices, morphology_names.size());
+        }
+    }
+}
+
+TEST_CASE("Collection::load_parallel directory", "[collection]") {
+    check_collection_load_parallel<morphio::Morphology>("data/h5/v1");
+    check_collection_load_parallel<morphio::mut::Morphology>("data/h5/v1");
+}
+
+TEST_CASE("Collection::load_parallel merged", "[collection]") {
+    check_collection_load_parallel<morphio::Morphology>("data/h5/v1/merged.h5");
+    check_collection_load_parallel<morphio::mut::Morphology>("data/h5/v1/merged.h5");
+}
+
+TEST_CASE("Collection::load_parallel errors", "[collection]") {
+    morphio::Collection collection("data/h5/v1");
+    auto morphology_names = std::vector<std::string>{"simple", "does-not-exist", "glia"};
+
+    size_t n_loaded = 0;
+    size_t n_failed = 0;
+    auto loader = collection.load_parallel<morphio::Morphology>(morphology_names,
+                                                                morphio::NO_MODIFIER,
+                                                                2);
+    for (auto it = loader.begin(); it != loader.end(); ++it) {
+        try {
+            auto [k, morph] = *it;
+            REQUIRE(morphology_names[k] != "does-not-exist");
+            ++n_loaded;
+        } catch (const morphio::MorphioError&) {
+            ++n_failed;
+        }
+    }
+
+    REQUIRE(n_loaded == 2);
+    REQUIRE(n_failed == 1);
+}
+
 static void check_collection_argsort(const std::string& collection_path) {
     morphio::Collection collection(collection_path);
 
@@ -0,0 +1,119 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <catch2/catch.hpp>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/flat_morphology.h>
+#include <morphio/mut/morphology.h>
+
+namespace {
+void checkSame(const morphio::Morphology& actual, const morphio::Morphology& expected) {
+    REQUIRE(actual.sectionOffsets() == expected.sectionOffsets());
+    REQUIRE(actual.sectionTypes() == expected.sectionTypes());
+    REQUIRE(actual.points() == expected.points());
+    REQUIRE(actual.diameters() == expected.diameters());
+    REQUIRE(actual.perimeters() == expected.perimeters());
+    REQUIRE(actual.soma().points() == expected.soma().points());
+    for (const auto& section : expected.sections()) {
+        REQUIRE(actual.section(section.id()).isRoot() == section.isRoot());
+        if (!section.isRoot()) {
+            REQUIRE(actual.section(section.id()).parent().id() == section.parent().id());
+        }
+    }
+}
+}  // namespace
+
+TEST_CASE("FlatMorphology::conversion", "[flatMorphology]") {
+    for (const auto& path : {"data/simple.asc", "data/h5/v1/Neuron.h5"}) {
+        const morphio::Morphology morph(path);
+        const morphio::mut::FlatMorphology flat(morph);
+        REQUIRE(flat.size() == morph.sections().size());
+        checkSame(morphio::Morphology(flat.buildReadOnly(), morphio::NO_MODIFIER), morph);
+    }
+}
+
+TEST_CASE("FlatMorphology::modifiers", "[flatMorphology]") {
+    const morphio::Morphology morph("data/h5/v1/Neuron.h5");
+    for (const auto options : {morphio::NO_DUPLICATES | morphio::NRN_ORDER,
+                               morphio::TWO_POINTS_SECTIONS | morphio::SOMA_SPHERE}) {
+        const morphio::mut::FlatMorphology flat(morph, options);
+        checkSame(morphio::Morphology(flat.buildReadOnly(), morphio::NO_MODIFIER),
+                  morphio::Morphology("data/h5/v1/Neuron.h5", options));
+    }
+
+    const morphio::mut::FlatMorphology flat(morph);
+    CHECK_THROWS_AS(morphio::mut::FlatMorphology(flat).applyModifiers(
+                        morphio::NO_DUPLICATES | morphio::TWO_POINTS_SECTIONS),
+                    morphio::SectionBuilderError);
+}
+
+TEST_CASE("FlatMorphology::removeUnifurcations", "[flatMorphology]") {
+    const auto path = "data/nested_single_children.asc";
+    morphio::mut::FlatMorphology flat{morphio::Morphology(path)};
+    flat.removeUnifurcations();
+
+    morphio::mut::Morphology expected(path);
+    expected.removeUnifurcations();
+
+    REQUIRE(flat.size() == 1);
+    REQUIRE(flat.annotations().size() == expected.annotations().size());
+    for (size_t i = 0; i < flat.annotations().size(); ++i) {
+        REQUIRE(flat.annotations()[i]._sectionId == expected.annotations()[i]._sectionId);
+    }
+    checkSame(morphio::Morphology(flat.buildReadOnly(), morphio::NO_MODIFIER),
+              morphio::Morphology(expected));
+}
+
+TEST_CASE("FlatMorphology::edition", "[flatMorphology]") {
+    using morphio::Property::PointLevel;
+    morphio::mut::FlatMorphology flat;
+
+    const auto root = flat.appendRootSection(PointLevel({{0, 0, 0}, {1, 0, 0}}, {2, 2}),
+                                             morphio::SECTION_AXON);
+    const auto left = flat.appendSection(root, PointLevel({{1, 0, 0}, {1, 1, 0}}, {1, 1}));
+    const auto right = flat.appendSection(root, PointLevel({{1, 0, 0}, {1, -1, 0}}, {1, 1}));
+    const auto leaf = flat.appendSection(left, PointLevel({{1, 1, 0}, {1, 2, 0}}, {1, 1}));
+
+    REQUIRE(flat.size() == 4);
+    REQUIRE(flat.type(leaf) == morphio::SECTION_AXON);
+    REQUIRE(flat.parent(leaf) == left);
+    REQUIRE(flat.children(root) == std::vector<morphio::mut::SectionHandle>{left, right});
+    REQUIRE(flat.points(leaf)[1] == morphio::Point{1, 2, 0});
+
+    // The children of a section deleted non recursively take its place
+    flat.deleteSection(left, false);
+    REQUIRE(!flat.contains(left));
+    REQUIRE(flat.children(root) == std::vector<morphio::mut::SectionHandle>{leaf, right});
+    REQUIRE(flat.parent(leaf) == root);
+    CHECK_THROWS_AS(flat.points(left), morphio::SectionBuilderError);
+
+    // The slot is reused, the stale handle doesn't refer to the new section
+    const auto other = flat.appendSection(right, PointLevel({{1, -1, 0}, {2, -1, 0}}, {1, 1}));
+    REQUIRE(other.index == left.index);
+    REQUIRE(other != left);
+    REQUIRE(!flat.contains(left));
+    REQUIRE(flat.id(other) == 4);
+    REQUIRE(flat.children(right) == std::vector<morphio::mut::SectionHandle>{other});
+
+    flat.setPoints(other, PointLevel({{1, -1, 0}, {2, -1, 0}, {3, -1, 0}}, {1, 1, 1}));
+    REQUIRE(flat.points(other).size() == 3);
+
+    flat.deleteSection(right);
+    REQUIRE(flat.size() == 2);
+    REQUIRE(!flat.contains(other));
+
+    const morphio::Morphology morph(flat.buildReadOnly(), morphio::NO_MODIFIER);
+    REQUIRE(morph.sections().size() == 2);
+    REQUIRE(morph.points().size() == 4);
+    REQUIRE(morph.section(1).parent().id() == 0);
+
+    CHECK_THROWS_AS(flat.appendSection(root, PointLevel(), morphio::SECTION_SOMA),
+                    morphio::SectionBuilderError);
+
+    // The children of a root section deleted non recursively become root sections
+    flat.deleteSection(root, false);
+    REQUIRE(flat.rootSections() == std::vector<morphio::mut::SectionHandle>{leaf});
+    REQUIRE(flat.isRoot(leaf));
+}
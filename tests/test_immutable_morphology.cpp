@@ -233,6 +233,159 @@ TEST_CASE("iter", "[immutableMorphology]") {
     }
 }
 
+TEST_CASE("sectionOrder", "[immutableMorphology]") {
+    Files files;
+    for (const auto& morph : files.morphs()) {
+        REQUIRE(morph.sectionOrder() == std::vector<uint32_t>{0, 1, 2, 3, 4, 5});
+        REQUIRE(morph.sectionOrder(morphio::SectionOrder::BREADTH_FIRST) ==
+                std::vector<uint32_t>{0, 3, 1, 2, 4, 5});
+        // the axon comes first
+        REQUIRE(morph.sectionOrder(morphio::SectionOrder::NEURON) ==
+                std::vector<uint32_t>{3, 4, 5, 0, 1, 2});
+    }
+
+    morphio::Morphology iterMorph("data/iterators.asc");
+    for (auto order : {morphio::SectionOrder::DEPTH_FIRST, morphio::SectionOrder::BREADTH_FIRST}) {
+        std::vector<uint32_t> ids;
+        if (order == morphio::SectionOrder::DEPTH_FIRST) {
+            for (auto it = iterMorph.depth_begin(); it != iterMorph.depth_end(); ++it) {
+                ids.push_back(it->id());
+            }
+        } else {
+            for (auto it = iterMorph.breadth_begin(); it != iterMorph.breadth_end(); ++it) {
+                ids.push_back((*it).id());
+            }
+        }
+        REQUIRE(iterMorph.sectionOrder(order) == ids);
+    }
+
+    // Same as the sections of the morphology loaded with the NRN_ORDER modifier
+    const morphio::Morphology reversed("data/reversed_NRN_neurite_order.swc");
+    const morphio::Morphology sorted("data/reversed_NRN_neurite_order.swc",
+                                     morphio::Option::NRN_ORDER);
+    const auto order = reversed.sectionOrder(morphio::SectionOrder::NEURON);
+    REQUIRE(order.size() == sorted.sectionTypes().size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        REQUIRE(reversed.section(order[i]).points() == sorted.section(uint32_t(i)).points());
+    }
+
+    auto it = iterMorph.depth_begin();
+    const auto copy = it;
+    ++it;
+    REQUIRE(copy != it);
+    REQUIRE(copy->id() == 0);
+    REQUIRE(it->id() == 1);
+    REQUIRE_THROWS_AS(++iterMorph.depth_end(), morphio::MorphioError);
+}
+
+TEST_CASE("sectionTopology", "[immutableMorphology]") {
+    Files files;
+    for (const auto& morph : files.morphs()) {
+        const auto depthFirst = morph.depthFirstOrder();
+        const auto breadthFirst = morph.breadthFirstOrder();
+        const auto postOrder = morph.postOrder();
+        const auto depths = morph.sectionDepths();
+        const auto sizes = morph.subtreeSizes();
+        REQUIRE(std::vector<uint32_t>(depthFirst.begin(), depthFirst.end()) ==
+                std::vector<uint32_t>{0, 1, 2, 3, 4, 5});
+        REQUIRE(std::vector<uint32_t>(breadthFirst.begin(), breadthFirst.end()) ==
+                std::vector<uint32_t>{0, 3, 1, 2, 4, 5});
+        REQUIRE(std::vector<uint32_t>(postOrder.begin(), postOrder.end()) ==
+                std::vector<uint32_t>{1, 2, 0, 4, 5, 3});
+        REQUIRE(std::vector<uint32_t>(depths.begin(), depths.end()) ==
+                std::vector<uint32_t>{0, 1, 1, 0, 1, 1});
+        REQUIRE(std::vector<uint32_t>(sizes.begin(), sizes.end()) ==
+                std::vector<uint32_t>{3, 1, 1, 3, 1, 1});
+
+        // computed once, and shared with the copies
+        const auto copy = morph;
+        REQUIRE(copy.postOrder().data() == postOrder.data());
+    }
+
+    const morphio::Morphology morph("data/iterators.asc");
+    const auto postOrder = morph.postOrder();
+    const auto depths = morph.sectionDepths();
+    const auto sizes = morph.subtreeSizes();
+    REQUIRE(postOrder.size() == morph.sectionTypes().size());
+
+    // a single linear scan counts the sections below each one
+    std::vector<uint32_t> counts(sizes.size(), 1);
+    for (uint32_t id : postOrder) {
+        const auto section = morph.section(id);
+        if (!section.isRoot()) {
+            counts[section.parent().id()] += counts[id];
+        }
+        uint32_t depth = 0;
+        for (auto it = section.upstream_begin(); it != section.upstream_end(); ++it) {
+            ++depth;
+        }
+        REQUIRE(depths[id] == depth - 1);
+    }
+    REQUIRE(std::vector<uint32_t>(sizes.begin(), sizes.end()) == counts);
+}
+
+TEST_CASE("sectionAggregates", "[immutableMorphology]") {
+    Files files;
+    for (const auto& morph : files.morphs()) {
+        const std::vector<morphio::floatType> expected{5, 5, 6, 4, 6, 5};
+        const auto lengths = morph.sectionLengths();
+        REQUIRE(lengths.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            REQUIRE_THAT(lengths[i], Catch::WithinAbs(expected[i], 1e-4));
+        }
+
+        const auto section = morph.section(0);
+        REQUIRE_THAT(section.length(), Catch::WithinAbs(5, 1e-4));
+        REQUIRE_THAT(section.area(), Catch::WithinAbs(10 * morphio::PI, 1e-4));
+        REQUIRE_THAT(section.volume(), Catch::WithinAbs(5 * morphio::PI, 1e-4));
+        REQUIRE(section.boundingBox() ==
+                std::array<morphio::Point, 2>{morphio::Point{0, 0, 0}, morphio::Point{0, 5, 0}});
+        REQUIRE(morph.sectionBoundingBoxes()[4] ==
+                std::array<morphio::Point, 2>{morphio::Point{0, -4, 0}, morphio::Point{6, -4, 0}});
+
+        // computed once, and shared with the copies
+        const auto copy = morph;
+        REQUIRE(copy.sectionVolumes().data() == morph.sectionVolumes().data());
+        REQUIRE(morph.sectionAreas()[0] == section.area());
+    }
+}
+
+TEST_CASE("pointColumns", "[immutableMorphology]") {
+    Files files;
+    for (const auto& name : files.fileNames) {
+        const morphio::Morphology morph(name);
+        const auto columns = morph.pointColumns();
+        const auto points = morph.points();
+        REQUIRE(columns._x.size() == points.size());
+        for (size_t i = 0; i < points.size(); ++i) {
+            REQUIRE(morphio::Point{columns._x[i], columns._y[i], columns._z[i]} == points[i]);
+            REQUIRE(columns._diameters[i] == morph.diameters()[i]);
+        }
+
+        // views of the points, not copies
+        REQUIRE(columns._y.data() == points[0].data() + 1);
+        REQUIRE(columns._z.data()[columns._z.stride()] == points[1][2]);
+        REQUIRE(columns._diameters.data() == morph.diameters().data());
+
+        // stored as columns
+        const morphio::Morphology columnMorph(name, morphio::Option::POINT_COLUMNS);
+        const auto contiguous = columnMorph.pointColumns();
+        REQUIRE(contiguous._x.stride() == 1);
+        REQUIRE(contiguous._y.data() == contiguous._x.data() + points.size());
+        REQUIRE(columnMorph.points() == points);
+        REQUIRE(columnMorph.diameters() == morph.diameters());
+        REQUIRE(contiguous._diameters.data() == columnMorph.diameters().data());
+    }
+
+    // not mistaken for a modifier
+    const morphio::Morphology morph("data/h5/v1/simple.h5",
+                                    morphio::Option::POINT_COLUMNS | morphio::Option::NRN_ORDER);
+    REQUIRE(morph.pointColumns()._x.stride() == 1);
+    REQUIRE(morph.rootSections()[0].type() == morphio::SectionType::SECTION_AXON);
+
+    REQUIRE(morphio::Property::PointColumns().empty());
+}
+
 TEST_CASE("section_offsets", "[immutableMorphology]") {
     Files files;
     std::vector<uint32_t> expectedSectionOffsets = {0, 2, 4, 6, 8, 10, 12};
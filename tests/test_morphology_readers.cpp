@@ -2,13 +2,20 @@
  *
  * SPDX-License-Identifier: Apache-2.0
  */
+#include "../src/readers/morphologyBinary.h"
 #include "../src/readers/morphologyHDF5.h"
+#include <array>
 #include <catch2/catch.hpp>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <locale>
 
 #include <highfive/H5File.hpp>
 #include <morphio/dendritic_spine.h>
+#include <morphio/endoplasmic_reticulum.h>
 #include <morphio/enums.h>
+#include <morphio/mitochondria.h>
 #include <morphio/morphology.h>
 #include <morphio/mut/morphology.h>
 #include <morphio/soma.h>
@@ -255,6 +262,42 @@ TEST_CASE("LoadNeurolucidaMorphologyMarkers", "[morphology]") {
     }
 }
 
+TEST_CASE("LoadNeurolucidaNumbers", "[morphology]") {
+    // Numbers, white space and parentheses bypass the generated lexer
+    const std::string contents =
+        "(\"CellBody\"\r\n"
+        " (CellBody)\r\n"
+        " (1 0 0 1)\r\n"
+        " (-1 0 0 1)\r\n"
+        " (0 1 0 1)\r\n"
+        ")\r\n"
+        "\r\n"
+        "((Dendrite)\r\n"
+        " (+1.5 2e1 -3E-1 2)\t; exponents, signs and tabs\r\n"
+        " (1.5e+1 -2.25 0.5 2)\r\n"
+        " (\r\n"
+        "  (1 2 3 4)\r\n"
+        " |\r\n"
+        "  (3 2 1 4)\r\n"
+        " )\r\n"
+        ")\r\n";
+
+    const morphio::Morphology m(contents, "asc");
+    REQUIRE(m.sections().size() == 3);
+    const auto points = m.rootSections()[0].points();
+    REQUIRE(points.size() == 2);
+    const std::array<morphio::Point, 2> expected{{{1.5, 20, -0.3}, {15, -2.25, 0.5}}};
+    for (size_t i = 0; i < expected.size(); ++i) {
+        for (size_t j = 0; j < 3; ++j) {
+            REQUIRE_THAT(points[i][j], Catch::WithinAbs(expected[i][j], 1e-5));
+        }
+    }
+    REQUIRE(m.diameters()[0] == 2);
+
+    CHECK_THROWS_AS(morphio::Morphology("((Dendrite) (.5 0 0 1) (1 0 0 1))", "asc"),
+                    morphio::RawDataError);
+}
+
 TEST_CASE("LoadBadDimensionMorphology", "[morphology]") {
     REQUIRE_THROWS(morphio::Morphology("data/h5/v1/monodim.h5"));
 }
@@ -267,3 +310,80 @@ TEST_CASE("LoadMergedMorphology", "[morphology]") {
     morphio::Morphology m(g);
     REQUIRE(m.rootSections().size() == 8);
 }
+
+TEST_CASE("LoadBinaryMorphology", "[morphology]") {
+    const auto tmpDirectory = std::filesystem::temp_directory_path() / "test_binary_morphology";
+    std::filesystem::create_directories(tmpDirectory);
+
+    for (const std::string name : {"Neuron.h5",
+                                   "glia.h5",
+                                   "mitochondria.h5",
+                                   "endoplasmic-reticulum.h5",
+                                   "simple-dendritric-spine.h5"}) {
+        const morphio::Morphology original("data/h5/v1/" + name);
+        const auto path = (tmpDirectory / (name + ".mbin")).string();
+        morphio::mut::Morphology(original).write(path);
+
+        const morphio::Morphology m(path);
+        CHECK(m.version() == morphio::MorphologyVersion{"mbin", 1, 0});
+        CHECK(m.cellFamily() == original.cellFamily());
+        CHECK(m.soma().type() == original.soma().type());
+        CHECK(m.soma().points() == original.soma().points());
+        CHECK(m.soma().diameters() == original.soma().diameters());
+        CHECK(m.points() == original.points());
+        CHECK(m.diameters() == original.diameters());
+        CHECK(m.perimeters() == original.perimeters());
+        CHECK(m.sectionTypes() == original.sectionTypes());
+        CHECK(m.sectionOffsets() == original.sectionOffsets());
+        CHECK(m.connectivity() == original.connectivity());
+        CHECK(m.mitochondria().rootSections().size() ==
+              original.mitochondria().rootSections().size());
+        CHECK(m.endoplasmicReticulum().volumes() == original.endoplasmicReticulum().volumes());
+
+        // the arrays are borrowed from the mapped file, editing them makes a copy
+        morphio::mut::Morphology editable(m);
+        CHECK(morphio::Morphology(editable).points() == original.points());
+        if (!editable.rootSections().empty()) {
+            editable.rootSections()[0]->points()[0][0] += 1;
+            CHECK(morphio::Morphology(editable).points() != m.points());
+        }
+        CHECK(m.points() == original.points());
+    }
+
+    {
+        const morphio::DendriticSpine d((tmpDirectory / "simple-dendritric-spine.h5.mbin").string());
+        REQUIRE(d.postSynapticDensity().size() == 2);
+    }
+
+    {  // the bytes can also be given as a string
+        std::ifstream file(tmpDirectory / "Neuron.h5.mbin", std::ios::binary);
+        const std::string contents((std::istreambuf_iterator<char>(file)),
+                                   std::istreambuf_iterator<char>());
+        const morphio::Morphology m(contents, "mbin");
+        CHECK(m.points().size() == morphio::Morphology("data/h5/v1/Neuron.h5").points().size());
+
+        CHECK_THROWS_AS(morphio::Morphology(contents.substr(0, 100), "mbin"),
+                        morphio::RawDataError);
+        CHECK_THROWS_AS(morphio::Morphology("NOTMORPH" + contents.substr(8), "mbin"),
+                        morphio::RawDataError);
+    }
+
+    {  // a section whose parent comes after it
+        morphio::Property::Properties properties;
+        properties._pointLevel = morphio::Property::PointLevel({{0, 0, 0}, {1, 0, 0}, {2, 0, 0}},
+                                                               {1, 1, 1});
+        properties._sectionLevel._sections = {{0, -1}, {1, 2}, {2, 0}};
+        properties._sectionLevel._sectionTypes = {morphio::SECTION_AXON,
+                                                  morphio::SECTION_AXON,
+                                                  morphio::SECTION_AXON};
+        const auto bytes = morphio::readers::binary::encode(properties);
+        CHECK_THROWS_AS(morphio::Morphology(std::string(bytes.begin(), bytes.end()), "mbin"),
+                        morphio::RawDataError);
+
+        properties._sectionLevel._sections = {{0, -1}, {1, 0}, {2, 0}};
+        const auto valid = morphio::readers::binary::encode(properties);
+        CHECK(morphio::Morphology(std::string(valid.begin(), valid.end()), "mbin")
+                  .sections()
+                  .size() == 3);
+    }
+}
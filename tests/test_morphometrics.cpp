@@ -0,0 +1,80 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <cmath>      // std::sqrt
+#include <stdexcept>  // std::invalid_argument
+
+#include <catch2/catch.hpp>
+
+#include <morphio/morphology.h>
+#include <morphio/morphometrics.h>
+
+namespace {
+void checkValues(const std::vector<morphio::floatType>& actual,
+                 const std::vector<morphio::floatType>& expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        REQUIRE_THAT(actual[i], Catch::WithinAbs(expected[i], 1e-4));
+    }
+}
+}  // namespace
+
+TEST_CASE("morphio::morphometrics::flat", "[morphometrics]") {
+    using namespace morphio;
+    const std::vector<Point> points{{0, 0, 0}, {3, 4, 0}, {3, 4, 0}, {3, 4, 2}, {3, 4, 5}};
+    const std::vector<floatType> diameters{2, 2, 2, 4, 2};
+    const std::vector<uint32_t> offsets{0, 2, 5};
+
+    checkValues(morphometrics::segmentLengths(points, offsets), {5, 0, 2, 3, 0});
+    checkValues(morphometrics::sectionSums(morphometrics::segmentLengths(points, offsets), offsets),
+                {5, 5});
+    checkValues(morphometrics::segmentVolumes(points, diameters, offsets),
+                {5 * PI, 0, 2 * PI * 7 / 3, 3 * PI * 7 / 3, 0});
+    checkValues(morphometrics::segmentLateralAreas(points, diameters, offsets),
+                {10 * PI, 0, 3 * PI * std::sqrt(5.f), 3 * PI * std::sqrt(10.f), 0});
+    checkValues(morphometrics::radialDistances(points, Point{3, 4, 0}), {5, 0, 0, 2, 5});
+
+    const auto box = morphometrics::boundingBox(points);
+    REQUIRE(box[0] == Point{0, 0, 0});
+    REQUIRE(box[1] == Point{3, 4, 5});
+
+    // empty sections and no points at all
+    const std::vector<uint32_t> emptyFirst{0, 0, 2, 5};
+    checkValues(morphometrics::sectionSums(morphometrics::segmentLengths(points, emptyFirst),
+                                           emptyFirst),
+                {0, 5, 5});
+    const range<const Point> noPoints;
+    REQUIRE(morphometrics::segmentLengths(noPoints, {}).empty());
+    REQUIRE(morphometrics::boundingBox(noPoints) == morphometrics::BoundingBox{});
+
+    // one diameter per point
+    const std::vector<floatType> tooFew{2, 2, 2, 4};
+    REQUIRE_THROWS_AS(morphometrics::segmentVolumes(points, tooFew, offsets),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(morphometrics::segmentLateralAreas(points, tooFew, offsets),
+                      std::invalid_argument);
+}
+
+TEST_CASE("morphio::morphometrics::Morphology", "[morphometrics]") {
+    using namespace morphio;
+    const Morphology morph("data/simple.swc");
+
+    checkValues(morphometrics::segmentLengths(morph), {5, 0, 5, 0, 6, 0, 4, 0, 6, 0, 5, 0});
+    checkValues(morphometrics::sectionPathDistances(morph), {5, 10, 11, 4, 10, 9});
+
+    const auto volumes = morphometrics::sectionSums(morphometrics::segmentVolumes(morph),
+                                                    morph.sectionOffsets());
+    REQUIRE_THAT(volumes[0], Catch::WithinAbs(5 * PI, 1e-4));
+    const auto areas = morphometrics::sectionSums(morphometrics::segmentLateralAreas(morph),
+                                                  morph.sectionOffsets());
+    REQUIRE_THAT(areas[3], Catch::WithinAbs(8 * PI, 1e-4));
+
+    const auto distances = morphometrics::radialDistances(morph);
+    REQUIRE(distances.size() == morph.points().size());
+    REQUIRE_THAT(distances[3], Catch::WithinAbs(std::sqrt(50.f), 1e-4));
+
+    const auto box = morphometrics::boundingBox(morph);
+    REQUIRE(box[0] == Point{-5, -4, 0});
+    REQUIRE(box[1] == Point{6, 5, 0});
+}
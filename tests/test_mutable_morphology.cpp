@@ -185,3 +185,41 @@ TEST_CASE("writing", "[mutableMorphology]") {
 
     fs::remove_all(tmpDirectory);
 }
+
+TEST_CASE("conversionRoundTrip", "[mutableMorphology]") {
+    for (const std::string path : {"data/simple.asc",
+                                   "data/simple-heterogeneous-neurite.swc",
+                                   "data/h5/v1/mitochondria.h5",
+                                   "data/h5/v1/glia.h5"}) {
+        const morphio::Morphology morph(path);
+        morphio::mut::Morphology mutableMorph(morph);
+        REQUIRE(mutableMorph.sections().size() == morph.sections().size());
+
+        // The mutable IDs are the positions in the depth first order of the immutable ones
+        const auto order = morph.depthFirstOrder();
+        std::vector<uint32_t> newIds(order.size());
+        for (uint32_t id = 0; id < order.size(); ++id) {
+            newIds[order[id]] = id;
+        }
+        for (uint32_t id = 0; id < order.size(); ++id) {
+            const auto& section = mutableMorph.section(id);
+            const auto original = morph.section(order[id]);
+            const auto points = original.points();
+            const auto perimeters = original.perimeters();
+            REQUIRE(section->points() == std::vector<morphio::Point>(points.begin(), points.end()));
+            REQUIRE(section->perimeters() ==
+                    std::vector<morphio::floatType>(perimeters.begin(), perimeters.end()));
+            REQUIRE(section->type() == original.type());
+            REQUIRE(section->isRoot() == original.isRoot());
+            if (!original.isRoot()) {
+                REQUIRE(section->parent()->id() == newIds[original.parent().id()]);
+            }
+        }
+
+        const morphio::Morphology rebuilt(mutableMorph);
+        REQUIRE(rebuilt.points().size() == morph.points().size());
+        REQUIRE(rebuilt.perimeters().size() == morph.perimeters().size());
+        REQUIRE(rebuilt.depthFirstOrder().size() == order.size());
+        REQUIRE(morphio::mut::Morphology(rebuilt).connectivity() == mutableMorph.connectivity());
+    }
+}
@@ -6,7 +6,9 @@
 #include <morphio/properties.h>
 
 #include <catch2/catch.hpp>
+#include <memory>
 #include <sstream>
+#include <utility>
 #include <vector>
 
 
@@ -47,6 +49,40 @@ TEST_CASE("morphio::PointLevel") {
 
         CHECK(s0.str() == s1.str());
     }
+
+    SECTION("borrowed arrays") {
+        const auto storage = std::make_shared<std::pair<std::vector<Point::Type>,
+                                                        std::vector<Diameter::Type>>>();
+        storage->first = {{0, 0, 0}, {1, 1, 1}};
+        storage->second = {1, 2};
+
+        PointLevel p;
+        CHECK_THROWS(p.borrow(nullptr, storage->first, storage->second));
+        CHECK_THROWS(p.borrow(storage, storage->first, {}));
+
+        p.borrow(storage, storage->first, storage->second);
+        CHECK(p._points.empty());
+        CHECK(p.points().data() == storage->first.data());
+        CHECK(p.diameters().data() == storage->second.data());
+        CHECK(p.perimeters().empty());
+        CHECK(storage.use_count() == 2);
+
+        const PointLevel copy = p;
+        CHECK(copy.points().data() == storage->first.data());
+        CHECK(storage.use_count() == 3);
+
+        const PointLevel slice(p, {1, 2});
+        CHECK(slice._owner == nullptr);
+        CHECK(slice.diameters().size() == 1);
+        CHECK(slice.diameters()[0] == 2);
+
+        p.own();
+        CHECK(p._owner == nullptr);
+        CHECK(storage.use_count() == 2);
+        CHECK(p._points == storage->first);
+        CHECK(p.points().data() == p._points.data());
+        CHECK(p.diameters().size() == 2);
+    }
 }
 
 TEST_CASE("morphio::SectionLevel") {
@@ -84,6 +120,33 @@ TEST_CASE("morphio::SectionLevel") {
 }
 
 
+TEST_CASE("morphio::ChildrenIndex") {
+    using namespace morphio::Property;
+    const auto sections =
+        std::vector<Section::Type>{{0, -1}, {1, 0}, {2, -1}, {3, 0}, {4, 2}, {5, 0}};
+    const auto index = ChildrenIndex(sections);
+
+    CHECK(std::vector<uint32_t>(index.of(-1).begin(), index.of(-1).end()) ==
+          std::vector<uint32_t>{0, 2});
+    CHECK(std::vector<uint32_t>(index.of(0).begin(), index.of(0).end()) ==
+          std::vector<uint32_t>{1, 3, 5});
+    CHECK(std::vector<uint32_t>(index.of(2).begin(), index.of(2).end()) ==
+          std::vector<uint32_t>{4});
+    CHECK(index.of(1).empty());
+    CHECK(index.of(5).empty());
+    CHECK(index.of(6).empty());
+    CHECK(index.of(-2).empty());
+    CHECK(ChildrenIndex().of(-1).empty());
+
+    const auto children = std::map<int, std::vector<unsigned int>>{{-1, {0, 2}},
+                                                                   {0, {1, 3, 5}},
+                                                                   {2, {4}}};
+    CHECK(index.toMap() == children);
+    CHECK(ChildrenIndex(children) == index);
+    CHECK(ChildrenIndex(children).toMap() == children);
+    CHECK(ChildrenIndex(std::vector<Section::Type>{{0, -1}, {1, 0}}) != index);
+}
+
 TEST_CASE("morphio::CellLevel::compare") {
     using namespace morphio::Property;
 
@@ -0,0 +1,144 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::find_if, std::all_of
+#include <limits>     // std::numeric_limits
+
+#include <catch2/catch.hpp>
+
+#include <morphio/collection.h>
+#include <morphio/morphology.h>
+#include <morphio/spatial_index.h>
+
+TEST_CASE("morphio::SpatialIndex", "[spatialIndex]") {
+    using namespace morphio;
+    // All radii are 1, except for the ends of the neurites
+    const Morphology morph("data/simple.swc");
+    const auto& index = morph.spatialIndex();
+    REQUIRE(index.size() == 6);
+    REQUIRE(&morph.spatialIndex() == &index);
+
+    SECTION("nearest") {
+        const auto nearest = index.nearest(Point{3, 7, 0}, 2);
+        REQUIRE(nearest.size() == 2);
+        REQUIRE(nearest[0].sectionId == 2);
+        REQUIRE(nearest[0].segmentId == 0);
+        REQUIRE_THAT(nearest[0].offset, Catch::WithinAbs(3, 1e-4));
+        REQUIRE_THAT(nearest[0].distance, Catch::WithinAbs(2 - 1.25, 1e-4));
+        REQUIRE(nearest[1].sectionId == 0);
+
+        REQUIRE(index.nearest(Point{3, 7, 0}, 0).empty());
+        REQUIRE(index.nearest(Point{3, 7, 0}, 100).size() == 6);
+    }
+
+    SECTION("within") {
+        const auto found = index.within(Point{0, -10, 0}, 5.5);
+        REQUIRE(found.size() == 3);
+        REQUIRE(found[0].sectionId == 3);
+        REQUIRE_THAT(found[0].distance, Catch::WithinAbs(5, 1e-4));
+        REQUIRE(index.within(Point{0, -10, 0}, 1).empty());
+    }
+
+    SECTION("contains") {
+        REQUIRE(index.contains(Point{0, 2, 0.5}));
+        REQUIRE(index.contains(Point{5.5, 5, 0}));
+        REQUIRE(!index.contains(Point{2, 2, 0}));
+    }
+
+    SECTION("intersecting") {
+        const auto found = index.intersecting({Point{2, 4, -1}, Point{3, 6, 1}});
+        REQUIRE(found.size() == 1);
+        REQUIRE(found[0].sectionId == 2);
+        REQUIRE(index.intersecting({Point{2, 1, -1}, Point{3, 2, 1}}).empty());
+    }
+
+    SECTION("raycast") {
+        const auto hits = index.raycast(Point{3, -10, 0}, Point{0, 2, 0}, 30);
+        REQUIRE(hits.size() == 2);
+        REQUIRE(hits[0].sectionId == 4);
+        REQUIRE_THAT(hits[0].offset, Catch::WithinAbs(3, 1e-4));
+        REQUIRE_THAT(hits[0].distance, Catch::WithinAbs(6, 1e-4));
+        REQUIRE(hits[1].sectionId == 2);
+        REQUIRE_THAT(hits[1].distance, Catch::WithinAbs(15, 1e-4));
+
+        REQUIRE(index.raycast(Point{-10, 2, 0}, Point{1, 0, 0}, 30).size() == 1);
+        REQUIRE(index.raycast(Point{-10, 2, 0}, Point{1, 0, 0}, 5).empty());
+        REQUIRE(index.raycast(Point{-10, 2, 0}, Point{0, 0, 0}, 30).empty());
+
+        const auto unbounded = index.raycast(Point{3, -10, 0},
+                                             Point{0, 2, 0},
+                                             std::numeric_limits<floatType>::infinity());
+        REQUIRE(unbounded.size() == hits.size());
+        for (size_t i = 0; i < hits.size(); ++i) {
+            REQUIRE(unbounded[i].sectionId == hits[i].sectionId);
+            REQUIRE_THAT(unbounded[i].distance, Catch::WithinAbs(hits[i].distance, 1e-4));
+        }
+        REQUIRE(index.raycast(Point{-10, 2, 0},
+                              Point{1, 0, 0},
+                              std::numeric_limits<floatType>::infinity())
+                    .size() == 1);
+    }
+}
+
+TEST_CASE("morphio::CollectionSpatialIndex", "[spatialIndex]") {
+    using namespace morphio;
+    const Collection collection("data", {".swc"});
+    const std::vector<std::string> names{"simple", "simple"};
+
+    // The second cell is 3 above the first one: radii of 1 leave a gap of 1
+    // between copies of the same segment, the tapered ends touch
+    auto above = identityTransform();
+    above[2][3] = 3;
+    const CollectionSpatialIndex index(collection, names, {identityTransform(), above});
+    REQUIRE(index.size() == 12);
+
+    const auto findPair = [](const std::vector<Apposition>& pairs, uint32_t section) {
+        return std::find_if(pairs.begin(), pairs.end(), [section](const Apposition& pair) {
+            return pair.first.sectionId == section && pair.second.sectionId == section;
+        });
+    };
+
+    const auto touching = index.appositions(0, 2);
+    REQUIRE(std::all_of(touching.begin(), touching.end(), [](const Apposition& pair) {
+        return pair.firstCell == 0 && pair.secondCell == 1 && pair.first.distance == 0;
+    }));
+    const auto tapered = findPair(touching, 4);
+    REQUIRE(tapered != touching.end());
+    REQUIRE_THAT(tapered->first.offset, Catch::WithinAbs(6, 1e-4));
+    REQUIRE_THAT(tapered->second.offset, Catch::WithinAbs(6, 1e-4));
+    REQUIRE(findPair(touching, 0) == touching.end());
+
+    const auto close = index.appositions(1, 1);
+    const auto straight = findPair(close, 0);
+    REQUIRE(straight != close.end());
+    REQUIRE_THAT(straight->first.distance, Catch::WithinAbs(1, 1e-4));
+    REQUIRE(close.size() > touching.size());
+
+    auto far = identityTransform();
+    far[0][3] = 1000;
+    REQUIRE(CollectionSpatialIndex(collection, names, {identityTransform(), far})
+                .appositions(1)
+                .empty());
+    REQUIRE(CollectionSpatialIndex(collection, names).appositions(0).size() > 0);
+    CHECK_THROWS_AS(CollectionSpatialIndex(collection, names, {far}), std::invalid_argument);
+}
+
+TEST_CASE("morphio::CollectionSpatialIndex container", "[spatialIndex]") {
+    using namespace morphio;
+    // The container is read in the order of the datasets: glia comes before simple
+    const Collection collection("data/h5/v1/merged.h5");
+    const std::vector<std::string> names{"simple", "glia", "simple"};
+
+    auto far = identityTransform();
+    far[0][3] = 1e6;
+    auto above = identityTransform();
+    above[2][3] = 3;
+    const CollectionSpatialIndex index(collection, names, {identityTransform(), far, above}, 0, 2);
+
+    const auto pairs = index.appositions(5);
+    REQUIRE(!pairs.empty());
+    REQUIRE(std::all_of(pairs.begin(), pairs.end(), [](const Apposition& pair) {
+        return pair.firstCell == 0 && pair.secondCell == 2;
+    }));
+}
@@ -10,6 +10,13 @@
 
 #include <catch2/catch.hpp>
 
+#include <cstdlib>     // std::strtof
+#include <cstring>     // std::memcmp
+#include <filesystem>  // std::filesystem::temp_directory_path
+#include <fstream>     // std::ofstream
+
+#include "../src/readers/utils.h"
+
 using namespace morphio;
 
 
@@ -128,6 +135,22 @@ TEST_CASE("morphio::swc::errors") {
         CHECK_THROWS_AS(Morphology(multiple_soma, "swc"), RawDataError);
     }
 
+    SECTION("repeated_sparse_id") {
+        const auto* contents = R"(
+100000000 1 0 0 1 0.5 -1
+5 3 0 0 2 0.5 100000000
+5 3 0 0 3 0.5 100000000
+        )";
+        CHECK_THROWS_AS(Morphology(contents, "swc"), RawDataError);
+    }
+
+    SECTION("float_id") {
+        const auto* float_id = R"(
+1.5 1 0 0 1 .5 -1
+        )";
+        CHECK_THROWS_AS(Morphology(float_id, "swc"), RawDataError);
+    }
+
     SECTION("large_parent_id") {
         const auto* multiple_soma = R"(
 1 1 0 0 1 .5 01234567890123456789
@@ -177,4 +200,128 @@ TEST_CASE("morphio::swc::working") {
             Morphology(changes, "swc", morphio::Option::ALLOW_UNIFURCATED_SECTION_CHANGE);
         REQUIRE(m.sections().size() == 4);
     }
+
+    SECTION("sparse_ids") {
+        const auto* sparse = R"(
+100000000 1 0 0 1 .5 -1
+7 3 0 0 2 .5 100000000
+3 3 0 1 3 .5 7
+5 3 1 0 3 .5 7
+        )";
+        const auto m = Morphology(sparse, "swc");
+        REQUIRE(m.sections().size() == 3);
+        REQUIRE(m.section(1).parent().id() == 0);
+        REQUIRE(m.section(2).points()[1] == Point{1, 0, 3});
+    }
+
+    SECTION("deeply_nested") {
+        // Each section bifurcates into a leaf and the next section
+        const size_t depth = 100000;
+        std::string contents = "1 1 0 0 0 1 -1\n";
+        for (size_t i = 0, parent = 1; i < depth; ++i) {
+            const auto id = 2 * i + 2;
+            for (size_t child : {id, id + 1}) {
+                contents += std::to_string(child) + " 3 " + std::to_string(i) + " " +
+                            std::to_string(child - id) + " 0 1 " + std::to_string(parent) + "\n";
+            }
+            parent = id;
+        }
+        const auto m = Morphology(contents, "swc");
+        REQUIRE(m.sections().size() == 2 * depth);
+    }
+}
+
+TEST_CASE("morphio::swc::numbers") {
+    SECTION("integers") {
+        const std::string numbers = "42 -7 +3 x 99999999999999999999";
+        REQUIRE(parseInt({numbers.data(), 2}) == std::make_tuple(int64_t{42}, size_t{2}));
+        REQUIRE(parseInt({numbers.data() + 3, 2}) == std::make_tuple(int64_t{-7}, size_t{2}));
+        REQUIRE(parseInt({numbers.data() + 6, 2}) == std::make_tuple(int64_t{3}, size_t{2}));
+        REQUIRE(std::get<1>(parseInt({numbers.data() + 9, 1})) == 0);
+        REQUIRE(std::get<0>(parseInt({numbers.data() + 11, 20})) ==
+                std::numeric_limits<int64_t>::max());
+    }
+
+    SECTION("floats are parsed like strtof") {
+        for (const std::string number : {"0",
+                                         "-0",
+                                         ".5",
+                                         "-12.",
+                                         "+1.25e3",
+                                         "1e",
+                                         "0.1",
+                                         "123.456",
+                                         "3.4028235e38",
+                                         "1.17549435e-38",
+                                         "1e-45",
+                                         "0.333333333333333333333",
+                                         "16777217",
+                                         "nan",
+                                         "-inf"}) {
+            char* end = nullptr;
+            const float expected = std::strtof(number.c_str(), &end);
+            const auto parsed = parseFloat({number.data(), number.size()});
+            const auto actual = static_cast<float>(std::get<0>(parsed));
+            CAPTURE(number);
+            REQUIRE(std::get<1>(parsed) == static_cast<size_t>(end - number.c_str()));
+            if (expected == expected) {
+                REQUIRE(std::memcmp(&actual, &expected, sizeof(float)) == 0);
+            }
+        }
+    }
+
+    SECTION("not a number") {
+        const std::string text = "-.e5";
+        REQUIRE(std::get<1>(parseFloat({text.data(), text.size()})) == 0);
+    }
+}
+
+TEST_CASE("morphio::swc::large") {
+    // Large enough to be split between threads on most machines
+    const size_t n_samples = 400000;
+    std::string contents = "# a chain of samples\n1 1 0 0 0 1 -1\n";
+    for (size_t id = 2; id <= n_samples; ++id) {
+        contents += std::to_string(id) + " 3 " + std::to_string(id) + " 0 0 1 " +
+                    std::to_string(id - 1) + '\n';
+    }
+
+    SECTION("working") {
+        const auto m = Morphology(contents, "swc");
+        REQUIRE(m.sections().size() == 1);
+        REQUIRE(m.points().size() == n_samples - 1);
+        REQUIRE(m.points().back() == Point{n_samples, 0, 0});
+    }
+
+    SECTION("on one thread") {
+        morphio::set_maximum_swc_threads(1);
+        const auto m = Morphology(contents, "swc");
+        morphio::set_maximum_swc_threads(0);
+        REQUIRE(m.points() == Morphology(contents, "swc").points());
+    }
+
+    SECTION("from a file") {
+        // The last line has no line feed
+        const auto last = std::to_string(n_samples + 1);
+        const auto withLast = contents + last + " 3 0 0 0 1 " + std::to_string(n_samples);
+        const auto path = std::filesystem::temp_directory_path() / "test_swc_reader_large.swc";
+        std::ofstream(path, std::ios::binary) << withLast;
+
+        const auto m = Morphology(path.string());
+        const auto expected = Morphology(withLast, "swc");
+        REQUIRE(m.points().size() == n_samples);
+        REQUIRE(m.points() == expected.points());
+        REQUIRE(m.diameters() == expected.diameters());
+        std::filesystem::remove(path);
+    }
+
+    SECTION("line numbers of errors") {
+        const auto last = std::to_string(n_samples + 1);
+        const auto missingParent = contents + last + " 3 0 0 0 1 " + last + "0\n";
+        CHECK_THROWS_WITH(Morphology(missingParent, "swc"),
+                          Catch::Contains("$STRING$:" + std::to_string(n_samples + 2) + ":"));
+
+        const auto nonParsable = contents + "# comment\n" + last + " 3 0 0 zero 1 11\n";
+        CHECK_THROWS_WITH(Morphology(nonParsable, "swc"),
+                          Catch::Contains("$STRING$:" + std::to_string(n_samples + 3) + ":"));
+    }
 }
@@ -0,0 +1,90 @@
+/* Copyright (c) 2013-2023, EPFL/Blue Brain Project
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ */
+#include <algorithm>  // std::equal
+
+#include <catch2/catch.hpp>
+
+#include <morphio/morphology.h>
+#include <morphio/mut/morphology.h>
+#include <morphio/transform.h>
+
+namespace {
+void checkPoints(morphio::range<const morphio::Point> actual,
+                 morphio::range<const morphio::Point> expected) {
+    REQUIRE(actual.size() == expected.size());
+    for (size_t i = 0; i < actual.size(); ++i) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            REQUIRE_THAT(actual[i][axis], Catch::WithinAbs(expected[i][axis], 1e-4));
+        }
+    }
+}
+}  // namespace
+
+TEST_CASE("morphio::transform::builders", "[transform]") {
+    using namespace morphio;
+    const auto quarterTurn = rotation(Point{0, 0, 2}, PI / 2);
+    const std::vector<Point> turned{transformed(Point{1, 0, 0}, quarterTurn)};
+    const std::vector<Point> yAxis{{0, 1, 0}};
+    checkPoints(turned, yAxis);
+
+    // rotate first, then translate
+    const auto placement = compose(translation(Point{1, 2, 3}), quarterTurn);
+    std::vector<Point> points{{1, 0, 0}, {0, 0, 1}};
+    transform(points, placement);
+    const std::vector<Point> placed{{1, 3, 3}, {1, 2, 4}};
+    checkPoints(points, placed);
+
+    REQUIRE(compose(identityTransform(), placement) == placement);
+    CHECK_THROWS_AS(rotation(Point{0, 0, 0}, 1), std::invalid_argument);
+}
+
+TEST_CASE("morphio::transform::Morphology", "[transform]") {
+    using namespace morphio;
+    const Morphology morph("data/simple.asc");
+    const auto placement = compose(translation(Point{10, 0, -5}), rotation(Point{1, 1, 0}, 0.5));
+
+    const auto moved = morph.transformed(placement);
+    std::vector<Point> expected(morph.points().begin(), morph.points().end());
+    transform(expected, placement);
+    checkPoints(moved.points(), expected);
+
+    const auto soma = morph.soma().points();
+    std::vector<Point> expectedSoma(soma.begin(), soma.end());
+    transform(expectedSoma, placement);
+    checkPoints(moved.soma().points(), expectedSoma);
+
+    // the original is untouched, the rigid transform keeps lengths and diameters
+    REQUIRE(morph.points()[0] == Point{0, 0, 0});
+    REQUIRE(moved.diameters().size() == morph.diameters().size());
+    REQUIRE(std::equal(moved.diameters().begin(),
+                       moved.diameters().end(),
+                       morph.diameters().begin()));
+    REQUIRE(moved.sectionOffsets() == morph.sectionOffsets());
+    for (size_t i = 0; i < morph.sectionLengths().size(); ++i) {
+        REQUIRE_THAT(moved.sectionLengths()[i], Catch::WithinAbs(morph.sectionLengths()[i], 1e-4));
+    }
+
+    SECTION("mutable, in place") {
+        mut::Morphology mutableMorph(morph);
+        mutableMorph.transform(placement);
+        const Morphology rebuilt(mutableMorph);
+        checkPoints(rebuilt.points(), expected);
+        checkPoints(rebuilt.soma().points(), expectedSoma);
+    }
+
+    SECTION("batch") {
+        const std::vector<Morphology> morphs(3, morph);
+        const std::vector<AffineTransform> placements{identityTransform(),
+                                                      translation(Point{0, 1, 0}),
+                                                      placement};
+        const auto placed = transformed(morphs, placements, 2);
+        REQUIRE(placed.size() == 3);
+        checkPoints(placed[0].points(), morph.points());
+        REQUIRE(placed[1].points()[0] == Point{0, 1, 0});
+        checkPoints(placed[2].points(), expected);
+
+        CHECK_THROWS_AS(transformed(morphs, {placement}), std::invalid_argument);
+    }
+}